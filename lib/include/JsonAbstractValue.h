@@ -25,35 +25,148 @@
 //    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <map>
+#include <vector>
 #include <iostream>
 
 using namespace std;
 
+class JsonArena;
+
 class JsonAbstractValue
 {
+private:
+    // the number of containers (or callers) that own the value.  Heap
+    // allocated values may be shared between the structures produced
+    // by copy(), and are deleted when their last owner releases them.
+    atomic<unsigned long> owners;
+    // the memoized structural hash of the value (0 if not computed)
+    atomic<uint64_t> digest;
+    // the number of changes made to heap allocated containers and to
+    // values assigned in place
+    static inline atomic<unsigned long> modified{0};
+protected:
+    // compute the structural hash of the value from the hashes of the
+    // values within it, which hash() has already computed
+    virtual uint64_t computeHash() = 0;
+    // add the values held directly within the value to the list
+    virtual void children(vector<JsonAbstractValue*>& list) { (void)list; }
+    // forget the memoized hash when the value is modified
+    void invalidateHash() { digest.store(0, memory_order_relaxed); }
+    // returns true if the value may be changed in place, otherwise
+    // reports the error.  A value that is shared with a copy of the
+    // structure must first be replaced by its own copy using edit() on
+    // the container that holds it.
+    bool modifiable(const char* type) const {
+        if (!isShared()) return true;
+        cerr << type << ": cannot modify a value shared with a copy - reach it with edit()" << endl;
+        return false;
+    }
+    // record a change to (or the deletion of) a heap allocated container,
+    // or the assignment of a value in place
+    static void noteModified() { modified.fetch_add(1, memory_order_relaxed); }
 public:
+    JsonAbstractValue() : owners(1), digest(0) {}
+    JsonAbstractValue(const JsonAbstractValue&) : owners(1), digest(0) {}
+    JsonAbstractValue& operator=(const JsonAbstractValue&) { return *this; }
     virtual ~JsonAbstractValue() = default;
-    // deep copy of the value
+
+    // copy of the value.  Copies of heap allocated containers share
+    // their contents with the original - see JsonObject::edit() and
+    // JsonArray::edit() for modifying a copy.  Copies of arena
+    // allocated values are deep clones allocated from the heap.
     virtual JsonAbstractValue* copy() = 0;
 
+    // deep copy of the value allocated from the specified arena, which
+    // also holds the text of the copy.  If the arena is NULL, this is
+    // the same as copy().
+    virtual JsonAbstractValue* clone(JsonArena* arena) = 0;
+
+    // structural sharing - share() records another owner of the value
+    // and returns it.  release() gives up one ownership of a value,
+    // deleting it when there are no owners left.
+    JsonAbstractValue* share() { owners.fetch_add(1, memory_order_relaxed); return this; }
+    bool isShared() const { return owners.load(memory_order_acquire) > 1; }
+    // the version of the heap allocated structures - the number of
+    // changes made to heap allocated containers (including their
+    // deletion) and to values assigned in place.  A value found before
+    // the version changed may no longer be part of the structure it was
+    // found in.  Changes to arena allocated containers are counted by
+    // their arena instead (see JsonArena::getVersion()).
+    static unsigned long heapVersion() { return modified.load(memory_order_relaxed); }
+    static void release(JsonAbstractValue* val) {
+        if ((val) && (val->owners.fetch_sub(1, memory_order_acq_rel) == 1)) delete val;
+    }
+
+    // structural hash - a 64-bit hash of the content of the value and
+    // everything within it.  Values that compare equal have the same
+    // hash: the order of the fields of an object does not matter, the
+    // order of the elements of an array does, and numbers are hashed by
+    // value rather than by text - an integer and a floating-point number
+    // holding the same whole number (1 and 1.0) hash alike, as do 1.5
+    // and 1.50.  The hash is computed on first use and
+    // remembered.  Containers forget their hash when they are changed,
+    // and edit() clears the hash of the container it is called on, so
+    // changes made by calling edit() down the path to a value are
+    // safe.  Changing a value through a pointer obtained earlier (from
+    // find(), getElement() or a previous edit()) leaves the hashes of
+    // the containers above it out of date.  The values within the
+    // structure are hashed bottom-up using a stack of their own rather
+    // than the call stack, so the depth of the structure is only
+    // limited by available memory.
+    uint64_t hash() {
+        uint64_t result = digest.load(memory_order_relaxed);
+        if (result) return result;
+
+        // each value is visited twice - first to add the values within it
+        // that have not been hashed, then to hash it once they have been
+        vector<pair<JsonAbstractValue*, bool>> stack;
+        vector<JsonAbstractValue*> list;
+        stack.push_back(make_pair(this, false));
+        while (!stack.empty()) {
+            JsonAbstractValue* val = stack.back().first;
+            if (!stack.back().second) {
+                stack.back().second = true;
+                list.clear();
+                val->children(list);
+                for (vector<JsonAbstractValue*>::iterator it = list.begin(); it != list.end(); ++it) {
+                    if (!(*it)->digest.load(memory_order_relaxed)) stack.push_back(make_pair(*it, false));
+                }
+                continue;
+            }
+            stack.pop_back();
+            if (val->digest.load(memory_order_relaxed)) continue;
+            result = val->computeHash();
+            if (!result) result = 1;
+            val->digest.store(result, memory_order_relaxed);
+        }
+        return digest.load(memory_order_relaxed);
+    }
+
     // visualization
     virtual void    dump(ostream& out, bool pretty, int indent, bool useIndent) = 0;
     virtual void    dump(ostream& out, bool pretty) = 0;
 
     // return the value as a string
-    virtual string  getValue(string specifier) = 0;   
+    virtual string  getValue(string_view specifier) = 0;   
+
+    // return a view of the value text held by the node.  The view is
+    // valid for the lifetime of the node and no memory is allocated.
+    virtual string_view getValueView(string_view specifier) = 0;
 
     // return the value as a long signed integer
-    virtual long    getInteger(string specifier) = 0;
+    virtual long    getInteger(string_view specifier) = 0;
 
     // return the value as a double-precision floating-point
-    virtual double  getDouble(string specifier) = 0;
+    virtual double  getDouble(string_view specifier) = 0;
 
     // return the value as a boolean
-    virtual bool    getBoolean(string specifier) = 0;
+    virtual bool    getBoolean(string_view specifier) = 0;
 
     // return the handle value as a string
-    virtual string  getHandle(string specifier) = 0;
+    virtual string  getHandle(string_view specifier) = 0;
 };
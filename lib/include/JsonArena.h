@@ -0,0 +1,130 @@
+//*******************************************************************
+//    JsonArena.h
+//
+//    This file provides definition for a bump-pointer memory arena
+//    that can hold an entire JSON document.  Documents built into an
+//    arena are never deleted node-by-node; instead the arena is reset,
+//    which releases the whole document at once and keeps the memory
+//    for reuse by the next document.  This header is intended to be
+//    used as part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+using namespace std;
+
+class JsonArena :
+    public pmr::memory_resource
+{
+private:
+    // each chunk of arena memory is preceded by this header
+    struct Chunk {
+        Chunk*        next;      // next chunk in the arena
+        unsigned long size;      // usable bytes following the header
+    };
+    Chunk*        head;          // first chunk owned by the arena
+    Chunk*        current;       // chunk that allocations are taken from
+    unsigned long offset;        // bytes used within the current chunk
+    unsigned long chunkSize;     // default size for new chunks
+    unsigned long used;          // bytes handed out since the last reset
+    unsigned long generation;    // the number of times the arena has been reset
+    unsigned long version;       // the number of changes made to the arena's structures
+    JsonArena*    children;      // arenas adopted by this arena
+    JsonArena*    sibling;       // next arena adopted by the same parent
+    unordered_set<string_view> keys;  // object keys interned in the arena
+    // the number of arenas that have been destroyed
+    static inline atomic<unsigned long> destroyed{0};
+
+    // the arena cannot be copied
+    JsonArena(const JsonArena&);
+    JsonArena& operator=(const JsonArena&);
+
+    char* chunkData(Chunk* chunk) { return (char*)(chunk + 1); }
+    bool  fits(Chunk* chunk, unsigned long start, size_t bytes, size_t alignment);
+    void  releaseChildren();
+protected:
+    // memory_resource interface
+    virtual void* do_allocate(size_t bytes, size_t alignment);
+    virtual void  do_deallocate(void* p, size_t bytes, size_t alignment);
+    virtual bool  do_is_equal(const pmr::memory_resource& other) const noexcept;
+public:
+    // construction / destruction
+    JsonArena(unsigned long chunkSize = 65536);
+    ~JsonArena();
+
+    // release every allocation at once.  The memory is retained for
+    // reuse by subsequent allocations.
+    void reset();
+    // release every allocation and return the memory to the system
+    void release();
+
+    // take ownership of another arena (allocated with new) so that the
+    // objects within it live as long as the objects in this arena.  The
+    // adopted arena is deleted when this arena is reset or released.
+    void adopt(JsonArena* child);
+
+    // statistics
+    unsigned long bytesUsed() const;
+    unsigned long bytesReserved() const;
+
+    // the number of times the arena has been reset or released.  Memory
+    // handed out before the generation changed may hold other objects.
+    unsigned long getGeneration() const { return generation; }
+
+    // the version of the structures held by the arena.  The version
+    // changes whenever a container within the arena is changed or the
+    // arena is reset or released.  The version of a destroyed arena
+    // cannot be read, so a version is only meaningful while
+    // destroyedCount() is unchanged.
+    unsigned long getVersion() const { return version; }
+    void noteModified() { version++; }
+    static unsigned long destroyedCount() { return destroyed.load(memory_order_relaxed); }
+
+    // copy text into the arena and return a view of the copy
+    string_view copy(string_view str);
+
+    // return a view of a copy of object key text within the arena.
+    // Each distinct key is copied once, so the objects of a document
+    // share the text of their keys.  The keys are forgotten when the
+    // arena is reset.
+    string_view intern(string_view key);
+
+    // return the memory resource that containers owned by a node should
+    // use - the arena if there is one, otherwise the default heap
+    static pmr::memory_resource* resource(JsonArena* arena) {
+        if (arena) return arena;
+        return pmr::get_default_resource();
+    }
+
+    // construct an object within the arena.  The destructor of the
+    // object is never called - the memory is reclaimed when the arena
+    // is reset.
+    template <class T, class... Args> T* make(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+};
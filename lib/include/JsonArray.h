@@ -26,38 +26,120 @@
 //    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 #pragma once
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
 #include "JsonAbstractValue.h"
 #include "JsonObject.h"
+#include "JsonArena.h"
+#include "JsonDeferred.h"
+
 
 class JsonArray :
 	public JsonAbstractValue
 {
     // internal representation
-    typedef map<unsigned int, JsonAbstractValue*> jsonarray;
-    jsonarray internal_map;   // the map of array values
+    typedef pmr::vector<JsonAbstractValue*> jsonarray;
+    JsonArena* arena;         // arena that owns this array (NULL if heap allocated)
+    jsonarray elements;       // the array values in order
+    JsonDeferred* pending;       // source to read the elements from (NULL once read)
+    unsigned long pendingEntry;  // entry of the array within the source
+
+    // read the elements from the source the first time they are needed
+    void load() { if (pending) expand(); }
+    // forget the hash and advance the version of the structure when the
+    // array is changed
+    void touch() { invalidateHash(); if (arena) arena->noteModified(); else noteModified(); }
+    void expand();
+    virtual uint64_t computeHash();
+    virtual void children(vector<JsonAbstractValue*>& list);
 public:
+    typedef jsonarray::const_iterator iterator;
+
     // construction/destruction
     JsonArray();
+    explicit JsonArray(JsonArena* arena);
     JsonArray(const JsonArray&);
+    JsonArray(JsonArray&&);
+    JsonArray& operator=(JsonArray&&);
     ~JsonArray();
 
-    // array manipulation
+    // array manipulation.  An array that is shared with a copy of the
+    // structure (one reached through getElement() rather than edit())
+    // cannot be changed - the change is refused and reported, and a
+    // value passed to add() is released.
     void            add(JsonAbstractValue* val);
+    void            add(unique_ptr<JsonAbstractValue> val);
+    void            reserve(unsigned long count);
+    // insert a new element before the specified position (or at the end
+    // if the position is size()), or replace the element at the
+    // position.  The array takes ownership of the value only if the
+    // position is valid.
+    bool            insert(unsigned long index, JsonAbstractValue* val);
+    bool            replace(unsigned long index, JsonAbstractValue* val);
+    // remove an element from the array.  take() returns the element,
+    // which is then owned by the caller, remove() releases it.
+    JsonAbstractValue* take(unsigned long index);
+    bool            remove(unsigned long index);
+    // defer reading the elements of the array until they are first used.
+    // The elements are read from the array at the specified entry of
+    // the source (a lazy document or a snapshot).
+    void            defer(JsonDeferred* source, unsigned long entry);
     unsigned long   size();  // return the number of elements in the array
     JsonAbstractValue* getElement(unsigned long index); // return a specific element in the array
+    JsonArena*      getArena() const { return arena; } // the arena that owns the array (NULL if heap allocated)
+
+    // construct a new value and add it to the end of the array.  The
+    // value is allocated in the same way as the array - for an
+    // arena-owned array, the value is built first and then cloned into
+    // the arena, so any text that it owns is held by the arena.
+    // Returns the new value, which is owned by the array.
+    template <class T, class... Args> T* emplace(Args&&... args) {
+        T* val;
+        if (arena) {
+            T value(std::forward<Args>(args)...);
+            val = static_cast<T*>(value.clone(arena));
+        } else {
+            val = new T(std::forward<Args>(args)...);
+        }
+        add(val);
+        return val;
+    }
+
+    // iteration over the elements in order
+    iterator begin() const;
+    iterator end() const;
+
+    // extract numeric fields from an array of objects into columns.
+    // For each of the count keys, columns[k][i] receives the value of
+    // field keys[k] of element i - each column must have room for
+    // size() values.  Elements that are not objects and fields that are
+    // missing give zero.  Returns false (after reporting the first
+    // problem found) if any element or field is not numeric.  Each key
+    // is hashed once, when the JsonKey is made, so each field costs a
+    // hashed lookup and a comparison of its key text.
+    bool getColumns(const JsonKey* keys, double* const* columns, unsigned long count);
+    bool getColumn(const JsonKey& key, double* column);
     
-    // deep copy
+    // copy - the elements are shared with the copy
     virtual JsonAbstractValue* copy();
+    virtual JsonAbstractValue* clone(JsonArena* arena);
+
+    // return an element so that it can be modified.  An element that
+    // is shared with a copy of the structure is first replaced by its
+    // own copy.
+    JsonAbstractValue* edit(unsigned long index);
     
     // visualization
     virtual void    dump(ostream& out, bool pretty, int indent, bool useIndent);
     virtual void    dump(ostream& out, bool pretty);
     
     // get value
-    virtual string  getValue(string specifier);
-    virtual long    getInteger(string specifier);
-    virtual double  getDouble(string specifier);
-    virtual bool    getBoolean(string specifier);
-    virtual string  getHandle(string specifier);
+    virtual string  getValue(string_view specifier);
+    virtual string_view getValueView(string_view specifier);
+    virtual long    getInteger(string_view specifier);
+    virtual double  getDouble(string_view specifier);
+    virtual bool    getBoolean(string_view specifier);
+    virtual string  getHandle(string_view specifier);
 };
-
@@ -0,0 +1,48 @@
+//*******************************************************************
+//    JsonDeferred.h
+//
+//    This file provides definition of a pure virtual base class for
+//    the sources of deferred JSON containers.  An object or array that
+//    is deferred is created empty, and reads its fields or elements from
+//    its source the first time they are used.  Sources are allocated
+//    from the arena that holds the containers they fill.  This header
+//    is intended to be used as part of the PICMG IoT library reference
+//    code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+class JsonObject;
+class JsonArray;
+
+class JsonDeferred
+{
+protected:
+    // sources are never deleted through this interface - they are
+    // released with their arena
+    ~JsonDeferred() = default;
+public:
+    // read the fields or elements of the container that starts at the
+    // specified entry of the source.  Returns false (leaving the
+    // container partly filled) if the source is badly formed there.
+    virtual bool expand(JsonObject* obj, unsigned long entry) = 0;
+    virtual bool expand(JsonArray* ary, unsigned long entry) = 0;
+};
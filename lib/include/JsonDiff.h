@@ -0,0 +1,92 @@
+//*******************************************************************
+//    JsonDiff.h
+//
+//    This file provides definition for a class that compares two JSON
+//    structures and reports the values that were added, removed or
+//    changed.  Each change is identified by a JSON Pointer (RFC 6901)
+//    path, for example:
+//       /configuration/logicalEntities/3/ioBindings/0/name
+//    Subtrees whose content hashes are equal are skipped without being
+//    visited, so the cost of a comparison grows with the size of the
+//    differences rather than the size of the structures (once their
+//    hashes are known).  A comparison can optionally confirm each match
+//    by walking the structures, for callers that cannot accept the
+//    small chance of a hash collision hiding a change.  This header is
+//    intended to be used as part of the PICMG IoT library reference
+//    code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include "JsonAbstractValue.h"
+
+class JsonDiff
+{
+public:
+    // the kinds of change between two structures
+    enum ChangeType {
+        CHANGE_ADDED,      // the value is only in the second structure
+        CHANGE_REMOVED,    // the value is only in the first structure
+        CHANGE_CHANGED     // the value differs between the structures
+    };
+    struct Change {
+        ChangeType         type;    // the kind of change
+        string             path;    // JSON Pointer to the value
+        JsonAbstractValue* before;  // the value in the first structure (NULL if added)
+        JsonAbstractValue* after;   // the value in the second structure (NULL if removed)
+    };
+
+    // compare two structures.  The changes are returned in document
+    // order.  Object fields are matched by key, array elements by
+    // position once the elements that are equal at the start and end
+    // of both arrays have been skipped, so a single element inserted
+    // into or removed from an array is reported as one change.  Paths
+    // of removed values refer to the first structure, all other paths
+    // refer to the second.  Values are treated as equal if their hashes
+    // are equal, unless confirm is true, in which case equal hashes are
+    // confirmed by equals() (at a cost that grows with the size of the
+    // unchanged parts of the structures).  Numbers are compared by value,
+    // so a number that is only written differently (1 changed to 1.0)
+    // is not reported as a change.
+    static vector<Change> compare(JsonAbstractValue* before, JsonAbstractValue* after,
+        bool confirm = false);
+
+    // return true if two structures have the same content.  The order
+    // of the fields of an object does not matter, the order of the
+    // elements of an array does, and numbers are equal if they have the
+    // same value (1 and 1.0).  Structures whose hashes differ are
+    // rejected without being walked.
+    static bool equals(JsonAbstractValue* before, JsonAbstractValue* after);
+private:
+    // a pair of values waiting to be compared
+    struct Node {
+        JsonAbstractValue* before;  // the value in the first structure
+        JsonAbstractValue* after;   // the value in the second structure
+        unsigned long      parent;  // the node of the enclosing pair
+        string             token;   // the reference token within the parent
+    };
+    static const unsigned long NO_PARENT = (unsigned long)-1;
+
+    static string pathOf(const vector<Node>& nodes, unsigned long node);
+    static bool same(JsonAbstractValue* a, JsonAbstractValue* b, bool confirm);
+};
@@ -0,0 +1,97 @@
+//*******************************************************************
+//    JsonDomBuilder.h
+//
+//    This file provides definition for an event handler that builds a
+//    JSON structure (JsonObject, JsonArray and JsonValue nodes) from
+//    the events produced by the JsonFactory parser.  This header is
+//    intended to be used as part of the PICMG IoT library reference
+//    code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <string>
+#include <vector>
+#include "JsonEventHandler.h"
+#include "JsonValue.h"
+#include "JsonObject.h"
+#include "JsonArray.h"
+#include "JsonArena.h"
+#include "JsonKey.h"
+
+class JsonDomBuilder :
+    public JsonEventHandler
+{
+private:
+    // a container that is still being built
+    struct Frame {
+        JsonObject* object;   // the object being built (or NULL)
+        JsonArray*  array;    // the array being built (or NULL)
+        JsonKey     key;      // the key for the next field of the object
+    };
+    JsonArena*         arena;    // arena to build into (NULL for the heap)
+    bool               borrow;   // true if values refer to the source text
+    bool               decode;   // true if string escapes are decoded
+    string             scratch;  // decoded text of the current key
+    JsonAbstractValue* root;     // the outermost value
+    vector<Frame>      stack;    // the containers being built
+
+    // the builder cannot be copied
+    JsonDomBuilder(const JsonDomBuilder&);
+    JsonDomBuilder& operator=(const JsonDomBuilder&);
+
+    // helper functions for building the JSON objects
+    JsonObject* newObject();
+    JsonArray*  newArray();
+    JsonValue*  newValue(string_view text, bool quoted);
+    JsonValue*  newString(string_view text);
+    void        attach(JsonAbstractValue* val);
+public:
+    // construction / destruction
+    JsonDomBuilder(JsonArena* arena, bool borrow, bool decode = false);
+    ~JsonDomBuilder();
+
+    // event handler interface
+    virtual bool startObject();
+    virtual bool key(string_view key);
+    virtual bool endObject();
+    virtual bool startArray();
+    virtual bool endArray();
+    virtual bool scalar(string_view text, bool quoted);
+
+    // add a value that was built separately to the current container.
+    // The value must have been allocated in the same way as the rest of
+    // the structure (from the heap, or from an arena adopted by the
+    // builder's arena).
+    void value(JsonAbstractValue* val);
+    // reserve space for the elements of the current array
+    void reserve(unsigned long count);
+
+    // the way in which values are allocated
+    JsonArena* getArena() const { return arena; }
+    bool       getBorrow() const { return borrow; }
+    bool       getDecode() const { return decode; }
+
+    // return the structure that was built.  The caller takes ownership
+    // of the structure (unless it was built into an arena).
+    JsonAbstractValue* release();
+    // discard any structure that was built
+    void discard();
+};
@@ -0,0 +1,56 @@
+//*******************************************************************
+//    JsonEventHandler.h
+//
+//    This file provides definition for an abstract class that receives
+//    the events produced by the JsonFactory parser as it reads JSON
+//    text.  Events are delivered in document order, so a handler can
+//    process a document of any size without the whole structure being
+//    held in memory.  The text passed to a handler is only valid for
+//    the duration of the call.  This header is intended to be used as
+//    part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <string_view>
+
+using namespace std;
+
+class JsonEventHandler
+{
+public:
+    virtual ~JsonEventHandler() = default;
+
+    // each event returns true to continue parsing, or false to stop
+
+    // the start and end of a json object.  Each field of the object is
+    // reported as a key event followed by the events for its value.
+    virtual bool startObject() = 0;
+    virtual bool key(string_view key) = 0;
+    virtual bool endObject() = 0;
+
+    // the start and end of a json array
+    virtual bool startArray() = 0;
+    virtual bool endArray() = 0;
+
+    // a value primitive.  quoted is true if the text was a quoted json
+    // string, otherwise the text is a literal (number, boolean or null).
+    virtual bool scalar(string_view text, bool quoted) = 0;
+};
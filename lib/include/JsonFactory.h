@@ -25,28 +25,146 @@
 //    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 #pragma once
+#include <istream>
+#include <string_view>
+#include <vector>
 #include "JsonAbstractValue.h"
 #include "JsonValue.h"
 #include "JsonObject.h"
 #include "JsonArray.h"
+#include "JsonArena.h"
+#include "JsonEventHandler.h"
+#include "JsonStructuralIndex.h"
+
+class JsonDomBuilder;
+class JsonLazyDocument;
 
 class JsonFactory
 {
 private:
+    // a range of array elements parsed by one thread
+    struct ParallelJob;
+
     unsigned long strpos;
-    string str;
+    string_view str;
+    istream* input;            // stream being parsed (NULL for a buffer)
+    string window;             // buffered text when parsing a stream
+    unsigned long windowSize;  // number of bytes read from the stream at a time
+    bool aborted;              // true if the handler stopped the parse
+    JsonStructuralIndex index; // structural index of the buffer being parsed
+    bool indexed;              // true if the index is in use
+    unsigned long cursor;      // first index entry at or after strpos
+    unsigned int threads;      // number of threads used to parse large arrays
+    unsigned long parallelSize;// minimum size of an array parsed in parallel
+    JsonDomBuilder* dom;       // the builder in use (NULL when not building)
+    bool decode;               // true if built strings are decoded
+    vector<char> nesting;      // opening bracket of each container being parsed
+    bool delimited;            // true if each document built by next() is a single line
+    bool singleLine;           // true while parsing a document that ends at a raw newline
+
+    // helper functions for reading from a stream
+    bool   fill(unsigned long &start);
+    bool   more() {
+        // returns true if there is text at the current position
+        if (strpos < str.length()) return true;
+        unsigned long start = strpos;
+        return more(start);
+    }
+    bool   more(unsigned long &start);
 
     // helper functions fro string processing
     void   skipWhitespace();
-    string getstring();
-    string getRaw();
+    bool   getstring(string_view &result);
+    string_view getRaw();
+    bool   seek();
 
-    // helper function for building the JSON objects
-    JsonAbstractValue* builder();
+    // helper functions for parsing
+    bool   parser(JsonEventHandler &handler, unsigned int depth);
+    bool   parseKey(JsonEventHandler &handler);
+    bool   parseSlice(string_view slice, JsonEventHandler &handler);
+    bool   parallelArray(bool top);
+    static void parseElements(ParallelJob* job);
+    bool   stop();
+    JsonAbstractValue* start(string_view str, bool borrow, JsonArena* arena);
+    JsonAbstractValue* start(istream &in, JsonArena* arena);
+    JsonAbstractValue* nextDocument(JsonArena* arena);
 public:
     // construction
     JsonFactory();
-    // builder for json objects
-    JsonAbstractValue* build(string str);
-};
 
+    // parallel parsing - when building from a buffer, arrays at the top
+    // of the structure (the outermost value or the fields of the
+    // outermost object) that are larger than minimumSize bytes have
+    // their elements parsed concurrently using the specified number of
+    // threads.  A thread count of 1 (the default) disables this.
+    void setParallel(unsigned int threads, unsigned long minimumSize = 1048576);
+
+    // string decoding - when enabled, the escape sequences of keys and
+    // quoted values are decoded as the structure is built, and text that
+    // is not valid UTF-8 fails the build.  Strings that hold escapes are
+    // copied (into the arena when building into one).  The decoded text
+    // is serialized as it is held, without escapes being restored.  By
+    // default strings are held exactly as they appear in the text.
+    void setDecode(bool decode);
+
+    // newline delimiting - when enabled, each document built by next()
+    // must lie on a single line, as in NDJSON.  A raw newline within a
+    // string or an unfinished document ends it as badly formed, so each
+    // bad line of the input yields exactly one NULL document.  By
+    // default a document may span lines.
+    void setDelimited(bool delimited);
+
+    // builder for json objects - the resulting values own copies of
+    // their text
+    JsonAbstractValue* build(const string &str);
+    // zero-copy builder for json objects - the resulting values refer
+    // directly into the caller's buffer, which must remain valid (and
+    // unmodified) for the lifetime of the returned structure
+    JsonAbstractValue* buildView(string_view str);
+    // arena builders - every node of the resulting structure is
+    // allocated from the arena.  The structure must not be deleted; it
+    // is released when the arena is reset.
+    JsonAbstractValue* build(const string &str, JsonArena &arena);
+    JsonAbstractValue* buildView(string_view str, JsonArena &arena);
+    // lazy builder - only the outermost object or array is created.
+    // The contents of each object and array are read from the buffer
+    // the first time they are used, so parts of the structure that are
+    // never used cost little more than a scan for their brackets.  The
+    // buffer must outlive the structure, and errors within the text are
+    // only reported when the part of the structure that holds them is
+    // used - the part is then left empty, and the error is recorded on
+    // the document returned through the optional parameter (NULL when
+    // the structure was built in full).  The structure is released by
+    // resetting the arena.  When decoding is enabled, the structure is
+    // built in full instead.
+    JsonAbstractValue* buildLazy(string_view str, JsonArena &arena, JsonLazyDocument** document = NULL);
+    // stream builders - the text is read from the stream
+    JsonAbstractValue* build(istream &in);
+    JsonAbstractValue* build(istream &in, JsonArena &arena);
+
+    // event parsers - the structure is reported to the handler as it
+    // is read rather than being built.  When parsing a stream, only a
+    // window of the text is held in memory at a time.
+    bool parse(string_view str, JsonEventHandler &handler);
+    bool parse(istream &in, JsonEventHandler &handler, unsigned long windowSize = 65536);
+
+    // multi-document input - a sequence of concatenated or newline
+    // delimited (NDJSON) documents is opened once and the documents are
+    // then built one at a time by next().  The window, index and parser
+    // state are kept between documents, so each document costs no more
+    // than parsing it.  Each document must be an object, array or quoted
+    // string.  Documents built from a buffer refer directly into it;
+    // documents built from a stream own copies of their text.
+    void open(string_view str);
+    void open(istream &in, unsigned long windowSize = 65536);
+    // return true when there are no more documents to build
+    bool atEnd();
+    // build the next document, or return NULL if the document is badly
+    // formed.  After an error the rest of the line is skipped, so that
+    // later documents of an NDJSON input can still be built (see
+    // setDelimited()).
+    JsonAbstractValue* next();
+    JsonAbstractValue* next(JsonArena &arena);
+    // release the input
+    void close();
+};
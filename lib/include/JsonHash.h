@@ -0,0 +1,68 @@
+//*******************************************************************
+//    JsonHash.h
+//
+//    This file provides definition for the functions used to compute
+//    the structural hashes of JSON values.  The hashes are 64 bits and
+//    depend only on the content of the values, so they are the same
+//    from one run of a program to the next.  They are not intended to
+//    resist deliberate collisions.  This header is intended to be used
+//    as part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+using namespace std;
+
+class JsonHash
+{
+public:
+    // the seeds that distinguish the kinds of value that are hashed
+    enum Seed : uint64_t {
+        SEED_NULL    = 0x6e756c6c00000001ULL,
+        SEED_BOOLEAN = 0x626f6f6c00000002ULL,
+        SEED_INTEGER = 0x696e746700000003ULL,
+        SEED_DOUBLE  = 0x646f756200000004ULL,
+        SEED_STRING  = 0x7374726700000005ULL,
+        SEED_KEY     = 0x6b65790000000006ULL,
+        SEED_ARRAY   = 0x6172726100000007ULL,
+        SEED_OBJECT  = 0x6f626a6500000008ULL
+    };
+
+    // scramble the bits of a value (the splitmix64 finalizer)
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    // combine a hash with a value - the order of the arguments matters
+    static uint64_t combine(uint64_t hash, uint64_t value) {
+        return mix(hash ^ mix(value + 0x9e3779b97f4a7c15ULL));
+    }
+
+    // hash a sequence of bytes
+    static uint64_t bytes(string_view str, uint64_t seed);
+};
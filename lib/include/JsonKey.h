@@ -0,0 +1,58 @@
+//*******************************************************************
+//    JsonKey.h
+//
+//    This file provides definition for a class that represents a
+//    resolved JSON object key.  The key holds its text together with
+//    the hash of the text, so callers that look up the same key many
+//    times can resolve the key once and use the resulting handle for
+//    every lookup without hashing the text again.  The text of the
+//    keys of a document is interned by the arena that holds the
+//    document (see JsonArena::intern()).  This header is intended to
+//    be used as part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+class JsonKey
+{
+private:
+    string        text;    // the key text
+    unsigned long hash;    // hash of the key text
+public:
+    // construction
+    JsonKey();
+    explicit JsonKey(string_view key);
+
+    // access
+    string_view   getText() const { return text; }
+    unsigned long getHash() const { return hash; }
+
+    // keys are equal if they have the same text
+    bool operator==(const JsonKey& key) const { return (hash == key.hash) && (text == key.text); }
+    bool operator!=(const JsonKey& key) const { return !(*this == key); }
+
+    // compute the hash of key text
+    static unsigned long hashKey(string_view key);
+};
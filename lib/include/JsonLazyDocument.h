@@ -0,0 +1,84 @@
+//*******************************************************************
+//    JsonLazyDocument.h
+//
+//    This file provides definition for a class that builds JSON
+//    structures on demand.  A single structural pass over the text
+//    records the position of every structural character and the extent
+//    of every object and array.  Objects and arrays are then created
+//    empty and read their own fields from the text the first time they
+//    are used, so the cost of building a structure is proportional to
+//    the parts of it that are actually accessed.  The document and
+//    everything built from it are allocated from an arena and refer
+//    directly into the text, which must outlive the structure.  A lazy
+//    structure must not be expanded by more than one thread at a time.
+//    A container whose text is badly formed is left empty when it is
+//    expanded, and the error is recorded on the document so that the
+//    caller can reject the structure once it has been used.
+//    This header is intended to be used as part of the PICMG IoT
+//    library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include "JsonAbstractValue.h"
+#include "JsonValue.h"
+#include "JsonObject.h"
+#include "JsonArray.h"
+#include "JsonArena.h"
+#include "JsonDeferred.h"
+
+class JsonLazyDocument :
+    public JsonDeferred
+{
+private:
+    string_view     text;        // the text of the document
+    const uint32_t* positions;   // positions of the structural characters
+    const uint32_t* match;       // entry of the closing bracket for each opening bracket
+    unsigned long   count;       // number of structural characters
+    JsonArena*      arena;       // arena the document is allocated from
+    bool            failed;      // true once a badly formed container was expanded
+
+    // helper functions for building the contents of containers
+    char               at(unsigned long entry) const { return text[positions[entry]]; }
+    JsonAbstractValue* value(unsigned long& entry, unsigned long start);
+    bool               error(unsigned long pos);
+public:
+    // construction - documents are normally allocated by create()
+    JsonLazyDocument(string_view text, const uint32_t* positions, const uint32_t* match,
+        unsigned long count, JsonArena* arena);
+
+    // index the text and allocate a document for it from the arena.
+    // Returns NULL if the brackets within the text are not balanced.
+    static JsonLazyDocument* create(string_view text, JsonArena& arena);
+
+    // return the outermost object or array of the document (or NULL
+    // if the document is not an object or array)
+    JsonAbstractValue* root();
+
+    // return true if any container expanded so far was badly formed
+    bool hasError() const { return failed; }
+
+    // read the fields or elements of the container that opens at the
+    // specified index entry
+    virtual bool expand(JsonObject* obj, unsigned long entry);
+    virtual bool expand(JsonArray* ary, unsigned long entry);
+};
@@ -0,0 +1,56 @@
+//*******************************************************************
+//    JsonMappedFile.h
+//
+//    This file provides definition for a class that maps a JSON file
+//    into memory so that it can be parsed in-place by the JsonFactory
+//    without being copied.  This header is intended to be used as part
+//    of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+class JsonMappedFile
+{
+private:
+    const char*   buffer;    // start of the file contents
+    unsigned long length;    // number of bytes in the file
+    bool          mapped;    // true if buffer is a memory mapping
+
+    // the mapped file cannot be copied
+    JsonMappedFile(const JsonMappedFile&);
+    JsonMappedFile& operator=(const JsonMappedFile&);
+public:
+    // construction / destruction
+    JsonMappedFile();
+    ~JsonMappedFile();
+
+    // open and close the file
+    bool open(string filename);
+    void close();
+
+    // access to the file contents.  The view remains valid until the
+    // file is closed.
+    string_view view() const;
+};
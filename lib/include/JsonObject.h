@@ -26,32 +26,126 @@
 //    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 #pragma once
-#include <map>
-#include <list>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include "JsonAbstractValue.h"
+#include "JsonArena.h"
+#include "JsonDeferred.h"
+#include "JsonKey.h"
+
 
 class JsonObject :
     public JsonAbstractValue
 {
-    // internal representation
-    typedef map<string, JsonAbstractValue*> jsonmap;  
-    typedef list<string> jsonmapindex;                
-    jsonmap internal_map;    // map of values
-    jsonmapindex index;      // list of keys in order of appearance in file
+    // internal representation - the fields are held in order of
+    // appearance.  Small objects are searched linearly, larger objects
+    // also maintain an open-addressing hash index into the entries.
+    // The key text of an arena-owned object is interned by the arena,
+    // so it is shared by every object of the document.  The key text of
+    // a heap allocated object is reference counted, so it is shared
+    // with the copies of the object.
+    struct Entry {
+        string_view        key;     // key text
+        JsonAbstractValue* value;   // the value associated with the key
+        unsigned long      hash;    // hash of the key text
+    };
+    typedef pmr::vector<Entry> jsonentries;
+    typedef pmr::vector<unsigned int> jsonindex;
+    // the count of objects using the text of a heap allocated key,
+    // which is stored immediately before the text
+    typedef atomic<unsigned long> KeyCount;
+    JsonArena* arena;        // arena that owns this object (NULL if heap allocated)
+    jsonentries entries;     // fields in order of appearance in file
+    jsonindex index;         // hash slots holding entry number + 1 (0 if empty)
+    JsonDeferred* pending;       // source to read the fields from (NULL once read)
+    unsigned long pendingEntry;  // entry of the object within the source
+
+    // read the fields from the source the first time they are needed
+    void load() { if (pending) expand(); }
+    // forget the hash and advance the version of the structure when the
+    // object is changed
+    void touch() { invalidateHash(); if (arena) arena->noteModified(); else noteModified(); }
+    void expand();
+    long findEntry(string_view key);
+    long findEntry(string_view key, unsigned long hash);
+    long findEntry(const JsonKey& key) { return findEntry(key.getText(), key.getHash()); }
+    void rebuildIndex();
+    string_view storeKey(string_view key);
+    string_view shareKey(string_view key);
+    void releaseKey(string_view key);
+    void releaseEntries();
+    void put(string_view key, unsigned long hash, JsonAbstractValue* val);
+    JsonAbstractValue* editEntry(long pos);
+    virtual uint64_t computeHash();
+    virtual void children(vector<JsonAbstractValue*>& list);
 public:
     // construction / destruction
     JsonObject();
+    explicit JsonObject(JsonArena* arena);
     JsonObject(const JsonObject& obj);
+    JsonObject(JsonObject&& obj);
+    JsonObject& operator=(JsonObject&& obj);
     ~JsonObject();
 
-    // field manipulation
-    void put(string key, JsonAbstractValue* val);
+    // field manipulation.  An object that is shared with a copy of the
+    // structure (one reached through find() rather than edit()) cannot
+    // be changed - the change is refused and reported, and a value
+    // passed to put() is released.
+    void put(string_view key, JsonAbstractValue* val);
+    void put(const JsonKey& key, JsonAbstractValue* val);
+    void put(string_view key, unique_ptr<JsonAbstractValue> val);
+    void put(const JsonKey& key, unique_ptr<JsonAbstractValue> val);
+
+    // construct a new value and add it to the object.  The value is
+    // allocated in the same way as the object - for an arena-owned
+    // object, the value is built first and then cloned into the arena,
+    // so any text that it owns is held by the arena.  Returns the new
+    // value, which is owned by the object.
+    template <class T, class... Args> T* emplace(string_view key, Args&&... args) {
+        T* val;
+        if (arena) {
+            T value(std::forward<Args>(args)...);
+            val = static_cast<T*>(value.clone(arena));
+        } else {
+            val = new T(std::forward<Args>(args)...);
+        }
+        put(key, val);
+        return val;
+    }
+    void reserve(unsigned long count);
+
+    // remove a field from the object.  take() returns the value of the
+    // field, which is then owned by the caller, remove() releases it.
+    JsonAbstractValue* take(string_view key);
+    bool remove(string_view key);
+
+    // the arena that owns the object (NULL if heap allocated)
+    JsonArena* getArena() const { return arena; }
+    // defer reading the fields of the object until they are first used.
+    // The fields are read from the object at the specified entry of
+    // the source (a lazy document or a snapshot).
+    void defer(JsonDeferred* source, unsigned long entry);
     unsigned long size();
-    JsonAbstractValue* find(string key);
+    JsonAbstractValue* find(string_view key);
+    JsonAbstractValue* find(const JsonKey& key);
     string getElementKey(unsigned long index);
+    string_view getElementKeyView(unsigned long index);
+    JsonAbstractValue* getElement(unsigned long index);
     
     // copy
     virtual JsonAbstractValue* copy();
+    virtual JsonAbstractValue* clone(JsonArena* arena);
+
+    // return the value associated with the key so that it can be
+    // modified.  A value that is shared with a copy of the structure
+    // is first replaced by its own copy, so only the values along the
+    // path being modified are ever duplicated.
+    JsonAbstractValue* edit(string_view key);
+    JsonAbstractValue* edit(const JsonKey& key);
 
     // clear
     void clear();
@@ -61,10 +155,17 @@ public:
     virtual void    dump(ostream& out, bool pretty);
     
     // get values
-    virtual string  getValue(string specifier);
-    virtual long    getInteger(string specifier);
-    virtual double  getDouble(string specifier);
-    virtual bool    getBoolean(string specifier);
-    virtual string  getHandle(string specifier);
-};
+    virtual string  getValue(string_view specifier);
+    virtual string_view getValueView(string_view specifier);
+    virtual long    getInteger(string_view specifier);
+    virtual double  getDouble(string_view specifier);
+    virtual bool    getBoolean(string_view specifier);
+    virtual string  getHandle(string_view specifier);
 
+    // get values using a key that has already been resolved
+    string  getValue(const JsonKey& key);
+    string_view getValueView(const JsonKey& key);
+    long    getInteger(const JsonKey& key);
+    double  getDouble(const JsonKey& key);
+    bool    getBoolean(const JsonKey& key);
+};
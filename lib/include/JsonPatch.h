@@ -0,0 +1,75 @@
+//*******************************************************************
+//    JsonPatch.h
+//
+//    This file provides definition for a class that applies a JSON
+//    Patch (RFC 6902) to a JSON structure.  A patch is an array of
+//    operations, for example:
+//       [ { "op": "replace", "path": "/name", "value": "fan2" },
+//         { "op": "remove", "path": "/logicalEntities/3" } ]
+//    The supported operations are add, remove, replace, move, copy and
+//    test.  The test operation compares values as JsonDiff::equals()
+//    does, so numbers match by value (1 matches 1.0).  The structure is
+//    modified in place - only the containers along the path of each
+//    operation are touched.  This header is intended to be used as part
+//    of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include "JsonAbstractValue.h"
+#include "JsonObject.h"
+#include "JsonArena.h"
+
+class JsonPatch
+{
+private:
+    JsonAbstractValue*  document;   // the root of the structure being patched
+    JsonArena*          arena;      // the arena that owns the structure (NULL for the heap)
+    unsigned long       number;     // the number of the operation being applied
+    bool                decoded;    // true if the strings of the structures are decoded
+
+    JsonPatch(JsonAbstractValue* document, JsonArena* arena, bool decoded);
+
+    bool error(string_view message);
+    bool getText(JsonAbstractValue* val, string& text);
+    bool findKey(JsonObject* obj, const string& token, string& key);
+    JsonAbstractValue* find(const vector<string>& tokens, unsigned long count, bool edit);
+    JsonAbstractValue* clone(JsonAbstractValue* val);
+    bool set(const vector<string>& path, JsonAbstractValue* val, bool add);
+    JsonAbstractValue* take(const vector<string>& path);
+    bool applyOperation(JsonObject* operation);
+public:
+    // apply the operations of a patch to a structure in order.  The
+    // structure must be an object or array, and values from the patch
+    // are copied into it (into its arena if it has one).  An operation
+    // on the root ("") may replace the structure, releasing the
+    // original.  If an operation fails, the error is reported and the
+    // operations before it remain applied.  To keep the original
+    // structure when a patch fails, apply the patch to a copy() of a
+    // heap allocated structure - the copy shares everything that the
+    // patch does not modify.  The pointers of the patch and the keys of
+    // the structure are compared after decoding their escape sequences
+    // - decoded is true if both structures were built with their
+    // strings already decoded (see JsonFactory::setDecode()).
+    static bool apply(JsonAbstractValue*& document, JsonAbstractValue* patch, bool decoded = false);
+};
@@ -0,0 +1,81 @@
+//*******************************************************************
+//    JsonPath.h
+//
+//    This file provides definition for a class that represents a
+//    compiled path query over a JSON structure.  A path is a sequence
+//    of steps separated by '.' or enclosed in brackets, for example:
+//       configuration.logicalEntities[*].ioBindings[?bindingType=='numericSensor']
+//    The supported steps are:
+//       name         - the value of the named field of an object
+//       [n]          - the nth element of an array
+//       [*]          - every element of an array or field of an object
+//       [?key==lit]  - every element whose key field equals the literal
+//       [?key!=lit]  - every element whose key field differs from the literal
+//    A literal may be enclosed in single or double quotes.  Elements
+//    that do not have the key field never satisfy a filter.
+//    The path is parsed once when compiled and may then be executed
+//    against any number of JSON structures.  This header is intended
+//    to be used as part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <string>
+#include <vector>
+#include "JsonAbstractValue.h"
+#include "JsonKey.h"
+
+class JsonPath
+{
+private:
+    // the kinds of step within a compiled path
+    enum StepType {
+        STEP_FIELD,        // select a named field of an object
+        STEP_INDEX,        // select an element of an array by position
+        STEP_WILDCARD,     // select every element or field
+        STEP_MATCH,        // select elements whose field equals a literal
+        STEP_NOMATCH       // select elements whose field differs from a literal
+    };
+    struct Step {
+        StepType      type;     // the kind of step
+        JsonKey       key;      // the field name (field and filter steps)
+        unsigned long index;    // the element position (index steps)
+        string        literal;  // the value to compare (filter steps)
+    };
+    string       text;    // the source text of the path
+    vector<Step> steps;   // the compiled steps
+    bool         valid;   // true if the path compiled successfully
+
+    void apply(const Step& step, JsonAbstractValue* node, vector<JsonAbstractValue*>& out) const;
+    static bool matches(const Step& step, JsonAbstractValue* node);
+public:
+    // construction
+    JsonPath();
+    explicit JsonPath(string path);
+
+    // compile the path text
+    bool compile(string path);
+    bool isValid() const;
+    string getText() const;
+
+    // execute the path
+    vector<JsonAbstractValue*> select(JsonAbstractValue* root) const;
+    JsonAbstractValue* first(JsonAbstractValue* root) const;
+};
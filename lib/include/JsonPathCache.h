@@ -0,0 +1,84 @@
+//*******************************************************************
+//    JsonPathCache.h
+//
+//    This file provides definition for a class that caches compiled
+//    JSON paths and the results of executing them.  A cached result is
+//    only reused while the version of the structure it was found in is
+//    unchanged.  An arena allocated structure is versioned by its arena,
+//    which counts changes to its containers and is advanced when the
+//    arena is reset.  Heap allocated structures share a single version
+//    that counts changes to (and deletion of) heap allocated containers
+//    and the assignment of values in place.  Destroying an arena, or any
+//    change to a heap allocated structure, therefore discards every
+//    cached result.  This header is intended to be used as part of the
+//    PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "JsonArena.h"
+#include "JsonPath.h"
+
+class JsonPathCache
+{
+private:
+    typedef vector<JsonAbstractValue*> jsonnodes;
+    typedef pair<JsonAbstractValue*, const JsonPath*> resultkey;
+    // the cached result of executing a path against a structure
+    struct Result {
+        jsonnodes     nodes;         // the selected nodes
+        JsonArena*    arena;         // the arena that owns the structure (or NULL)
+        unsigned long arenaVersion;  // the version of the arena when selected
+        unsigned long heapVersion;   // the version of the heap structures when selected
+        unsigned long destroyed;     // the number of arenas destroyed when selected
+    };
+    mutex                         lock;      // guards the cache
+    map<string, JsonPath, less<>> plans;     // compiled paths by text
+    map<resultkey, Result>        results;   // results by root and compiled path
+
+    // the cache cannot be copied
+    JsonPathCache(const JsonPathCache&);
+    JsonPathCache& operator=(const JsonPathCache&);
+
+    const JsonPath& plan(string_view path);
+    static bool isCurrent(const Result& result);
+public:
+    // construction / destruction
+    JsonPathCache();
+    ~JsonPathCache();
+
+    // return the compiled form of a path
+    const JsonPath& compile(string_view path);
+
+    // execute a path against a structure and return a copy of the
+    // selected nodes
+    vector<JsonAbstractValue*> select(JsonAbstractValue* root, string_view path);
+    JsonAbstractValue* first(JsonAbstractValue* root, string_view path);
+
+    // discard cached results (and optionally the compiled paths)
+    void clear(bool plansToo = false);
+};
@@ -0,0 +1,51 @@
+//*******************************************************************
+//    JsonPointer.h
+//
+//    This file provides definition for the functions used to build and
+//    split JSON Pointers (RFC 6901), which identify a value within a
+//    JSON structure by the keys and array indexes along its path, for
+//    example:
+//       /configuration/logicalEntities/3/ioBindings/0/name
+//    This header is intended to be used as part of the PICMG IoT
+//    library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+class JsonPointer
+{
+public:
+    // add a reference token to a pointer, escaping '~' and '/'
+    static void appendToken(string& path, string_view token);
+
+    // split a pointer into its unescaped reference tokens.  Returns
+    // false if the pointer is badly formed.
+    static bool parse(string_view pointer, vector<string>& tokens);
+
+    // convert a reference token to an array index.  Returns false if
+    // the token is not a decimal number without leading zeros.
+    static bool parseIndex(string_view token, unsigned long& index);
+};
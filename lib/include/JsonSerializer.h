@@ -0,0 +1,69 @@
+//*******************************************************************
+//    JsonSerializer.h
+//
+//    This file provides definition for a class that writes JSON
+//    structures as compact or pretty-printed text.  The text is built
+//    in a growable buffer and written to a stream in a single
+//    operation.  This header is intended to be used as part of the
+//    PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "JsonAbstractValue.h"
+#include "JsonValue.h"
+#include "JsonObject.h"
+#include "JsonArray.h"
+
+class JsonSerializer
+{
+private:
+    string buffer;      // the text that has been serialized
+    bool   pretty;      // true if fields and elements are on separate lines
+
+    // helper functions for writing the text
+    void   writeIndent(int indent);
+    void   writeValue(JsonValue* val);
+    void   writeObject(JsonObject* obj, int indent);
+    void   writeArray(JsonArray* ary, int indent);
+public:
+    // construction
+    explicit JsonSerializer(bool pretty = false);
+
+    // serialize a structure, appending the text to the buffer.  indent
+    // is the indentation level of the structure, and useIndent is false
+    // if the first line should not be indented.
+    void write(JsonAbstractValue* val, int indent = 0, bool useIndent = true);
+
+    // access to the serialized text
+    string_view view() const { return buffer; }
+    unsigned long size() const { return buffer.size(); }
+    void reserve(unsigned long bytes);
+    void clear();
+
+    // write the serialized text to the stream and clear the buffer
+    void flush(ostream& out);
+
+    // serialize a structure to a string
+    static string toString(JsonAbstractValue* val, bool pretty = false);
+};
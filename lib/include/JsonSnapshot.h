@@ -0,0 +1,94 @@
+//*******************************************************************
+//    JsonSnapshot.h
+//
+//    This file provides definition for a class that saves a JSON
+//    structure as a binary snapshot and restores it without parsing.
+//    A snapshot is a position-independent image made up of a header,
+//    a tape of fixed-size records (one per key or value, in document
+//    order) and a pool holding the text of the keys and values.
+//    Values restored from a snapshot refer directly into the image, so
+//    a snapshot file that is mapped into memory (JsonMappedFile) can be
+//    reloaded with no parsing and no copying of text.  The image is
+//    checked when it is loaded, but the objects and arrays within it are
+//    only built from the tape when they are first used.  This header is
+//    intended to be used as part of the PICMG IoT library reference
+//    code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "JsonAbstractValue.h"
+#include "JsonValue.h"
+#include "JsonObject.h"
+#include "JsonArray.h"
+#include "JsonArena.h"
+#include "JsonDeferred.h"
+
+class JsonSnapshot
+{
+private:
+    // a key or value within the snapshot tape
+    struct Record {
+        uint8_t  tag;       // the kind of record (object, array, key or value)
+        uint8_t  type;      // the JsonValueType of a value
+        uint8_t  boolean;   // boolean interpretation of a value
+        uint8_t  reserved;
+        uint32_t length;    // text length, or number of children of a container
+        uint64_t offset;    // text offset in the pool, or the record after a container
+        int64_t  integer;   // integer interpretation of a value
+        double   real;      // floating-point interpretation of a value
+    };
+
+    // state used while saving
+    vector<Record> records;                         // the tape being written
+    string pool;                                    // the text being written
+    unordered_map<string_view, uint64_t> strings;   // text already in the pool
+
+    // the tape of a loaded image, which builds the containers of the
+    // restored structure as they are used
+    class Tape;
+
+    // helper functions for saving
+    uint64_t addText(string_view str);
+    bool     addValue(JsonAbstractValue* val);
+public:
+    // construction
+    JsonSnapshot();
+
+    // encode a structure as a snapshot image
+    bool encode(JsonAbstractValue* root, string& result);
+    // save a structure to a snapshot file
+    bool save(JsonAbstractValue* root, string filename);
+
+    // true if the buffer holds a snapshot image
+    static bool isSnapshot(string_view image);
+
+    // restore the structure held in a snapshot image.  Every node is
+    // allocated from the arena and the values refer into the image,
+    // which must outlive the structure.  The image is checked in full,
+    // but the contents of each object and array are only restored when
+    // they are first used.
+    JsonAbstractValue* load(string_view image, JsonArena& arena);
+};
@@ -0,0 +1,65 @@
+//*******************************************************************
+//    JsonStructuralIndex.h
+//
+//    This file provides definition for a class that builds an index of
+//    the structural characters within JSON text.  The text is scanned
+//    in 64-byte blocks using SIMD instructions where the processor
+//    supports them (AVX2 or SSE2, with a portable fallback).  The index
+//    holds, in order, the position of every unescaped double quote and
+//    of every structural character ({ } [ ] : ,) that lies outside a
+//    string.  A quote is treated as escaped when it follows a run of
+//    backslashes of odd length, matching the JsonFactory tokenizer.
+//    This header is intended to be used as part of the PICMG IoT library
+//    reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+class JsonStructuralIndex
+{
+private:
+    vector<uint32_t> positions;   // positions of the indexed characters
+    unsigned long    count;       // number of valid positions
+public:
+    // construction
+    JsonStructuralIndex();
+
+    // build the index for the specified text.  Returns false (leaving
+    // the index empty) if the text is too large to be indexed.
+    bool build(string_view str);
+    void clear();
+
+    // access to the index
+    unsigned long size() const { return count; }
+    uint32_t operator[](unsigned long i) const { return positions[i]; }
+
+    // return the position of the first character at or after pos that
+    // is not whitespace (or the length of the text if there is none)
+    static unsigned long skipWhitespace(string_view str, unsigned long pos);
+
+    // the name of the instruction set used to build the index
+    static const char* implementation();
+};
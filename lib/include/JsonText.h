@@ -0,0 +1,67 @@
+//*******************************************************************
+//    JsonText.h
+//
+//    This file provides definition for a set of functions that process
+//    the text of JSON strings: UTF-8 validation, decoding of escape
+//    sequences, and transcoding from UTF-8 to UTF-16BE.  Runs of plain
+//    ASCII text are processed sixteen bytes at a time using SSE2
+//    instructions on x86 processors (with a portable fallback).  This
+//    header is intended to be used as part of the PICMG IoT library
+//    reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <string>
+#include <string_view>
+#include "JsonArena.h"
+
+using namespace std;
+
+class JsonText
+{
+public:
+    // return true if the text is well formed UTF-8
+    static bool isValidUtf8(string_view str);
+
+    // return true if the text holds escape sequences
+    static bool hasEscapes(string_view str);
+
+    // decode the escape sequences of the text of a JSON string (without
+    // its quotes) and validate the result as UTF-8.  The decoded text is
+    // never longer than the original, so out must have room for
+    // str.length() characters.  Returns the length of the decoded text,
+    // or -1 if an escape sequence or the UTF-8 encoding is invalid.
+    static long decode(string_view str, char* out);
+    // decode into a string, returning false if the text is invalid
+    static bool decode(string_view str, string& out);
+    // decode into the arena.  Text without escape sequences is returned
+    // unchanged (or copied into the arena if copy is true).  Returns an
+    // empty view and sets ok to false if the text is invalid.
+    static string_view decode(string_view str, JsonArena& arena, bool copy, bool& ok);
+
+    // append text to out as the contents of a JSON string (without its
+    // quotes), escaping quotes, backslashes and control characters
+    static void encode(string_view str, string& out);
+
+    // append the UTF-16BE encoding of UTF-8 text to out.  Invalid
+    // sequences are replaced by U+FFFD and false is returned.
+    static bool utf8ToUtf16be(string_view str, string& out);
+};
@@ -3,8 +3,9 @@
 //
 //    This file provides definitions for a class representation of
 //    a concrete JSON value as opposed to an object or array.  This 
-//    class represents the all JSON value types as a string.  
-//    Getter functions interpret the string as specific data types.
+//    class holds the text of the value along with its type and its
+//    numeric and boolean interpretations, which are determined once
+//    when the value is constructed.
 //    This header is intended to be used as part of the PICMG IoT 
 //    library reference code. 
 //    
@@ -28,30 +29,64 @@
 //    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 #pragma once
+#include <string_view>
 #include "JsonAbstractValue.h"
+
+// the types of concrete json values
+enum JsonValueType {
+    JSON_NULL,
+    JSON_BOOLEAN,
+    JSON_INTEGER,
+    JSON_DOUBLE,
+    JSON_STRING
+};
+
 class JsonValue :
 	public JsonAbstractValue
 {
 private:
-    string value;
+    string      storage;   // owned copy of the value text
+    string_view value;     // the value text - either storage or a borrowed buffer
+    JsonValueType type;    // the type of the value
+    bool        boolean;   // boolean interpretation of the value
+    long        integer;   // integer interpretation of the value
+    double      real;      // floating-point interpretation of the value
+
+    void classify(bool quoted);
+    virtual uint64_t computeHash();
 public:
     // construction
     JsonValue();
     JsonValue(const JsonValue& val);
+    JsonValue(JsonValue&& val);
     JsonValue(string value);
+    JsonValue(string_view value, bool borrow, bool quoted = false);
+    JsonValue(string_view value, JsonValueType type, bool boolean, long integer, double real);
+    JsonValue& operator=(const JsonValue& val);
+    JsonValue& operator=(JsonValue&& val);
+
+    // the type of the value
+    JsonValueType getType();
+    // the text of the value exactly as it was stored
+    string_view   getText();
+    // return true if the values are the same - numbers are compared by
+    // value and other values by their text (see computeHash())
+    bool          equals(JsonValue& val);
 
     // deep copy
     virtual JsonAbstractValue* copy();
+    virtual JsonAbstractValue* clone(JsonArena* arena);
     
     // visualization
     virtual void    dump(ostream& out, bool pretty, int indent,bool useIndent);
     virtual void    dump(ostream& out, bool pretty);
     
     // get value in different representations
-    virtual string  getValue(string specifier);
-    virtual long    getInteger(string specifier);
-    virtual double  getDouble(string specifier);
-    virtual bool    getBoolean(string specifier);
-    virtual string  getHandle(string specifier);
+    virtual string  getValue(string_view specifier);
+    virtual string_view getValueView(string_view specifier);
+    virtual long    getInteger(string_view specifier);
+    virtual double  getDouble(string_view specifier);
+    virtual bool    getBoolean(string_view specifier);
+    virtual string  getHandle(string_view specifier);
 };
 
@@ -0,0 +1,285 @@
+//*******************************************************************
+//    JsonArena.cpp
+//
+//    This file provides implementation for a bump-pointer memory arena
+//    that can hold an entire JSON document.  This file is intended to
+//    be used as part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <cstdint>
+#include <cstring>
+#include "JsonArena.h"
+
+//*******************************************************************
+// alignUp()
+//
+// This is a static helper that rounds an offset up to the next
+// multiple of the specified alignment.
+//
+// parameters:
+//   offset - the offset to align
+//   alignment - the required alignment (a power of two)
+// returns:
+//   the aligned offset
+static unsigned long alignUp(unsigned long offset, size_t alignment) {
+    return (offset + alignment - 1) & ~((unsigned long)alignment - 1);
+}
+
+//*******************************************************************
+// JsonArena()
+//
+// constructor.
+//
+// parameters:
+//    chunkSize - the size of each block of memory requested from the
+//       system when the arena needs to grow.
+JsonArena::JsonArena(unsigned long chunkSize) :
+    head(NULL), current(NULL), offset(0), chunkSize(chunkSize), used(0), generation(0), version(0),
+    children(NULL), sibling(NULL) {
+}
+
+//*******************************************************************
+// ~JsonArena()
+//
+// destructor - return all memory to the system.
+JsonArena::~JsonArena() {
+    release();
+    destroyed.fetch_add(1, memory_order_relaxed);
+}
+
+//*******************************************************************
+// fits()
+//
+// returns true if an allocation of the specified size and alignment
+// fits within the specified chunk starting at the specified offset.
+bool JsonArena::fits(Chunk* chunk, unsigned long start, size_t bytes, size_t alignment) {
+    uintptr_t base = (uintptr_t)chunkData(chunk);
+    unsigned long aligned = alignUp(base + start, alignment) - base;
+    return aligned + bytes <= chunk->size;
+}
+
+//*******************************************************************
+// do_allocate()
+//
+// allocate memory from the arena.  Memory is taken from the current
+// chunk if it fits, otherwise from the next retained chunk, otherwise
+// from a newly allocated chunk.
+//
+// parameters:
+//    bytes - the number of bytes to allocate
+//    alignment - the required alignment of the allocation
+// returns:
+//    a pointer to the allocated memory
+void* JsonArena::do_allocate(size_t bytes, size_t alignment) {
+    if (alignment == 0) alignment = 1;
+    while ((current) && (!fits(current, offset, bytes, alignment))) {
+        // move on to the next retained chunk (if any)
+        if (!current->next) break;
+        current = current->next;
+        offset = 0;
+    }
+    if ((!current) || (!fits(current, offset, bytes, alignment))) {
+        // allocate a new chunk that is large enough for the request
+        unsigned long size = chunkSize;
+        if (bytes + alignment > size) size = bytes + alignment;
+        Chunk* chunk = (Chunk*)::operator new(sizeof(Chunk) + size);
+        chunk->size = size;
+        chunk->next = NULL;
+        if (current) {
+            // insert the new chunk after the current one so that any
+            // retained chunks remain available
+            chunk->next = current->next;
+            current->next = chunk;
+        } else {
+            chunk->next = head;
+            head = chunk;
+        }
+        current = chunk;
+        offset = 0;
+    }
+    uintptr_t base = (uintptr_t)chunkData(current);
+    unsigned long start = alignUp(base + offset, alignment) - base;
+    offset = start + bytes;
+    used += bytes;
+    return chunkData(current) + start;
+}
+
+//*******************************************************************
+// do_deallocate()
+//
+// individual deallocations are ignored - the memory is reclaimed when
+// the arena is reset.
+void JsonArena::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    (void)p; (void)bytes; (void)alignment;
+}
+
+//*******************************************************************
+// do_is_equal()
+//
+// memory allocated from one arena can only be deallocated by the
+// same arena.
+bool JsonArena::do_is_equal(const pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+//*******************************************************************
+// reset()
+//
+// release every allocation at once.  The chunks are retained so that
+// the next document built into the arena does not need to request
+// memory from the system.
+//
+// parameters:
+//    none
+// returns:
+//    void
+void JsonArena::reset() {
+    releaseChildren();
+    keys.clear();
+    generation++;
+    version++;
+    current = head;
+    offset = 0;
+    used = 0;
+}
+
+//*******************************************************************
+// release()
+//
+// release every allocation and return all chunks to the system.
+//
+// parameters:
+//    none
+// returns:
+//    void
+void JsonArena::release() {
+    releaseChildren();
+    keys.clear();
+    generation++;
+    version++;
+    while (head) {
+        Chunk* next = head->next;
+        ::operator delete(head);
+        head = next;
+    }
+    current = NULL;
+    offset = 0;
+    used = 0;
+}
+
+//*******************************************************************
+// adopt()
+//
+// take ownership of another arena.  This allows objects to be built
+// concurrently in separate arenas and then kept alive together with
+// the objects in this arena.
+//
+// parameters:
+//    child - the arena to adopt.  It must have been allocated with new
+//       and must not be used to allocate any more memory.
+// returns:
+//    void
+void JsonArena::adopt(JsonArena* child) {
+    if ((!child) || (child == this)) return;
+    child->sibling = children;
+    children = child;
+}
+
+//*******************************************************************
+// releaseChildren()
+//
+// delete every adopted arena, returning their memory to the system.
+//
+// parameters:
+//    none
+// returns:
+//    void
+void JsonArena::releaseChildren() {
+    while (children) {
+        JsonArena* next = children->sibling;
+        delete children;
+        children = next;
+    }
+}
+
+//*******************************************************************
+// bytesUsed()
+//
+// return the number of bytes allocated since the last reset.
+//
+// parameters:
+//    none
+// returns:
+//    the number of bytes allocated from this arena and adopted arenas
+unsigned long JsonArena::bytesUsed() const {
+    unsigned long total = used;
+    for (JsonArena* child = children; child; child = child->sibling) total += child->bytesUsed();
+    return total;
+}
+
+//*******************************************************************
+// bytesReserved()
+//
+// return the total number of bytes held by the arena.
+//
+// parameters:
+//    none
+// returns:
+//    the total size of all chunks owned by the arena
+unsigned long JsonArena::bytesReserved() const {
+    unsigned long total = 0;
+    for (Chunk* chunk = head; chunk; chunk = chunk->next) total += chunk->size;
+    for (JsonArena* child = children; child; child = child->sibling) total += child->bytesReserved();
+    return total;
+}
+
+//*******************************************************************
+// copy()
+//
+// copy the specified text into the arena.
+//
+// parameters:
+//    str - the text to copy
+// returns:
+//    a view of the copy within the arena
+string_view JsonArena::copy(string_view str) {
+    if (str.empty()) return string_view();
+    char* data = (char*)allocate(str.length(), 1);
+    memcpy(data, str.data(), str.length());
+    return string_view(data, str.length());
+}
+
+//*******************************************************************
+// intern()
+//
+// return a view of a copy of object key text within the arena.  Key
+// text that has been interned since the arena was last reset is not
+// copied again.
+//
+// parameters:
+//    key - the key text to intern
+// returns:
+//    a view of the interned copy of the key text
+string_view JsonArena::intern(string_view key) {
+    unordered_set<string_view>::iterator it = keys.find(key);
+    if (it != keys.end()) return *it;
+    return *keys.insert(copy(key)).first;
+}
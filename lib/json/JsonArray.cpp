@@ -25,73 +25,413 @@
 //    You should have received a copy of the GNU General Public License
 //    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
+#include <cctype>
+#include <typeinfo>
 #include "JsonArray.h"
+#include "JsonHash.h"
+#include "JsonSerializer.h"
+#include "JsonValue.h"
+
+//*******************************************************************
+// parseIndex()
+//
+// This is a static helper function that converts the index part of a
+// specifier to a number in the same way as atol() without requiring a
+// null-terminated copy of the text.
+//
+// parameters:
+//   str - the text of the index
+// returns:
+//   the value of the index
+static long parseIndex(string_view str)
+{
+    unsigned long pos = 0;
+    while ((pos < str.length()) && (isspace((unsigned char)str[pos]))) pos++;
+    bool negative = false;
+    if ((pos < str.length()) && ((str[pos] == '-') || (str[pos] == '+'))) {
+        negative = (str[pos] == '-');
+        pos++;
+    }
+    long result = 0;
+    while ((pos < str.length()) && (str[pos] >= '0') && (str[pos] <= '9')) {
+        result = result * 10 + (str[pos] - '0');
+        pos++;
+    }
+    return (negative) ? -result : result;
+}
 
 //*******************************************************************
 // JsonArray()
 //
 // default constructor.
-JsonArray::JsonArray() {
+JsonArray::JsonArray() : arena(NULL), pending(NULL), pendingEntry(0) {
 
 }
 
 //*******************************************************************
 // JsonArray()
 //
-// Copy constructor - initialize this object as a deep clone of the 
-// specified object.
+// arena constructor - the array and its contents are allocated from
+// the specified arena.  Arrays owned by an arena are released when
+// the arena is reset and must not be deleted.
+//
+// parameters:
+//    arena - the arena that owns the array (or NULL for the heap)
+JsonArray::JsonArray(JsonArena* arena) :
+    arena(arena),
+    elements(JsonArena::resource(arena)),
+    pending(NULL),
+    pendingEntry(0)
+{
+}
+
+//*******************************************************************
+// JsonArray()
+//
+// Copy constructor - initialize this array as a copy of the specified
+// array.  The elements of a heap allocated array are shared with the
+// copy, the elements of an arena allocated array are cloned.
 // 
 // parameters:
 //    val - a reference of the object to clone.
-JsonArray::JsonArray(const JsonArray &ary) {
-    for (jsonarray::iterator it = internal_map.begin(); it != internal_map.end(); ++it) {
-        unsigned long key = it->first;
-        JsonAbstractValue& value = *(it->second);
-
-        // erase exsiting entry if it exists (this shouldnt happen)
-        jsonarray::iterator it2 = internal_map.find(key);
-        if (it2 != internal_map.end()) {
-            delete it2->second;
-            internal_map.erase(it2);
-        }
-        // add the new entry
-        internal_map.insert(pair<unsigned long, JsonAbstractValue*>(key, it->second->copy()));
+JsonArray::JsonArray(const JsonArray &ary) : JsonAbstractValue(ary), arena(NULL), pending(NULL), pendingEntry(0) {
+    const_cast<JsonArray&>(ary).load();
+    elements.reserve(ary.elements.size());
+    for (jsonarray::const_iterator it = ary.elements.begin(); it != ary.elements.end(); ++it) {
+        elements.push_back((ary.arena) ? (*it)->copy() : (*it)->share());
     }
 }
 
+//*******************************************************************
+// JsonArray()
+//
+// Move constructor - initialize this array with the elements of the
+// specified array, which is left empty.  The new array is allocated
+// in the same way as the original.
+// 
+// parameters:
+//    ary - a reference of the array to move from.
+JsonArray::JsonArray(JsonArray &&ary) :
+    arena(ary.arena),
+    elements(std::move(ary.elements)),
+    pending(ary.pending),
+    pendingEntry(ary.pendingEntry)
+{
+    ary.elements.clear();
+    ary.pending = NULL;
+    ary.touch();
+}
+
+//*******************************************************************
+// operator=()
+//
+// Move assignment operator - replace the elements of this array with
+// the elements of the specified array, which is left empty.  If the
+// arrays are not allocated in the same way, the elements are moved
+// one at a time.  Elements moved into an arena-owned array are cloned
+// into its arena, elements moved out of an arena-owned array are
+// copied to the heap, and the elements of a heap allocated array are
+// moved into another heap allocated array without being copied.
+// 
+// parameters:
+//    ary - a reference of the array to move from.
+JsonArray& JsonArray::operator=(JsonArray &&ary) {
+    if ((this == &ary) || (!modifiable("JsonArray")) || (!ary.modifiable("JsonArray"))) return *this;
+    touch();
+    ary.touch();
+    pending = NULL;
+    if (arena == ary.arena) {
+        // an array that has not been read yet can be moved unread
+        pending = ary.pending;
+        pendingEntry = ary.pendingEntry;
+        ary.pending = NULL;
+    } else {
+        ary.load();
+    }
+    if (!arena) {
+        for (jsonarray::iterator it = elements.begin(); it != elements.end(); ++it) 
+            JsonAbstractValue::release(*it);
+    }
+    elements.clear();
+    if (arena == ary.arena) {
+        elements.swap(ary.elements);
+        return *this;
+    }
+    elements.reserve(ary.elements.size());
+    for (jsonarray::iterator it = ary.elements.begin(); it != ary.elements.end(); ++it) {
+        elements.push_back((arena) ? (*it)->clone(arena) : (*it)->copy());
+        if (!ary.arena) JsonAbstractValue::release(*it);
+    }
+    ary.elements.clear();
+    return *this;
+}
+
 //*******************************************************************
 // ~JsonArray()
 //
 // destructor - deallocate any memory associated with this object.
 JsonArray::~JsonArray() {
-    for (jsonarray::iterator it = internal_map.begin(); it != internal_map.end(); ++it) 
-        delete it->second;
+    if (arena) return;
+    for (jsonarray::iterator it = elements.begin(); it != elements.end(); ++it) 
+        JsonAbstractValue::release(*it);
+    noteModified();
 }
 
 //*******************************************************************
 // copy()
 //
-// create a deep clone of this JsonValue and return the result.
+// create a copy of this array and return the result.  The copy shares
+// the elements of the array, so only the list of elements is copied.
 // 
 // parameters:
 //    none
 // returns:
-//    a pointer to a deep clone of the object
+//    a pointer to a copy of the array
 JsonAbstractValue* JsonArray::copy() {
     return (JsonAbstractValue*) new JsonArray(*this);
 }
 
+//*******************************************************************
+// clone()
+//
+// create a deep clone of this array within an arena.
+// 
+// parameters:
+//    arena - the arena to allocate the clone from (or NULL for the heap)
+// returns:
+//    a pointer to a clone of the array
+JsonAbstractValue* JsonArray::clone(JsonArena* arena) {
+    if (!arena) return copy();
+    load();
+    JsonArray* result = arena->make<JsonArray>(arena);
+    result->reserve(elements.size());
+    for (jsonarray::iterator it = elements.begin(); it != elements.end(); ++it) {
+        result->add((*it)->clone(arena));
+    }
+    return result;
+}
+
+//*******************************************************************
+// edit()
+//
+// return the specified element so that it can be modified without
+// affecting copies of this array.  Elements within an arena are never
+// shared.
+// 
+// parameters:
+//    index - the index of the element to return
+// returns:
+//    a pointer to the element that may be modified, otherwise NULL
+JsonAbstractValue* JsonArray::edit(unsigned long index) {
+    load();
+    if ((index >= elements.size()) || (!modifiable("JsonArray"))) return NULL;
+    touch();
+    JsonAbstractValue* value = elements[index];
+    if ((!arena) && (value->isShared())) {
+        elements[index] = value->copy();
+        JsonAbstractValue::release(value);
+    }
+    return elements[index];
+}
+
 //*******************************************************************
 // add()
 //
-// add a new element into the array.
+// add a new element into the array.  The array takes ownership of
+// the value - to add a value that is also held elsewhere, pass a copy
+// or a share() of it.  Values added to an arena-owned array must be
+// allocated from the same arena.  If the array is shared with a copy
+// of the structure, the value is released instead.
 // 
 // parameters:
 //    val - the new value to add
 // returns:
 //    void
 void JsonArray::add(JsonAbstractValue *val) {
-    internal_map.insert(pair<unsigned int, JsonAbstractValue*>(internal_map.size(), val));
+    load();
+    if (!modifiable("JsonArray")) {
+        if (!arena) JsonAbstractValue::release(val);
+        return;
+    }
+    touch();
+    elements.push_back(val);
+}
+
+//*******************************************************************
+// add()
+//
+// add a new element into the array, taking ownership of the value
+// from the caller.
+// 
+// parameters:
+//    val - the new value to add
+// returns:
+//    void
+void JsonArray::add(unique_ptr<JsonAbstractValue> val) {
+    add(val.release());
+}
+
+//*******************************************************************
+// insert()
+//
+// insert a new element before the specified position.  The array
+// takes ownership of the value if it is inserted.  Values added to an
+// arena-owned array must be allocated from the same arena.
+// 
+// parameters:
+//    index - the position of the new element (size() to add it to the
+//       end of the array)
+//    val - the new value to insert
+// returns:
+//    true if the value was inserted, false if the position is invalid
+bool JsonArray::insert(unsigned long index, JsonAbstractValue *val) {
+    load();
+    if ((index > elements.size()) || (!modifiable("JsonArray"))) return false;
+    touch();
+    elements.insert(elements.begin() + index, val);
+    return true;
+}
+
+//*******************************************************************
+// replace()
+//
+// replace the element at the specified position, releasing the value
+// that it held.  The array takes ownership of the new value if the
+// element is replaced.
+// 
+// parameters:
+//    index - the position of the element to replace
+//    val - the new value for the element
+// returns:
+//    true if the element was replaced, false if the position is invalid
+bool JsonArray::replace(unsigned long index, JsonAbstractValue *val) {
+    load();
+    if ((index >= elements.size()) || (!modifiable("JsonArray"))) return false;
+    touch();
+    if (!arena) JsonAbstractValue::release(elements[index]);
+    elements[index] = val;
+    return true;
+}
+
+//*******************************************************************
+// take()
+//
+// remove the element at the specified position and return it.  The
+// caller becomes the owner of the element (elements within an arena
+// are released with the arena).
+// 
+// parameters:
+//    index - the position of the element to remove
+// returns:
+//    the removed element, or NULL if the position is invalid
+JsonAbstractValue* JsonArray::take(unsigned long index) {
+    load();
+    if ((index >= elements.size()) || (!modifiable("JsonArray"))) return NULL;
+    touch();
+    JsonAbstractValue* value = elements[index];
+    elements.erase(elements.begin() + index);
+    return value;
+}
+
+//*******************************************************************
+// remove()
+//
+// remove the element at the specified position and release it.
+// 
+// parameters:
+//    index - the position of the element to remove
+// returns:
+//    true if the element was removed, false if the position is invalid
+bool JsonArray::remove(unsigned long index) {
+    JsonAbstractValue* value = take(index);
+    if (!value) return false;
+    if (!arena) JsonAbstractValue::release(value);
+    return true;
+}
+
+//*******************************************************************
+// reserve()
+//
+// reserve storage for the specified number of elements so that
+// subsequent calls to add() do not need to reallocate.
+// 
+// parameters:
+//    count - the number of elements to reserve storage for
+// returns:
+//    void
+void JsonArray::reserve(unsigned long count) {
+    load();
+    elements.reserve(count);
+}
+
+//*******************************************************************
+// defer()
+//
+// defer reading the elements of the array until they are first used.
+// Only an empty array allocated from the source's arena may be
+// deferred.
+// 
+// parameters:
+//    source - the source to read the elements from
+//    entry - the entry of the array within the source
+// returns:
+//    void
+void JsonArray::defer(JsonDeferred* source, unsigned long entry) {
+    pending = source;
+    pendingEntry = entry;
+}
+
+//*******************************************************************
+// expand()
+//
+// read the elements of the array from its source.  The array is
+// marked as read first so that the elements can be added normally.  If the
+// text is badly formed, the array is left empty (the error is recorded
+// on the source).  A deferred array is always held in the arena, so
+// the elements read so far do not need to be released.
+// 
+// parameters:
+//    none
+// returns:
+//    void
+void JsonArray::expand() {
+    JsonDeferred* source = pending;
+    pending = NULL;
+    if (!source->expand(this, pendingEntry)) elements.clear();
+}
+
+//*******************************************************************
+// computeHash()
+//
+// compute the structural hash of the array from the hashes of its
+// elements, taken in order.  The elements have already been hashed by
+// hash().
+// 
+// parameters:
+//    none
+// returns:
+//    the hash of the array
+uint64_t JsonArray::computeHash() {
+    load();
+    uint64_t result = JsonHash::SEED_ARRAY;
+    for (jsonarray::iterator it = elements.begin(); it != elements.end(); ++it) {
+        result = JsonHash::combine(result, (*it)->hash());
+    }
+    return JsonHash::combine(result, elements.size());
+}
+
+//*******************************************************************
+// children()
+//
+// add the elements of the array to the list.
+// 
+// parameters:
+//    list - the list to add the elements to
+// returns:
+//    void
+void JsonArray::children(vector<JsonAbstractValue*>& list) {
+    load();
+    list.insert(list.end(), elements.begin(), elements.end());
 }
 
 //*******************************************************************
@@ -109,20 +449,9 @@ void JsonArray::add(JsonAbstractValue *val) {
 // returns:
 //    void
 void JsonArray::dump(ostream& out, bool pretty, int indent, bool useIndent) {
-    out << "[";
-    if (pretty) cout<<endl;
-    bool firstElement = false;
-    for (jsonarray::iterator it = internal_map.begin(); it != internal_map.end(); ++it) {
-        it->second->dump(out, pretty, indent+3,true);
-        jsonarray::iterator itnext = it;
-        itnext++;
-        if (itnext != internal_map.end()) {
-            out << ",";
-        }
-        if (pretty) out << endl;
-    }
-    if (pretty) for (int i = 0;i < indent;i++) out<<" ";
-    out<<"]";
+    JsonSerializer serializer(pretty);
+    serializer.write(this, indent, useIndent);
+    serializer.flush(out);
 }
 
 //*******************************************************************
@@ -153,29 +482,54 @@ void JsonArray::dump(ostream& out, bool pretty) {
 //       a string representation of the entire object (not normal)
 // returns:
 //    a string representation of the requested value
-string JsonArray::getValue(string specifier) {
-    if (internal_map.empty()) return "";
+string JsonArray::getValue(string_view specifier) {
+    load();
+    if (elements.empty()) return "";
 
     if (specifier=="") {
         // The specifier is empty - return values for all records in the
         // object (this should not be normal)
         string result;
-        for (jsonarray::iterator it = internal_map.begin(); it != internal_map.end(); ++it) {
-            result.append(it->second->getValue(""));
+        for (jsonarray::iterator it = elements.begin(); it != elements.end(); ++it) {
+            result.append((*it)->getValue(""));
             result.append(", ");
         }
         return result;
     }
     // use the leftmost part of the specifier as the key
-    string index = specifier.substr(1, specifier.find("]") - 1);
-    string spec2 = specifier.substr(specifier.find(".") + 1, specifier.length() - specifier.find(".") - 1);
-    jsonarray::iterator it = internal_map.find(atol(index.c_str()));
-    if (it != internal_map.end()) {
-        return it->second->getValue(spec2);
+    string_view index = specifier.substr(1, specifier.find("]") - 1);
+    string_view spec2 = specifier.substr(specifier.find(".") + 1, specifier.length() - specifier.find(".") - 1);
+    JsonAbstractValue* element = getElement(parseIndex(index));
+    if (element) {
+        return element->getValue(spec2);
     }
     return "";
 }
 
+//*******************************************************************
+// getValueView()
+//
+// returns a view of the text of the specified element where the
+// specifier is of the form:
+// 		[index].key
+// 
+// parameters:
+//    specifier - the key for the value to return
+// returns:
+//    a view of the requested value text, or an empty view if the value
+//    is not found
+string_view JsonArray::getValueView(string_view specifier) {
+    if (specifier.empty()) return string_view();
+    // use the leftmost part of the specifier as the key
+    string_view index = specifier.substr(1, specifier.find("]") - 1);
+    string_view spec2 = specifier.substr(specifier.find(".") + 1, specifier.length() - specifier.find(".") - 1);
+    JsonAbstractValue* element = getElement(parseIndex(index));
+    if (element) {
+        return element->getValueView(spec2);
+    }
+    return string_view();
+}
+
 //*******************************************************************
 // getBoolean()
 //
@@ -188,16 +542,16 @@ string JsonArray::getValue(string specifier) {
 //       a string representation of the entire object (not normal)
 // returns:
 //    a boolean representation of the requested value
-bool JsonArray::getBoolean(string specifier) {
+bool JsonArray::getBoolean(string_view specifier) {
     if (specifier == "") return false;
     // use the leftmost part of the specifier as the key
-    string index = specifier.substr(1, specifier.find("]") - 1);
-    string spec2 = specifier.substr(specifier.find(".") + 1, specifier.length() - specifier.find(".") - 1);
-    jsonarray::iterator it = internal_map.find(atol(index.c_str()));
-    if (it != internal_map.end()) {
-        return it->second->getBoolean(spec2);
+    string_view index = specifier.substr(1, specifier.find("]") - 1);
+    string_view spec2 = specifier.substr(specifier.find(".") + 1, specifier.length() - specifier.find(".") - 1);
+    JsonAbstractValue* element = getElement(parseIndex(index));
+    if (element) {
+        return element->getBoolean(spec2);
     }
-    return "";
+    return false;
 }
 
 //*******************************************************************
@@ -212,14 +566,14 @@ bool JsonArray::getBoolean(string specifier) {
 //       a string representation of the entire object (not normal)
 // returns:
 //    a string representation of the requested handle
-string JsonArray::getHandle(string specifier) {
+string JsonArray::getHandle(string_view specifier) {
     if (specifier == "") return "";
     // use the leftmost part of the specifier as the key
-    string index = specifier.substr(1, specifier.find("]") - 1);
-    string spec2 = specifier.substr(specifier.find(".") + 1, specifier.length() - specifier.find(".") - 1);
-    jsonarray::iterator it = internal_map.find(atol(index.c_str()));
-    if (it != internal_map.end()) {
-        return it->second->getHandle(spec2);
+    string_view index = specifier.substr(1, specifier.find("]") - 1);
+    string_view spec2 = specifier.substr(specifier.find(".") + 1, specifier.length() - specifier.find(".") - 1);
+    JsonAbstractValue* element = getElement(parseIndex(index));
+    if (element) {
+        return element->getHandle(spec2);
     }
     return "";
 }
@@ -236,14 +590,14 @@ string JsonArray::getHandle(string specifier) {
 //       a string representation of the entire object (not normal)
 // returns:
 //    an integer representation of the requested value
-long JsonArray::getInteger(string specifier) {
+long JsonArray::getInteger(string_view specifier) {
     if (specifier == "") return 0;
     // use the leftmost part of the specifier as the key
-    string index = specifier.substr(1, specifier.find("]") - 1);
-    string spec2 = specifier.substr(specifier.find(".") + 1, specifier.length() - specifier.find(".") - 1);
-    jsonarray::iterator it = internal_map.find(atol(index.c_str()));
-    if (it != internal_map.end()) {
-        return it->second->getInteger(spec2);
+    string_view index = specifier.substr(1, specifier.find("]") - 1);
+    string_view spec2 = specifier.substr(specifier.find(".") + 1, specifier.length() - specifier.find(".") - 1);
+    JsonAbstractValue* element = getElement(parseIndex(index));
+    if (element) {
+        return element->getInteger(spec2);
     }
     return 0;
 }
@@ -261,14 +615,14 @@ long JsonArray::getInteger(string specifier) {
 //       a string representation of the entire object (not normal)
 // returns:
 //    a double representation of the requested value
-double JsonArray::getDouble(string specifier) {
+double JsonArray::getDouble(string_view specifier) {
     if (specifier == "") return 0.0;
     // use the leftmost part of the specifier as the key
-    string index = specifier.substr(1, specifier.find("]") - 1);
-    string spec2 = specifier.substr(specifier.find(".") + 1, specifier.length() - specifier.find(".") - 1);
-    jsonarray::iterator it = internal_map.find(atol(index.c_str()));
-    if (it != internal_map.end()) {
-        return it->second->getDouble(spec2);
+    string_view index = specifier.substr(1, specifier.find("]") - 1);
+    string_view spec2 = specifier.substr(specifier.find(".") + 1, specifier.length() - specifier.find(".") - 1);
+    JsonAbstractValue* element = getElement(parseIndex(index));
+    if (element) {
+        return element->getDouble(spec2);
     }
     return 0.0;
 }
@@ -283,24 +637,110 @@ double JsonArray::getDouble(string specifier) {
 // returns:
 //    the number of fields in this array.
 unsigned long JsonArray::size() {
-    return internal_map.size();
+    load();
+    return elements.size();
 }
 
 //*******************************************************************
 // getElement()
 //
-// return the value of the indexed element.
+// return the value of the indexed element.  Elements are stored
+// contiguously so this is a constant-time operation.
 // 
 // parameters:
-//    none.
+//    index - the index of the element to return.
 // returns:
 //    a pointer to the JsonAbstractValue indexed by the input parameter.
 //    NULL if the element does not exist.
 JsonAbstractValue* JsonArray::getElement(unsigned long index) {
-    // attempt to find the indexed item in the array
-    jsonarray::iterator it = internal_map.find(index);
+    load();
+    if (index >= elements.size()) return NULL;
+    return elements[index];
+}
+
+//*******************************************************************
+// begin()
+//
+// return an iterator to the first element of the array.
+// 
+// parameters:
+//    none.
+// returns:
+//    an iterator positioned at the first element.
+JsonArray::iterator JsonArray::begin() const {
+    const_cast<JsonArray*>(this)->load();
+    return elements.begin();
+}
+
+//*******************************************************************
+// end()
+//
+// return an iterator positioned after the last element of the array.
+// 
+// parameters:
+//    none.
+// returns:
+//    an iterator positioned after the last element.
+JsonArray::iterator JsonArray::end() const {
+    const_cast<JsonArray*>(this)->load();
+    return elements.end();
+}
+
+//*******************************************************************
+// getColumns()
+//
+// extract numeric fields from each element of an array of objects into
+// columns of doubles in a single pass over the elements.  Missing
+// values are stored as zero and values that are not numbers are stored
+// as their double interpretation, so that the columns are always
+// filled.  The first problem found is reported to cerr.
+//
+// The hash of each key is computed once, when its JsonKey is made, so
+// no key text is hashed within the pass - each field is found by a
+// lookup on that hash followed by a comparison of the key text.  The
+// elements and fields are checked to be objects and value primitives
+// by comparing their exact type rather than by casting each one.
+// 
+// parameters:
+//    keys - the keys of the fields to extract
+//    columns - the columns to receive the fields.  columns[k][i] receives
+//       field keys[k] of element i.
+//    count - the number of keys (and columns)
+// returns:
+//    true if every field of every element was a number, otherwise false
+bool JsonArray::getColumns(const JsonKey* keys, double* const* columns, unsigned long count) {
+    load();
+    bool result = true;
+    for (unsigned long i = 0; i < elements.size(); i++) {
+        JsonAbstractValue* element = elements[i];
+        JsonObject* obj = (typeid(*element) == typeid(JsonObject)) ? static_cast<JsonObject*>(element) : NULL;
+        for (unsigned long k = 0; k < count; k++) {
+            JsonAbstractValue* field = (obj) ? obj->find(keys[k]) : NULL;
+            JsonValue* val = ((field) && (typeid(*field) == typeid(JsonValue))) ? static_cast<JsonValue*>(field) : NULL;
+            columns[k][i] = (val) ? val->getDouble("") : 0.0;
+            if ((val) && ((val->getType() == JSON_INTEGER) || (val->getType() == JSON_DOUBLE))) continue;
+            if (result) {
+                cerr << "numeric field '" << keys[k].getText() << "' expected in array element " << i;
+                if (!obj) cerr << " (element is not an object)";
+                cerr << endl;
+            }
+            result = false;
+        }
+    }
+    return result;
+}
 
-    // return the result if found, otherwise, null
-    if (it != internal_map.end()) return it->second;
-    return NULL;
+//*******************************************************************
+// getColumn()
+//
+// extract a numeric field from each element of an array of objects.
+// 
+// parameters:
+//    key - the key of the field to extract
+//    column - the column to receive the field, with room for size()
+//       values
+// returns:
+//    true if the field of every element was a number, otherwise false
+bool JsonArray::getColumn(const JsonKey& key, double* column) {
+    return getColumns(&key, &column, 1);
 }
@@ -0,0 +1,219 @@
+//*******************************************************************
+//    JsonDiff.cpp
+//
+//    This file provides implementation for a class that compares two
+//    JSON structures and reports the values that were added, removed or
+//    changed.  This file is intended to be used as part of the PICMG IoT
+//    library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <algorithm>
+#include "JsonDiff.h"
+#include "JsonObject.h"
+#include "JsonArray.h"
+#include "JsonValue.h"
+#include "JsonPointer.h"
+
+//*******************************************************************
+// pathOf()
+//
+// build the JSON Pointer of a node from the tokens of the node and its
+// parents.
+//
+// parameters:
+//    nodes - the nodes visited so far
+//    node - the node to build the pointer for
+// returns:
+//    the pointer ("" for the root)
+string JsonDiff::pathOf(const vector<Node>& nodes, unsigned long node) {
+    vector<unsigned long> chain;
+    for (unsigned long n = node; nodes[n].parent != NO_PARENT; n = nodes[n].parent) {
+        chain.push_back(n);
+    }
+    string path;
+    for (vector<unsigned long>::reverse_iterator it = chain.rbegin(); it != chain.rend(); ++it) {
+        JsonPointer::appendToken(path, nodes[*it].token);
+    }
+    return path;
+}
+
+//*******************************************************************
+// equals()
+//
+// return true if two structures have the same content.  The hashes of
+// each pair of values are compared first, so most differences are
+// found without walking the structures.  Equal hashes are confirmed by
+// comparing the structures themselves, using an explicit stack so that
+// deeply nested structures do not exhaust the call stack.
+//
+// parameters:
+//    before - the first structure
+//    after - the second structure
+// returns:
+//    true if the structures are equal, otherwise false
+bool JsonDiff::equals(JsonAbstractValue* before, JsonAbstractValue* after) {
+    vector<pair<JsonAbstractValue*, JsonAbstractValue*>> stack;
+    stack.push_back(make_pair(before, after));
+    while (!stack.empty()) {
+        JsonAbstractValue* a = stack.back().first;
+        JsonAbstractValue* b = stack.back().second;
+        stack.pop_back();
+        if (a == b) continue;
+        if ((!a) || (!b) || (a->hash() != b->hash())) return false;
+
+        JsonObject* objA = dynamic_cast<JsonObject*>(a);
+        JsonObject* objB = dynamic_cast<JsonObject*>(b);
+        if ((objA) || (objB)) {
+            // every field of the first object must be in the second
+            if ((!objA) || (!objB) || (objA->size() != objB->size())) return false;
+            for (unsigned long i = 0; i < objA->size(); i++) {
+                JsonAbstractValue* val = objB->find(objA->getElementKeyView(i));
+                if (!val) return false;
+                stack.push_back(make_pair(objA->getElement(i), val));
+            }
+            continue;
+        }
+        JsonArray* aryA = dynamic_cast<JsonArray*>(a);
+        JsonArray* aryB = dynamic_cast<JsonArray*>(b);
+        if ((aryA) || (aryB)) {
+            if ((!aryA) || (!aryB) || (aryA->size() != aryB->size())) return false;
+            for (unsigned long i = 0; i < aryA->size(); i++) {
+                stack.push_back(make_pair(aryA->getElement(i), aryB->getElement(i)));
+            }
+            continue;
+        }
+        JsonValue* valA = dynamic_cast<JsonValue*>(a);
+        JsonValue* valB = dynamic_cast<JsonValue*>(b);
+        if ((!valA) || (!valB) || (!valA->equals(*valB))) return false;
+    }
+    return true;
+}
+
+//*******************************************************************
+// same()
+//
+// return true if a pair of values is treated as equal by compare().
+//
+// parameters:
+//    a - the value in the first structure
+//    b - the value in the second structure
+//    confirm - true if equal hashes are confirmed by equals()
+// returns:
+//    true if the values are treated as equal, otherwise false
+bool JsonDiff::same(JsonAbstractValue* a, JsonAbstractValue* b, bool confirm) {
+    if (a == b) return true;
+    if (a->hash() != b->hash()) return false;
+    return (!confirm) || (equals(a, b));
+}
+
+//*******************************************************************
+// compare()
+//
+// compare two structures and return the differences between them.
+// The structures are walked with an explicit stack so that deeply
+// nested structures do not exhaust the call stack.  The children of a
+// pair are pushed in reverse so that they are visited in document
+// order.  A child with only one side is reported as added or removed
+// when it is visited.  Pairs that are equal (see same()) are skipped.
+//
+// parameters:
+//    before - the first structure
+//    after - the second structure
+//    confirm - true if equal hashes are confirmed by equals()
+// returns:
+//    the list of changes (empty if the structures are equal)
+vector<JsonDiff::Change> JsonDiff::compare(JsonAbstractValue* before, JsonAbstractValue* after,
+    bool confirm) {
+    vector<Change> changes;
+    vector<Node> nodes;
+    vector<unsigned long> stack;
+    nodes.push_back({ before, after, NO_PARENT, string() });
+    stack.push_back(0);
+
+    vector<Node> children;
+    while (!stack.empty()) {
+        unsigned long n = stack.back();
+        stack.pop_back();
+        JsonAbstractValue* a = nodes[n].before;
+        JsonAbstractValue* b = nodes[n].after;
+
+        // values that are only on one side
+        if ((!a) || (!b)) {
+            if ((!a) && (!b)) continue;
+            changes.push_back({ (a) ? CHANGE_REMOVED : CHANGE_ADDED, pathOf(nodes, n), a, b });
+            continue;
+        }
+
+        // identical values, and values with the same content
+        if (same(a, b, confirm)) continue;
+
+        children.clear();
+        JsonObject* objA = dynamic_cast<JsonObject*>(a);
+        JsonObject* objB = dynamic_cast<JsonObject*>(b);
+        JsonArray* aryA = (objA) ? NULL : dynamic_cast<JsonArray*>(a);
+        JsonArray* aryB = (objB) ? NULL : dynamic_cast<JsonArray*>(b);
+        if ((objA) && (objB)) {
+            // fields of the first object, in order, then the fields
+            // that are only in the second object
+            for (unsigned long i = 0; i < objA->size(); i++) {
+                string_view key = objA->getElementKeyView(i);
+                children.push_back({ objA->getElement(i), objB->find(key), n, string(key) });
+            }
+            for (unsigned long i = 0; i < objB->size(); i++) {
+                string_view key = objB->getElementKeyView(i);
+                if (!objA->find(key)) children.push_back({ NULL, objB->getElement(i), n, string(key) });
+            }
+        } else if ((aryA) && (aryB)) {
+            // skip the elements that are equal at the start and end of
+            // both arrays, then pair up the remaining elements by position
+            unsigned long sizeA = aryA->size();
+            unsigned long sizeB = aryB->size();
+            unsigned long shorter = min(sizeA, sizeB);
+            unsigned long prefix = 0;
+            while ((prefix < shorter) &&
+                (same(aryA->getElement(prefix), aryB->getElement(prefix), confirm))) prefix++;
+            unsigned long suffix = 0;
+            while ((suffix < shorter - prefix) &&
+                (same(aryA->getElement(sizeA - 1 - suffix), aryB->getElement(sizeB - 1 - suffix), confirm))) suffix++;
+            unsigned long restA = sizeA - prefix - suffix;
+            unsigned long restB = sizeB - prefix - suffix;
+            for (unsigned long i = 0; i < min(restA, restB); i++) {
+                children.push_back({ aryA->getElement(prefix + i), aryB->getElement(prefix + i), n, to_string(prefix + i) });
+            }
+            for (unsigned long i = restB; i < restA; i++) {
+                children.push_back({ aryA->getElement(prefix + i), NULL, n, to_string(prefix + i) });
+            }
+            for (unsigned long i = restA; i < restB; i++) {
+                children.push_back({ NULL, aryB->getElement(prefix + i), n, to_string(prefix + i) });
+            }
+        } else {
+            // values of different kinds, or primitives with different values
+            changes.push_back({ CHANGE_CHANGED, pathOf(nodes, n), a, b });
+            continue;
+        }
+
+        for (vector<Node>::reverse_iterator it = children.rbegin(); it != children.rend(); ++it) {
+            stack.push_back(nodes.size());
+            nodes.push_back(*it);
+        }
+    }
+    return changes;
+}
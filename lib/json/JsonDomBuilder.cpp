@@ -0,0 +1,276 @@
+//*******************************************************************
+//    JsonDomBuilder.cpp
+//
+//    This file provides implementation for an event handler that builds
+//    a JSON structure from the events produced by the JsonFactory
+//    parser.  This file is intended to be used as part of the PICMG IoT
+//    library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <iostream>
+#include "JsonDomBuilder.h"
+#include "JsonText.h"
+
+//*******************************************************************
+// JsonDomBuilder()
+//
+// constructor.
+//
+// parameters:
+//    arena - the arena to build the structure into (or NULL for the heap)
+//    borrow - true if values should refer to the text passed to the
+//       scalar events rather than copy it.  The text must then outlive
+//       the structure.
+//    decode - true if the escape sequences of keys and quoted values
+//       should be decoded.  Strings that are not valid UTF-8 are then
+//       rejected.
+JsonDomBuilder::JsonDomBuilder(JsonArena* arena, bool borrow, bool decode) :
+    arena(arena), borrow(borrow), decode(decode), root(NULL) {
+}
+
+//*******************************************************************
+// ~JsonDomBuilder()
+//
+// destructor - discard any structure that has not been released.
+JsonDomBuilder::~JsonDomBuilder() {
+    discard();
+}
+
+//*******************************************************************
+// newObject()
+//
+// allocate a new json object.
+JsonObject* JsonDomBuilder::newObject() {
+    if (arena) return arena->make<JsonObject>(arena);
+    return new JsonObject();
+}
+
+//*******************************************************************
+// newArray()
+//
+// allocate a new json array.
+JsonArray* JsonDomBuilder::newArray() {
+    if (arena) return arena->make<JsonArray>(arena);
+    return new JsonArray();
+}
+
+//*******************************************************************
+// newValue()
+//
+// allocate a new json value.  When building into an arena, the text is
+// copied into the arena (unless it is borrowed) so that the value owns
+// no heap memory.  Quoted values are always strings, the type of
+// unquoted values is inferred from their text.
+JsonValue* JsonDomBuilder::newValue(string_view text, bool quoted) {
+    if (arena) {
+        if (!borrow) text = arena->copy(text);
+        return arena->make<JsonValue>(text, true, quoted);
+    }
+    return new JsonValue(text, borrow, quoted);
+}
+
+//*******************************************************************
+// newString()
+//
+// allocate a new json string value with its escape sequences decoded.
+// Strings without escape sequences can still refer to the source text,
+// decoded strings are held by the arena or by the value.
+//
+// parameters:
+//    text - the text of the string, without its quotes
+// returns:
+//    the new value, or NULL if the text is not a valid string
+JsonValue* JsonDomBuilder::newString(string_view text) {
+    if (arena) {
+        bool ok;
+        text = JsonText::decode(text, *arena, !borrow, ok);
+        if (!ok) return NULL;
+        return arena->make<JsonValue>(text, true, true);
+    }
+    if ((borrow) && (!JsonText::hasEscapes(text))) {
+        if (!JsonText::isValidUtf8(text)) return NULL;
+        return new JsonValue(text, true, true);
+    }
+    if (!JsonText::decode(text, scratch)) return NULL;
+    return new JsonValue(scratch, false, true);
+}
+
+//*******************************************************************
+// attach()
+//
+// add a new value to the innermost container that is being built, or
+// make it the root of the structure if there is no container.
+//
+// parameters:
+//    val - the value to add
+// returns:
+//    void
+void JsonDomBuilder::attach(JsonAbstractValue* val) {
+    if (stack.empty()) {
+        root = val;
+        return;
+    }
+    Frame& frame = stack.back();
+    if (frame.object) {
+        frame.object->put(frame.key, val);
+    } else {
+        frame.array->add(val);
+    }
+}
+
+//*******************************************************************
+// startObject()
+//
+// begin a new json object within the current container.
+bool JsonDomBuilder::startObject() {
+    JsonObject* obj = newObject();
+    attach(obj);
+    Frame frame = { obj, NULL, JsonKey() };
+    stack.push_back(frame);
+    return true;
+}
+
+//*******************************************************************
+// key()
+//
+// record the key for the next field of the current object.
+bool JsonDomBuilder::key(string_view key) {
+    if ((stack.empty()) || (!stack.back().object)) return false;
+    if (decode) {
+        if (!JsonText::decode(key, scratch)) {
+            cerr << "Invalid string \"" << key.substr(0, 160) << "\"" << endl;
+            return false;
+        }
+        key = scratch;
+    }
+    stack.back().key = JsonKey(key);
+    return true;
+}
+
+//*******************************************************************
+// endObject()
+//
+// complete the current json object.
+bool JsonDomBuilder::endObject() {
+    if ((stack.empty()) || (!stack.back().object)) return false;
+    stack.pop_back();
+    return true;
+}
+
+//*******************************************************************
+// startArray()
+//
+// begin a new json array within the current container.
+bool JsonDomBuilder::startArray() {
+    JsonArray* arr = newArray();
+    attach(arr);
+    Frame frame = { NULL, arr, JsonKey() };
+    stack.push_back(frame);
+    return true;
+}
+
+//*******************************************************************
+// endArray()
+//
+// complete the current json array.
+bool JsonDomBuilder::endArray() {
+    if ((stack.empty()) || (!stack.back().array)) return false;
+    stack.pop_back();
+    return true;
+}
+
+//*******************************************************************
+// scalar()
+//
+// add a value primitive to the current container.
+bool JsonDomBuilder::scalar(string_view text, bool quoted) {
+    if ((decode) && (quoted)) {
+        JsonValue* val = newString(text);
+        if (!val) {
+            cerr << "Invalid string \"" << text.substr(0, 160) << "\"" << endl;
+            return false;
+        }
+        attach(val);
+        return true;
+    }
+    attach(newValue(text, quoted));
+    return true;
+}
+
+//*******************************************************************
+// value()
+//
+// add a value that was built separately to the current container.
+//
+// parameters:
+//    val - the value to add
+// returns:
+//    void
+void JsonDomBuilder::value(JsonAbstractValue* val) {
+    attach(val);
+}
+
+//*******************************************************************
+// reserve()
+//
+// reserve space for the elements of the current array.
+//
+// parameters:
+//    count - the number of elements expected
+// returns:
+//    void
+void JsonDomBuilder::reserve(unsigned long count) {
+    if ((!stack.empty()) && (stack.back().array)) stack.back().array->reserve(count);
+}
+
+//*******************************************************************
+// release()
+//
+// return the structure that was built.  The caller takes ownership of
+// the structure (unless it was built into an arena).
+//
+// parameters:
+//    none
+// returns:
+//    the structure that was built, or NULL if nothing was built
+JsonAbstractValue* JsonDomBuilder::release() {
+    JsonAbstractValue* result = root;
+    root = NULL;
+    stack.clear();
+    return result;
+}
+
+//*******************************************************************
+// discard()
+//
+// discard any structure that was built, including a partially built
+// structure left by a parsing error.  Structures built into an arena
+// are released when the arena is reset.
+//
+// parameters:
+//    none
+// returns:
+//    void
+void JsonDomBuilder::discard() {
+    if (!arena) delete root;
+    root = NULL;
+    stack.clear();
+}
@@ -1,16 +1,69 @@
 #include "JsonFactory.h"
+#include "JsonDomBuilder.h"
+#include "JsonLazyDocument.h"
+#include <cstring>
+#include <thread>
 
-// return a string that is equivalent to the starting string with leading whitespace removed
-string trim(const string & str)
-{
-    unsigned long start = str.find_first_not_of(" \f\n\r\t\v");
-    return str.substr(start, str.length() - start);
+/*
+* a range of the elements of an array that is parsed by one thread.  The
+* bounds hold the start position and the delimiter position of each element.
+*/
+struct JsonFactory::ParallelJob {
+    string_view text;                    // the text being parsed
+    const vector<unsigned long>* bounds; // element start and delimiter positions
+    unsigned long first;                 // first element parsed by the job
+    unsigned long last;                  // one past the last element
+    JsonArena* arena;                    // arena to build into (or NULL)
+    bool borrow;                         // true if values refer to the text
+    bool decode;                         // true if strings are decoded
+    vector<JsonAbstractValue*> values;   // the elements that were built
+    bool ok;                             // true if every element was parsed
+};
+
+/*
+* helper function to read more of the stream into the window.  Text before the
+* start position has been consumed and is discarded, the start position and the
+* current position are adjusted to match.
+*/
+bool JsonFactory::fill(unsigned long &start) {
+    if ((!input) || (!input->good())) return false;
+    if (start > 0) {
+        window.erase(0, start);
+        strpos -= start;
+        start = 0;
+    }
+    unsigned long used = window.size();
+    window.resize(used + windowSize);
+    input->read(&window[used], windowSize);
+    window.resize(used + input->gcount());
+    str = window;
+    return input->gcount() > 0;
 }
 
-/* helper function to skip past white space */
+/*
+* helper function that returns true if there is text at the current position,
+* reading more of the stream if required.  Text from the start position onward
+* is retained.
+*/
+bool JsonFactory::more(unsigned long &start) {
+    while (strpos >= str.length()) {
+        if (!fill(start)) return false;
+    }
+    return true;
+}
+
+/*
+* helper function to skip past white space.  While parsing a single line document,
+* white space stops at a newline.
+*/
 void JsonFactory::skipWhitespace() {
-    while (strpos < str.length()) {
-        if (str[strpos] <= ' ') {
+    if ((!input) && (!singleLine)) {
+        if ((strpos < str.length()) && (str[strpos] > ' ')) return;
+        strpos = JsonStructuralIndex::skipWhitespace(str, strpos);
+        return;
+    }
+    while (more()) {
+        if ((str[strpos] <= ' ') && ((!singleLine) || (str[strpos] != '\n'))) {
             strpos++;
         }
         else {
@@ -20,44 +73,158 @@ void JsonFactory::skipWhitespace() {
 }
 
 /*
-* helper function used by builder to extract a double quoted string
+* helper function used by parser to extract a double quoted string.  Returns false
+* if the string is not terminated (or, while parsing a single line document, holds
+* a raw newline, in which case the position is left at the newline).
 */
-string JsonFactory::getstring() {
-    if (str[strpos] != '\"') return "";
+bool JsonFactory::getstring(string_view &result) {
+    result = string_view();
+    if ((!more()) || (str[strpos] != '\"')) return false;
     strpos++;
-    int start = strpos;
+    unsigned long start = strpos;
+    if (indexed) {
+        // the string ends at the next quote in the index
+        while ((seek()) && (str[index[cursor]] != '\"')) cursor++;
+        if (cursor >= index.size()) {
+            strpos = str.length();
+            return false;
+        }
+        if (singleLine) {
+            const char* newline = (const char*)memchr(str.data() + start, '\n', index[cursor] - start);
+            if (newline) {
+                strpos = newline - str.data();
+                return false;
+            }
+        }
+        strpos = index[cursor++] + 1;
+        result = str.substr(start, strpos-start-1);
+        return true;
+    }
     bool ignoreNext = false;
-    while (strpos < str.length()) {
+    while (more(start)) {
         if ((str[strpos] == '\"') && (!ignoreNext)) {
-            string result = str.substr(start, strpos-start);
+            result = str.substr(start, strpos-start);
             strpos++;
-            return result;
+            return true;
         }
-        ignoreNext = false;
-        if (str[strpos] == '\\') ignoreNext = true;
+        if ((singleLine) && (str[strpos] == '\n')) return false;
+        // a backslash escapes the next character unless it is itself escaped
+        ignoreNext = (str[strpos] == '\\') && (!ignoreNext);
         strpos++;
     }
-    return "";
+    return false;
 }
 
 /*
-* helper function used by builder to extract a string that is delimited by
-* JSON ending delimiters.
+* helper function used by parser to extract a string that is delimited by
+* JSON ending delimiters.  While parsing a single line document, the string also
+* ends (as badly formed) at a newline.
 */
-string JsonFactory::getRaw() {
-    int start = strpos;
-    while (strpos < str.length()) {
+string_view JsonFactory::getRaw() {
+    unsigned long start = strpos;
+    if ((indexed) && (seek())) {
+        // the value ends at the next delimiter in the index.  If a quote
+        // comes first, the text is not well formed and is scanned instead.
+        for (unsigned long next = cursor; next < index.size(); next++) {
+            char c = str[index[next]];
+            if (c == '"') break;
+            if ((c == ',') || (c == '}') || (c == ']')) {
+                if ((singleLine) && (memchr(str.data() + start, '\n', index[next] - start))) break;
+                cursor = next;
+                strpos = index[next];
+                return str.substr(start, strpos-start);
+            }
+        }
+    }
+    while (more(start)) {
         if ((str[strpos] == ',') || (str[strpos] == '}') ||
             (str[strpos] == ']')) {
-            string result = str.substr(start, strpos-start);
+            string_view result = str.substr(start, strpos-start);
             return result;
         }
+        if ((singleLine) && (str[strpos] == '\n')) break;
         strpos++;
     }
-    return "";
+    return string_view();
+}
+
+JsonFactory::JsonFactory() : 
+    strpos(0), input(NULL), windowSize(65536), aborted(false), indexed(false), cursor(0),
+    threads(1), parallelSize(1048576), dom(NULL), decode(false), delimited(false),
+    singleLine(false) {
+}
+
+/**
+* enable parsing of large arrays on multiple threads.  Only arrays that form the
+* outermost value, or a field of the outermost object, are split between threads,
+* and only when building from a buffer.
+* @param threads - the number of threads to use (1 disables parallel parsing)
+* @param minimumSize - the size in bytes below which arrays are parsed on the
+*    calling thread
+*/
+void JsonFactory::setParallel(unsigned int threads, unsigned long minimumSize) {
+    this->threads = (threads) ? threads : 1;
+    parallelSize = minimumSize;
+}
+
+/**
+* enable decoding of strings as structures are built.  Escape sequences within keys
+* and quoted values are decoded, and text that is not valid UTF-8 fails the build.
+* Event parsers always report the text as it appears in the input.
+* @param decode - true to decode strings, false to hold them as they appear
+*/
+void JsonFactory::setDecode(bool decode) {
+    this->decode = decode;
+}
+
+/**
+* require each document built by next() to lie on a single line, as in NDJSON.  A
+* raw newline within a string, or before the end of a document, ends the document
+* as badly formed so that the next line is read as the next document.
+* @param delimited - true if documents end at the end of their line, false if a
+*    document may span lines
+*/
+void JsonFactory::setDelimited(bool delimited) {
+    this->delimited = delimited;
+}
+
+/*
+* helper function that advances the index cursor to the first entry at or after
+* the current position.  Returns true if there is such an entry.
+*/
+bool JsonFactory::seek() {
+    while ((cursor < index.size()) && (index[cursor] < strpos)) cursor++;
+    return cursor < index.size();
+}
+
+/*
+* helper function used by parser when the handler stops the parse
+*/
+bool JsonFactory::stop() {
+    aborted = true;
+    return false;
+}
+
+/*
+* helper function that builds a JsonAbstractValue from a buffer
+*/
+JsonAbstractValue *JsonFactory::start(string_view str, bool borrow, JsonArena* arena) {
+    JsonDomBuilder builder(arena, borrow, decode);
+    if (threads > 1) dom = &builder;
+    bool result = parse(str, builder);
+    dom = NULL;
+    if (!result) return NULL;
+    return builder.release();
 }
 
-JsonFactory::JsonFactory() : strpos(0) {
+/*
+* helper function that builds a JsonAbstractValue from a stream.  The values
+* always own copies of their text since the window is reused.
+*/
+JsonAbstractValue *JsonFactory::start(istream &in, JsonArena* arena) {
+    JsonDomBuilder dom(arena, false, decode);
+    if (!parse(in, dom)) return NULL;
+    return dom.release();
 }
 
 /**
@@ -65,142 +232,549 @@ JsonFactory::JsonFactory() : strpos(0) {
 * @param str - the JSON formatted string that specifies the structure to build
 * @return A JsonAbstractValue structure that matches the input string
 */
-JsonAbstractValue *JsonFactory::build(string str) {
-    // trim leading and trailing whitespace
-    this->str = trim(str);
+JsonAbstractValue *JsonFactory::build(const string &str) {
+    return start(str, false, NULL);
+}
+
+/**
+* zero-copy entry point for the builder.  Builds a JsonAbstractValue based on the
+* input buffer.  Values within the resulting structure refer directly to the
+* buffer contents rather than owning copies.
+* @param str - a view of the JSON formatted buffer.  The buffer must outlive the
+*    structure that is returned.
+* @return A JsonAbstractValue structure that matches the input string
+*/
+JsonAbstractValue *JsonFactory::buildView(string_view str) {
+    return start(str, true, NULL);
+}
+
+/**
+* arena entry point for the builder.  Builds a JsonAbstractValue based on the input
+* string, allocating every node from the specified arena.
+* @param str - the JSON formatted string that specifies the structure to build
+* @param arena - the arena that will own the structure
+* @return A JsonAbstractValue structure that matches the input string.  The structure
+*    is released by resetting the arena.
+*/
+JsonAbstractValue *JsonFactory::build(const string &str, JsonArena &arena) {
+    return start(str, false, &arena);
+}
+
+/**
+* zero-copy arena entry point for the builder.  Nodes are allocated from the arena
+* and values refer directly to the buffer contents.
+* @param str - a view of the JSON formatted buffer.  The buffer must outlive the
+*    structure that is returned.
+* @param arena - the arena that will own the structure
+* @return A JsonAbstractValue structure that matches the input string.  The structure
+*    is released by resetting the arena.
+*/
+JsonAbstractValue *JsonFactory::buildView(string_view str, JsonArena &arena) {
+    return start(str, true, &arena);
+}
+
+/**
+* lazy entry point for the builder.  Only the outermost object or array is
+* created - the contents of each object and array are read from the buffer when
+* they are first used.  Text that does not hold an object or array, or whose
+* brackets do not balance, is built in full instead, as is all text when strings
+* are decoded.
+* @param str - a view of the JSON formatted buffer.  The buffer must outlive the
+*    structure that is returned.
+* @param arena - the arena that will own the structure
+* @param document - if not NULL, receives the document that the structure is read
+*    from, whose hasError() reports text found to be badly formed as the structure
+*    is used.  Receives NULL if the structure was built in full.
+* @return A JsonAbstractValue structure that matches the input string.  The structure
+*    is released by resetting the arena.
+*/
+JsonAbstractValue *JsonFactory::buildLazy(string_view str, JsonArena &arena, JsonLazyDocument** document) {
+    if (document) *document = NULL;
+    if (decode) return buildView(str, arena);
+    JsonLazyDocument* lazy = JsonLazyDocument::create(str, arena);
+    JsonAbstractValue* root = (lazy) ? lazy->root() : NULL;
+    if (!root) return buildView(str, arena);
+    if (document) *document = lazy;
+    return root;
+}
+
+/**
+* stream entry point for the builder.  Builds a JsonAbstractValue from JSON text
+* read from the stream.
+* @param in - the stream to read the JSON text from
+* @return A JsonAbstractValue structure that matches the input text
+*/
+JsonAbstractValue *JsonFactory::build(istream &in) {
+    return start(in, NULL);
+}
+
+/**
+* stream arena entry point for the builder.  Builds a JsonAbstractValue from JSON
+* text read from the stream, allocating every node from the specified arena.
+* @param in - the stream to read the JSON text from
+* @param arena - the arena that will own the structure
+* @return A JsonAbstractValue structure that matches the input text.  The structure
+*    is released by resetting the arena.
+*/
+JsonAbstractValue *JsonFactory::build(istream &in, JsonArena &arena) {
+    return start(in, &arena);
+}
+
+/**
+* event entry point for the parser.  Reports the structure of the input buffer to
+* the handler.  The text passed to the handler refers directly into the buffer.
+* @param str - a view of the JSON formatted buffer
+* @param handler - the handler that receives the parsing events
+* @return true if the buffer was parsed successfully, otherwise false
+*/
+bool JsonFactory::parse(string_view str, JsonEventHandler &handler) {
+    this->str = str;
+    input = NULL;
+    strpos = 0;
+    aborted = false;
+
+    // build the structural index for the buffer
+    indexed = index.build(str);
+    cursor = 0;
+
+    // skip leading whitespace and parse the value
+    skipWhitespace();
+    bool result = parser(handler, 0);
+
+    // the input is only referenced for the duration of the parse
+    this->str = string_view();
+    index.clear();
+    indexed = false;
+    return result;
+}
+
+/**
+* stream event entry point for the parser.  Reports the structure of the JSON text
+* read from the stream to the handler.  The stream is read a window at a time so
+* that memory use is bounded by the size of the largest token rather than the
+* size of the document.  The text passed to the handler is only valid for the
+* duration of each call.
+* @param in - the stream to read the JSON text from
+* @param handler - the handler that receives the parsing events
+* @param windowSize - the number of bytes to read from the stream at a time
+* @return true if the stream was parsed successfully, otherwise false
+*/
+bool JsonFactory::parse(istream &in, JsonEventHandler &handler, unsigned long windowSize) {
+    input = &in;
+    this->windowSize = (windowSize) ? windowSize : 65536;
+    window.clear();
+    str = window;
+    strpos = 0;
+    aborted = false;
+
+    // skip leading whitespace and parse the value
+    skipWhitespace();
+    bool result = parser(handler, 0);
+
+    // release the window
+    input = NULL;
+    window.clear();
+    window.shrink_to_fit();
+    str = string_view();
+    return result;
+}
+
+/**
+* open a buffer holding a sequence of json documents.  The documents are built by
+* calling next() until atEnd() returns true.
+* @param str - a view of the buffer.  The buffer must outlive the documents that
+*    are built from it.
+*/
+void JsonFactory::open(string_view str) {
+    this->str = str;
+    input = NULL;
+    strpos = 0;
+    aborted = false;
+    indexed = index.build(str);
+    cursor = 0;
+}
+
+/**
+* open a stream holding a sequence of json documents.  The stream is read a window
+* at a time, and the documents are built by calling next() until atEnd() returns
+* true.
+* @param in - the stream to read the documents from
+* @param windowSize - the number of bytes to read from the stream at a time
+*/
+void JsonFactory::open(istream &in, unsigned long windowSize) {
+    input = &in;
+    this->windowSize = (windowSize) ? windowSize : 65536;
+    window.clear();
+    str = window;
     strpos = 0;
-    return builder();
+    aborted = false;
+    index.clear();
+    indexed = false;
+    cursor = 0;
+}
+
+/**
+* test for the end of the input opened by open().
+* @return true if only whitespace remains, otherwise false
+*/
+bool JsonFactory::atEnd() {
+    skipWhitespace();
+    return !more();
 }
 
 /*
-* helper class to build the JsonAbstractValue
+* helper function that builds the next document of the input opened by open().
+* Buffers are built in place, stream windows are reused so their text is copied.
 */
-JsonAbstractValue * JsonFactory::builder() {
-    if (str == "") return NULL;
+JsonAbstractValue *JsonFactory::nextDocument(JsonArena* arena) {
+    skipWhitespace();
+    if (!more()) return NULL;
+    aborted = false;
+    char c = str[strpos];
+    if ((c == '{') || (c == '[') || (c == '"')) {
+        JsonDomBuilder builder(arena, input == NULL, decode);
+        singleLine = delimited;
+        bool ok = parser(builder, 0);
+        singleLine = false;
+        if (ok) return builder.release();
+    } else {
+        cerr << "json document expected at " << strpos << endl;
+    }
 
-    if (str[strpos] == '[') {
-        // here if the string represents a json array
-        strpos++;
-        skipWhitespace();
+    // skip the rest of the line containing the error.  The structural index
+    // may pair the quotes of the rest of the text differently from the parser
+    // once a string has been left unterminated, so the rest is scanned.
+    while ((more()) && (str[strpos] != '\n')) strpos++;
+    indexed = false;
+    return NULL;
+}
 
-        // here if we need to create a value set (json array)
-        JsonArray *cs = new JsonArray();
+/**
+* build the next document of the input opened by open().
+* @return A JsonAbstractValue structure that matches the document, or NULL if there
+*    are no more documents or the document is badly formed
+*/
+JsonAbstractValue *JsonFactory::next() {
+    return nextDocument(NULL);
+}
 
-        while (strpos < str.length()) {
-            // check for special case of empty array
-            skipWhitespace();
-            if (strpos >= str.length()) {
-                cerr<<"unexpected end of string"<<endl;
-                return NULL;
-            }
-            if (str[strpos] == ']') {
-                break;
-            }
+/**
+* build the next document of the input opened by open(), allocating every node
+* from the specified arena.  Resetting the arena between documents allows its
+* memory to be reused.
+* @param arena - the arena that will own the structure
+* @return A JsonAbstractValue structure that matches the document, or NULL if there
+*    are no more documents or the document is badly formed
+*/
+JsonAbstractValue *JsonFactory::next(JsonArena &arena) {
+    return nextDocument(&arena);
+}
 
-            // create and build the object or string
-            JsonAbstractValue* obj = builder();
-            
-            if (obj == NULL) {
-                cerr<<"Unexpected null object at "<<strpos<<endl;
-                cerr<<str.substr(strpos,160)<<endl;
-                return NULL;
-            }
-            cs->add(obj);
+/**
+* release the input opened by open().
+*/
+void JsonFactory::close() {
+    input = NULL;
+    window.clear();
+    window.shrink_to_fit();
+    str = string_view();
+    index.clear();
+    indexed = false;
+}
 
-            // next character should either be a comma or an end brace
-            skipWhitespace();
-            if (strpos >= str.length()) {
-                cerr<<"unexpected end of string"<<endl;
-                return NULL;
-            }
-            if (str[strpos] == ']') break;
-            if (str[strpos] == ',') strpos++;
-            skipWhitespace();
-        }
+/*
+* helper function that parses a single array element on a worker thread.  The
+* slice holds the text of the element followed by its delimiter, and the parse
+* only succeeds if the element ends exactly at the delimiter.
+*/
+bool JsonFactory::parseSlice(string_view slice, JsonEventHandler &handler) {
+    str = slice;
+    input = NULL;
+    strpos = 0;
+    aborted = false;
+    indexed = index.build(slice);
+    cursor = 0;
+
+    skipWhitespace();
+    bool result = parser(handler, 2);
+    if (result) {
         skipWhitespace();
-        if (str[strpos] != ']') {
-            cerr<<"']' expected but none found at " << strpos<<endl;
-            return NULL;
-        }
-        strpos++;
-        return cs;
+        result = (strpos + 1 == slice.length());
     }
 
-    if (str[strpos] == '{') {
-        // here if we need to create a json object
-        strpos++;
-        JsonObject *co = new JsonObject();
+    str = string_view();
+    indexed = false;
+    return result;
+}
 
-        skipWhitespace();
+/*
+* thread entry point that builds a range of array elements.  Each element is
+* built separately so that it can be added to the array by the calling thread.
+*/
+void JsonFactory::parseElements(ParallelJob* job) {
+    JsonFactory factory;
+    const vector<unsigned long>& bounds = *job->bounds;
+    job->ok = true;
+    for (unsigned long i = job->first; i < job->last; i++) {
+        unsigned long begin = bounds[2*i];
+        unsigned long end = bounds[2*i + 1];
+        JsonDomBuilder builder(job->arena, job->borrow, job->decode);
+        if (!factory.parseSlice(job->text.substr(begin, end - begin + 1), builder)) {
+            job->ok = false;
+            return;
+        }
+        job->values.push_back(builder.release());
+    }
+}
+
+/*
+* helper function that builds a large array by parsing its elements on several
+* threads.  The structural index is used to find the commas that separate the
+* elements, each thread builds a contiguous range of the elements, and the
+* results are then added to the array in order.  Returns false, without
+* consuming any text, if the array should be parsed on this thread instead.
+* Only an array that is the outermost value, or a field of the outermost object
+* (top is true), is split between threads.
+*/
+bool JsonFactory::parallelArray(bool top) {
+    if ((!dom) || (!indexed) || (threads < 2) || (!top) || (singleLine)) return false;
+    if (str.length() - strpos < parallelSize) return false;
+    if ((!seek()) || (index[cursor] != strpos)) return false;
 
-        // check for an empty object.
-        if ((strpos < str.length() + 1) && (str[strpos] == '}')) {
-            strpos += 2;
-            return co;
+    // find the start and delimiter of each element
+    vector<unsigned long> bounds;
+    unsigned long level = 0;
+    unsigned long begin = strpos + 1;
+    unsigned long close = 0;
+    for (unsigned long next = cursor; next < index.size(); next++) {
+        unsigned long pos = index[next];
+        char c = str[pos];
+        if ((c == '[') || (c == '{')) {
+            level++;
+        } else if ((c == ']') || (c == '}')) {
+            if (--level > 0) continue;
+            if (c != ']') return false;
+            bounds.push_back(begin);
+            bounds.push_back(pos);
+            close = pos;
+            break;
+        } else if ((c == ',') && (level == 1)) {
+            bounds.push_back(begin);
+            bounds.push_back(pos);
+            begin = pos + 1;
         }
+    }
+    if ((!close) || (close - strpos < parallelSize)) return false;
 
-        while (strpos < str.length()) {
-            string key = getstring();
-            if (key == "") return NULL;
-            if (strpos >= str.length()) {
-                cerr<<"unexpected end of string"<<endl;
-                return NULL;
-            }
+    // empty arrays and empty elements are left to the sequential parser
+    unsigned long count = bounds.size() / 2;
+    for (unsigned long i = 0; i < count; i++) {
+        if (JsonStructuralIndex::skipWhitespace(str, bounds[2*i]) >= bounds[2*i + 1]) return false;
+    }
 
-            skipWhitespace();
-            if (str[strpos] != ':') {
-                cerr<<"keyword separator expected.  None found"<<endl;
-                return NULL;
-            }
-            strpos++;
+    // divide the elements into ranges of roughly equal size
+    unsigned long workers = (threads < count) ? threads : count;
+    vector<ParallelJob> jobs(workers);
+    unsigned long share = (close - strpos) / workers + 1;
+    unsigned long element = 0;
+    for (unsigned long j = 0; j < workers; j++) {
+        ParallelJob& job = jobs[j];
+        job.text = str;
+        job.bounds = &bounds;
+        job.first = element;
+        unsigned long limit = strpos + share * (j + 1);
+        while ((element < count) && ((bounds[2*element] < limit) || (element == job.first))) element++;
+        if (j == workers - 1) element = count;
+        job.last = element;
+        job.arena = (dom->getArena()) ? new JsonArena() : NULL;
+        job.borrow = dom->getBorrow();
+        job.decode = dom->getDecode();
+        job.ok = false;
+    }
 
-            // create and build the value
-            skipWhitespace();
-            JsonAbstractValue *obj = builder();
-            if (obj == NULL) return NULL;
-            co->put(key, obj);
+    // the calling thread parses the first range
+    vector<thread> pool;
+    for (unsigned long j = 1; j < workers; j++) {
+        try {
+            pool.push_back(thread(parseElements, &jobs[j]));
+        } catch (...) {
+            parseElements(&jobs[j]);
+        }
+    }
+    parseElements(&jobs[0]);
+    for (unsigned long j = 0; j < pool.size(); j++) pool[j].join();
 
-            // next character should either be a comma or an end brace
-            skipWhitespace();
-            if (strpos >= str.length()) {
-                cerr<<"Unexpected end of string"<<endl;
-                return NULL;
+    // discard the results if any element could not be parsed
+    bool ok = true;
+    for (unsigned long j = 0; j < workers; j++) ok = ok && jobs[j].ok;
+    if (!ok) {
+        for (unsigned long j = 0; j < workers; j++) {
+            if (jobs[j].arena) {
+                delete jobs[j].arena;
+            } else {
+                for (unsigned long i = 0; i < jobs[j].values.size(); i++) delete jobs[j].values[i];
             }
-            if (str[strpos] == '}') break;
-            if (str[strpos] == ',') strpos++;
-            skipWhitespace();
         }
-        skipWhitespace();
-        if (str[strpos] != '}') {
-            cerr<<"Missing closing curly brace at "<<strpos<<endl;
-            cerr<<str.substr(strpos,160)<<endl;
-            return NULL;
-        }
-        strpos++;
-        return co;
+        return false;
     }
 
-    // here if the line is a value primitive
-    if (str[strpos] == '"') {
-        string s = getstring();
-        //if (s == "") {
-        //    cerr<<"Null string returned"<<endl;
-        //    return NULL;
-        //}
-        JsonValue *cv = new JsonValue(s);
-        skipWhitespace();
-        return cv;
+    // add the elements to the array in order
+    dom->startArray();
+    dom->reserve(count);
+    for (unsigned long j = 0; j < workers; j++) {
+        for (unsigned long i = 0; i < jobs[j].values.size(); i++) dom->value(jobs[j].values[i]);
+        if (jobs[j].arena) dom->getArena()->adopt(jobs[j].arena);
+    }
+    dom->endArray();
+    strpos = close + 1;
+    return true;
+}
+
+/*
+* helper function used by parser to read the key of the next field of the current
+* object, and the separator that follows it.
+*/
+bool JsonFactory::parseKey(JsonEventHandler &handler) {
+    // the key is reported before any more text is read so that
+    // the window is not moved while the key is in use
+    string_view key;
+    if ((!getstring(key)) || (key.empty())) return false;
+    if (!handler.key(key)) return stop();
+    if (!more()) {
+        cerr<<"unexpected end of string"<<endl;
+        return false;
     }
 
-    // here if the value primitive is not quoted
-    string s = getRaw();
-    if (s == "") {
-        cerr << "Null raw value returned" << endl;
-        cerr << str.substr(strpos,160);
-        return NULL;
+    skipWhitespace();
+    if ((!more()) || (str[strpos] != ':')) {
+        cerr<<"keyword separator expected.  None found"<<endl;
+        return false;
     }
-    JsonValue *cv = new JsonValue(s);
+    strpos++;
     skipWhitespace();
-    return cv;
+    return true;
 }
 
+/*
+* helper function to parse a value and report it to the handler.  The depth is
+* the number of containers that enclose the value.  The parser is iterative - the
+* containers that are open are held on the nesting stack rather than the call
+* stack, so the depth of the document is only limited by available memory.
+*/
+bool JsonFactory::parser(JsonEventHandler &handler, unsigned int depth) {
+    nesting.clear();
+    bool expectValue = true;
+    while (true) {
+        if (expectValue) {
+            // parse the next value
+            if (!more()) {
+                if ((!nesting.empty()) && (nesting.back() == '[')) {
+                    cerr<<"Unexpected null object at "<<strpos<<endl;
+                }
+                return false;
+            }
+            char c = str[strpos];
+            if (c == '[') {
+                // here if the string represents a json array
+                bool top = (depth == 0) &&
+                    ((nesting.empty()) || ((nesting.size() == 1) && (nesting.back() == '{')));
+                if (!parallelArray(top)) {
+                    strpos++;
+                    skipWhitespace();
+                    if (!handler.startArray()) return stop();
+                    if (!more()) {
+                        cerr<<"']' expected but none found at " << strpos<<endl;
+                        return false;
+                    }
+                    if (str[strpos] != ']') {
+                        nesting.push_back('[');
+                        continue;
+                    }
+                    // here if the array is empty
+                    strpos++;
+                    if (!handler.endArray()) return stop();
+                }
+            } else if (c == '{') {
+                // here if the string represents a json object
+                strpos++;
+                if (!handler.startObject()) return stop();
+                skipWhitespace();
+                if (!more()) {
+                    cerr<<"Missing closing curly brace at "<<strpos<<endl;
+                    return false;
+                }
+                if (str[strpos] != '}') {
+                    nesting.push_back('{');
+                    if (!parseKey(handler)) return false;
+                    continue;
+                }
+                // here if the object is empty
+                strpos++;
+                if (!handler.endObject()) return stop();
+            } else if (c == '"') {
+                // here if the value primitive is quoted
+                string_view s;
+                if (!getstring(s)) {
+                    cerr<<"unterminated string at "<<strpos<<endl;
+                    return false;
+                }
+                if (!handler.scalar(s, true)) return stop();
+            } else {
+                // here if the value primitive is not quoted
+                string_view s = getRaw();
+                if (s.empty()) {
+                    cerr << "Null raw value returned" << endl;
+                    if (strpos < str.length()) cerr << str.substr(strpos,160);
+                    if ((!aborted) && (!nesting.empty()) && (nesting.back() == '[')) {
+                        cerr<<"Unexpected null object at "<<strpos<<endl;
+                        if (strpos < str.length()) cerr<<str.substr(strpos,160)<<endl;
+                    }
+                    return false;
+                }
+                if (!handler.scalar(s, false)) return stop();
+            }
+        }
+
+        // here when a value is complete
+        skipWhitespace();
+        if (nesting.empty()) return true;
+        if (!more()) {
+            cerr<<"unexpected end of string"<<endl;
+            return false;
+        }
+        if (nesting.back() == '[') {
+            // next character should either be a comma or an end bracket.  A
+            // comma before the end bracket is ignored.
+            if (str[strpos] == ',') {
+                strpos++;
+                skipWhitespace();
+                if (!more()) {
+                    cerr<<"']' expected but none found at " << strpos<<endl;
+                    return false;
+                }
+            }
+            expectValue = (str[strpos] != ']');
+            if (expectValue) continue;
+            strpos++;
+            nesting.pop_back();
+            if (!handler.endArray()) return stop();
+            continue;
+        }
+
+        // next character should either be a comma or an end brace
+        expectValue = (str[strpos] != '}');
+        if (expectValue) {
+            if (str[strpos] == ',') strpos++;
+            skipWhitespace();
+            if (!more()) {
+                cerr<<"Missing closing curly brace at "<<strpos<<endl;
+                return false;
+            }
+            if (!parseKey(handler)) return false;
+            continue;
+        }
+        strpos++;
+        nesting.pop_back();
+        if (!handler.endObject()) return stop();
+    }
+}
@@ -0,0 +1,54 @@
+//*******************************************************************
+//    JsonHash.cpp
+//
+//    This file provides implementation for the functions used to
+//    compute the structural hashes of JSON values.  This file is
+//    intended to be used as part of the PICMG IoT library reference
+//    code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include "JsonHash.h"
+
+//*******************************************************************
+// bytes()
+//
+// hash a sequence of bytes.  The bytes are read eight at a time in
+// little-endian order so that the hash does not depend on the byte
+// order of the processor.
+//
+// parameters:
+//    str - the bytes to hash
+//    seed - the seed for the hash
+// returns:
+//    the hash of the bytes
+uint64_t JsonHash::bytes(string_view str, uint64_t seed) {
+    uint64_t hash = mix(seed ^ (str.length() * 0x9e3779b97f4a7c15ULL));
+    const unsigned char* data = (const unsigned char*)str.data();
+    unsigned long pos = 0;
+    while (pos < str.length()) {
+        uint64_t word = 0;
+        unsigned long count = (str.length() - pos < 8) ? str.length() - pos : 8;
+        for (unsigned long i = 0; i < count; i++) word |= ((uint64_t)data[pos + i]) << (8 * i);
+        hash = mix(hash ^ word) + 0x9e3779b97f4a7c15ULL;
+        pos += count;
+    }
+    return mix(hash);
+}
@@ -0,0 +1,62 @@
+//*******************************************************************
+//    JsonKey.cpp
+//
+//    This file provides implementation for a class that represents a
+//    resolved JSON object key.  This file is intended to be used as
+//    part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include "JsonKey.h"
+
+//*******************************************************************
+// JsonKey()
+//
+// default constructor - the key is empty.
+JsonKey::JsonKey() : hash(hashKey(string_view())) {
+}
+
+//*******************************************************************
+// JsonKey()
+//
+// Initialization constructor - resolve the specified key text.
+//
+// parameters:
+//    key - the key text
+JsonKey::JsonKey(string_view key) : text(key), hash(hashKey(key)) {
+}
+
+//*******************************************************************
+// hashKey()
+//
+// compute a hash of key text (FNV-1a).
+//
+// parameters:
+//   key - the key text to hash
+// returns:
+//   the hash of the key
+unsigned long JsonKey::hashKey(string_view key) {
+    unsigned long long hash = 14695981039346656037ULL;
+    for (unsigned long i = 0; i < key.length(); i++) {
+        hash ^= (unsigned char)key[i];
+        hash *= 1099511628211ULL;
+    }
+    return (unsigned long)hash;
+}
@@ -0,0 +1,276 @@
+//*******************************************************************
+//    JsonLazyDocument.cpp
+//
+//    This file provides implementation for a class that builds JSON
+//    structures on demand from a structural index of the text.  This
+//    file is intended to be used as part of the PICMG IoT library
+//    reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <iostream>
+#include <vector>
+#include "JsonLazyDocument.h"
+#include "JsonStructuralIndex.h"
+
+//*******************************************************************
+// JsonLazyDocument()
+//
+// constructor.
+//
+// parameters:
+//    text - the text of the document.  The text must outlive the
+//       document and any structure built from it.
+//    positions - the positions of the structural characters
+//    match - the entry of the closing bracket for each opening bracket
+//    count - the number of structural characters
+//    arena - the arena that the document and its structure are
+//       allocated from
+JsonLazyDocument::JsonLazyDocument(string_view text, const uint32_t* positions,
+    const uint32_t* match, unsigned long count, JsonArena* arena) :
+    text(text), positions(positions), match(match), count(count), arena(arena),
+    failed(false)
+{
+}
+
+//*******************************************************************
+// create()
+//
+// index the structural characters of the text and allocate a document
+// for it.  The index, and the entry of the closing bracket that matches
+// each opening bracket, are held in the arena.
+//
+// parameters:
+//    text - the text of the document.  The text must outlive the
+//       document and any structure built from it.
+//    arena - the arena to allocate the document from
+// returns:
+//    a pointer to the document, or NULL if the text could not be indexed
+//    or its brackets are not balanced
+JsonLazyDocument* JsonLazyDocument::create(string_view text, JsonArena& arena) {
+    JsonStructuralIndex index;
+    if (!index.build(text)) return NULL;
+
+    unsigned long count = index.size();
+    uint32_t* positions = (uint32_t*)arena.allocate((count + 1) * sizeof(uint32_t), alignof(uint32_t));
+    uint32_t* match = (uint32_t*)arena.allocate((count + 1) * sizeof(uint32_t), alignof(uint32_t));
+    vector<unsigned long> open;
+    for (unsigned long i = 0; i < count; i++) {
+        positions[i] = index[i];
+        match[i] = 0;
+        char c = text[positions[i]];
+        if ((c == '{') || (c == '[')) {
+            open.push_back(i);
+        } else if ((c == '}') || (c == ']')) {
+            if (open.empty()) return NULL;
+            if (text[positions[open.back()]] != ((c == '}') ? '{' : '[')) return NULL;
+            match[open.back()] = (uint32_t)i;
+            open.pop_back();
+        }
+    }
+    if (!open.empty()) return NULL;
+    return arena.make<JsonLazyDocument>(text, positions, match, count, &arena);
+}
+
+//*******************************************************************
+// root()
+//
+// return the outermost object or array of the document.  Its contents
+// are read when they are first used.
+//
+// parameters:
+//    none
+// returns:
+//    a pointer to the outermost value, or NULL if the document does not
+//    start with an object or array
+JsonAbstractValue* JsonLazyDocument::root() {
+    if ((count == 0) || (positions[0] != JsonStructuralIndex::skipWhitespace(text, 0))) return NULL;
+    if (at(0) == '{') {
+        JsonObject* obj = arena->make<JsonObject>(arena);
+        obj->defer(this, 0);
+        return obj;
+    }
+    if (at(0) == '[') {
+        JsonArray* ary = arena->make<JsonArray>(arena);
+        ary->defer(this, 0);
+        return ary;
+    }
+    return NULL;
+}
+
+//*******************************************************************
+// error()
+//
+// report a badly formed document and record the error so that it can
+// be checked by hasError().
+//
+// parameters:
+//    pos - the position within the text where the error was found
+// returns:
+//    false
+bool JsonLazyDocument::error(unsigned long pos) {
+    failed = true;
+    cerr << "Unexpected character in json text at " << pos << endl;
+    if (pos < text.length()) cerr << text.substr(pos, 160) << endl;
+    return false;
+}
+
+//*******************************************************************
+// value()
+//
+// build the value that starts at the specified position.  Objects and
+// arrays are created empty and read their contents when first used.
+// Quoted and unquoted values refer directly to the text.
+//
+// parameters:
+//    entry - the first index entry at or after the start of the value.
+//       On return, the entry of the delimiter that follows the value.
+//    start - the position within the text where the value starts
+//       (before any leading whitespace)
+// returns:
+//    a pointer to the new value, or NULL if the value is badly formed
+JsonAbstractValue* JsonLazyDocument::value(unsigned long& entry, unsigned long start) {
+    unsigned long pos = JsonStructuralIndex::skipWhitespace(text, start);
+    if (positions[entry] != pos) {
+        // here if the value primitive is not quoted - it ends at the
+        // next delimiter
+        char c = at(entry);
+        if ((c != ',') && (c != '}') && (c != ']')) {
+            error(positions[entry]);
+            return NULL;
+        }
+        return arena->make<JsonValue>(text.substr(pos, positions[entry] - pos), true, false);
+    }
+
+    JsonAbstractValue* result = NULL;
+    char c = at(entry);
+    if (c == '{') {
+        JsonObject* obj = arena->make<JsonObject>(arena);
+        obj->defer(this, entry);
+        entry = match[entry];
+        result = obj;
+    } else if (c == '[') {
+        JsonArray* ary = arena->make<JsonArray>(arena);
+        ary->defer(this, entry);
+        entry = match[entry];
+        result = ary;
+    } else if (c == '"') {
+        entry++;
+        result = arena->make<JsonValue>(text.substr(pos + 1, positions[entry] - pos - 1), true, true);
+    } else {
+        cerr << "Null raw value returned" << endl;
+        error(pos);
+        return NULL;
+    }
+
+    // only whitespace may separate the value from the next delimiter
+    entry++;
+    if (JsonStructuralIndex::skipWhitespace(text, positions[entry - 1] + 1) != positions[entry]) {
+        error(positions[entry - 1] + 1);
+        return NULL;
+    }
+    return result;
+}
+
+//*******************************************************************
+// expand()
+//
+// read the fields of an object from the text.  Fields that are objects
+// or arrays are added unread.  If the text is badly formed, the error
+// is reported and recorded on the document, and the object is left
+// with the fields read so far (which the caller discards).
+//
+// parameters:
+//    obj - the object to add the fields to
+//    entry - the entry of the opening brace within the index
+// returns:
+//    true if the fields were read, otherwise false
+bool JsonLazyDocument::expand(JsonObject* obj, unsigned long entry) {
+    unsigned long end = match[entry];
+    unsigned long start = positions[entry] + 1;
+    unsigned long i = entry + 1;
+
+    // check for an empty object
+    if ((i == end) && (JsonStructuralIndex::skipWhitespace(text, start) == positions[end])) return true;
+
+    while (i < end) {
+        // the key is the text between the next pair of quotes
+        if ((at(i) != '"') || (JsonStructuralIndex::skipWhitespace(text, start) != positions[i])) {
+            return error(start);
+        }
+        string_view key = text.substr(positions[i] + 1, positions[i + 1] - positions[i] - 1);
+        if (key.empty()) return error(positions[i]);
+        i += 2;
+
+        // the key is followed by the separator
+        if ((at(i) != ':') || (JsonStructuralIndex::skipWhitespace(text, positions[i - 1] + 1) != positions[i])) {
+            cerr << "keyword separator expected.  None found" << endl;
+            return error(positions[i - 1] + 1);
+        }
+        i++;
+
+        // parse the value
+        JsonAbstractValue* val = value(i, positions[i - 1] + 1);
+        if (!val) return false;
+        obj->put(key, val);
+
+        // next should either be a comma or the end brace
+        if (i == end) return true;
+        if (at(i) != ',') return error(positions[i]);
+        start = positions[i++] + 1;
+    }
+    return error(positions[end]);
+}
+
+//*******************************************************************
+// expand()
+//
+// read the elements of an array from the text.  Elements that are
+// objects or arrays are added unread.  If the text is badly formed,
+// the error is reported and recorded on the document, and the array
+// is left with the elements read so far (which the caller discards).
+//
+// parameters:
+//    ary - the array to add the elements to
+//    entry - the entry of the opening bracket within the index
+// returns:
+//    true if the elements were read, otherwise false
+bool JsonLazyDocument::expand(JsonArray* ary, unsigned long entry) {
+    unsigned long end = match[entry];
+    unsigned long start = positions[entry] + 1;
+    unsigned long i = entry + 1;
+
+    // check for an empty array
+    if ((i == end) && (JsonStructuralIndex::skipWhitespace(text, start) == positions[end])) return true;
+
+    while (i <= end) {
+        JsonAbstractValue* val = value(i, start);
+        if (!val) return false;
+        ary->add(val);
+
+        // next should either be a comma or the end bracket.  As with the
+        // JsonFactory parser, a comma before the end bracket is ignored.
+        if (i == end) return true;
+        if (at(i) != ',') return error(positions[i]);
+        start = positions[i++] + 1;
+        if ((i == end) && (JsonStructuralIndex::skipWhitespace(text, start) == positions[end])) return true;
+    }
+    return error(positions[end]);
+}
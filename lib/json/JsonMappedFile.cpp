@@ -0,0 +1,141 @@
+//*******************************************************************
+//    JsonMappedFile.cpp
+//
+//    This file provides implementation for a class that maps a JSON
+//    file into memory so that it can be parsed in-place by the
+//    JsonFactory without being copied.  On POSIX systems the file is
+//    memory-mapped, on other systems it is read into a single buffer.
+//    This file is intended to be used as part of the PICMG IoT
+//    library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <fstream>
+#include "JsonMappedFile.h"
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//*******************************************************************
+// JsonMappedFile()
+//
+// default constructor.
+JsonMappedFile::JsonMappedFile() : buffer(NULL), length(0), mapped(false) {
+}
+
+//*******************************************************************
+// ~JsonMappedFile()
+//
+// destructor - release the file contents.
+JsonMappedFile::~JsonMappedFile() {
+    close();
+}
+
+//*******************************************************************
+// open()
+//
+// map the contents of the specified file into memory.  Any previously
+// opened file is closed first.
+//
+// parameters:
+//    filename - the name of the file to open
+// returns:
+//    true if the file was opened, otherwise false
+bool JsonMappedFile::open(string filename) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    length = st.st_size;
+    if (length == 0) {
+        // zero-length files cannot be mapped
+        ::close(fd);
+        buffer = "";
+        return true;
+    }
+    void* addr = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        length = 0;
+        return false;
+    }
+    madvise(addr, length, MADV_SEQUENTIAL);
+    buffer = (const char*)addr;
+    mapped = true;
+    return true;
+#else
+    ifstream jsonfile(filename, std::ifstream::binary);
+    if (!jsonfile.is_open()) return false;
+
+    // get the length of the file
+    jsonfile.seekg(0, jsonfile.end);
+    length = (unsigned long)jsonfile.tellg();
+    jsonfile.seekg(0, jsonfile.beg);
+
+    // read the file into a buffer that is large enough to hold it
+    char* data = new char[length + 1];
+    jsonfile.read(data, length);
+    data[length] = 0;
+    buffer = data;
+    return true;
+#endif
+}
+
+//*******************************************************************
+// close()
+//
+// release the file contents.  Any views into the file become invalid.
+//
+// parameters:
+//    none
+// returns:
+//    void
+void JsonMappedFile::close() {
+#ifndef _WIN32
+    if (mapped) munmap((void*)buffer, length);
+#else
+    delete[] buffer;
+#endif
+    buffer = NULL;
+    length = 0;
+    mapped = false;
+}
+
+//*******************************************************************
+// view()
+//
+// return a view of the file contents.
+//
+// parameters:
+//    none
+// returns:
+//    a view of the file contents or an empty view if no file is open
+string_view JsonMappedFile::view() const {
+    if (!buffer) return string_view();
+    return string_view(buffer, length);
+}
@@ -25,38 +25,121 @@
 //    You should have received a copy of the GNU General Public License
 //    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
+#include <cstring>
 #include "JsonObject.h"
+#include "JsonHash.h"
+#include "JsonSerializer.h"
+
+// objects with more fields than this maintain a hash index
+#define SMALL_OBJECT_SIZE 8
 
 //*******************************************************************
 // JsonObject()
 //
 // default constructor.
-JsonObject::JsonObject() {
+JsonObject::JsonObject() : arena(NULL), pending(NULL), pendingEntry(0) {
+}
+
+//*******************************************************************
+// JsonObject()
+//
+// arena constructor - the object and its contents are allocated from
+// the specified arena.  Objects owned by an arena are released when
+// the arena is reset and must not be deleted.
+//
+// parameters:
+//    arena - the arena that owns the object (or NULL for the heap)
+JsonObject::JsonObject(JsonArena* arena) :
+    arena(arena),
+    entries(JsonArena::resource(arena)),
+    index(JsonArena::resource(arena)),
+    pending(NULL),
+    pendingEntry(0)
+{
 }
 
 //*******************************************************************
 // JsonObject()
 //
-// Copy constructor - initialize this object as a deep clone of the 
-// specified object.
+// Copy constructor - initialize this object as a copy of the specified
+// object.  The values and key text of a heap allocated object are
+// shared with the copy rather than cloned, so the copy makes only two
+// allocations - its entries and its hash index.  The values of an
+// arena allocated object are cloned since they are released with the
+// arena.
 // 
 // parameters:
 //    val - a reference of the object to clone.
-JsonObject::JsonObject(const JsonObject &obj) {
-    // iterate through each element in the internal_map
-    for (jsonmap::iterator it = internal_map.begin(); it != internal_map.end(); ++it) {
-        string key = it->first;
-        JsonAbstractValue &value = *(it->second);
-        
-        // erase exsiting entry if it exists (this shouldnt happen)
-        jsonmap::iterator it2 = internal_map.find(key);
-        if (it2 != internal_map.end()) {
-            delete it2->second;
-            internal_map.erase(it2);
-        }
-        // add the new entry
-        internal_map.insert(pair<string, JsonAbstractValue*>(key,it->second->copy()));
+JsonObject::JsonObject(const JsonObject &obj) : JsonAbstractValue(obj), arena(NULL), pending(NULL), pendingEntry(0) {
+    const_cast<JsonObject&>(obj).load();
+    entries.reserve(obj.entries.size());
+    for (jsonentries::const_iterator it = obj.entries.begin(); it != obj.entries.end(); ++it) {
+        JsonAbstractValue* value = (obj.arena) ? it->value->copy() : it->value->share();
+        Entry entry = { (obj.arena) ? storeKey(it->key) : shareKey(it->key), value, it->hash };
+        entries.push_back(entry);
     }
+    // the entries are in the same order, so the index still applies
+    index.assign(obj.index.begin(), obj.index.end());
+}
+
+//*******************************************************************
+// JsonObject()
+//
+// Move constructor - initialize this object with the fields of the
+// specified object, which is left empty.  The new object is allocated
+// in the same way as the original.
+// 
+// parameters:
+//    obj - a reference of the object to move from.
+JsonObject::JsonObject(JsonObject &&obj) :
+    arena(obj.arena),
+    entries(std::move(obj.entries)),
+    index(std::move(obj.index)),
+    pending(obj.pending),
+    pendingEntry(obj.pendingEntry)
+{
+    obj.entries.clear();
+    obj.index.clear();
+    obj.pending = NULL;
+    obj.touch();
+}
+
+//*******************************************************************
+// operator=()
+//
+// Move assignment operator - replace the fields of this object with
+// the fields of the specified object, which is left empty.  If the
+// objects are not allocated in the same way, the values are moved one
+// at a time.  Values moved into an arena-owned object are cloned into
+// its arena, values moved out of an arena-owned object are copied to
+// the heap, and the values of a heap allocated object are moved into
+// another heap allocated object without being copied.
+// 
+// parameters:
+//    obj - a reference of the object to move from.
+JsonObject& JsonObject::operator=(JsonObject &&obj) {
+    if ((this == &obj) || (!modifiable("JsonObject")) || (!obj.modifiable("JsonObject"))) return *this;
+    clear();
+    obj.touch();
+    if (arena == obj.arena) {
+        // an object that has not been read yet can be moved unread
+        pending = obj.pending;
+        pendingEntry = obj.pendingEntry;
+        obj.pending = NULL;
+        entries.swap(obj.entries);
+        index.swap(obj.index);
+        return *this;
+    }
+    obj.load();
+    entries.reserve(obj.entries.size());
+    for (jsonentries::iterator it = obj.entries.begin(); it != obj.entries.end(); ++it) {
+        JsonAbstractValue* value = (arena) ? it->value->clone(arena) : it->value->copy();
+        Entry entry = { storeKey(it->key), value, it->hash };
+        entries.push_back(entry);
+    }
+    if (entries.size() > SMALL_OBJECT_SIZE) rebuildIndex();
+    obj.clear();
+    return *this;
 }
 
 //*******************************************************************
@@ -64,60 +147,389 @@ JsonObject::JsonObject(const JsonObject &obj) {
 //
 // destructor - deallocate any memory associated with this object.
 JsonObject::~JsonObject() {
-    for (jsonmap::iterator it = internal_map.begin(); it != internal_map.end(); ++it)
-        delete it->second;
+    releaseEntries();
+    if (!arena) noteModified();
+}
+
+//*******************************************************************
+// storeKey()
+//
+// store the text of a key for a new entry.  The keys of an arena-owned
+// object are interned by the arena.  The key text of a heap allocated
+// object is held in a block that starts with a count of the objects
+// that use it, so that copies of the object can share it.
+// 
+// parameters:
+//    key - the key text
+// returns:
+//    a view of the stored key text
+string_view JsonObject::storeKey(string_view key) {
+    if (arena) return arena->intern(key);
+    char* block = (char*)::operator new(sizeof(KeyCount) + key.length());
+    new (block) KeyCount(1);
+    char* text = block + sizeof(KeyCount);
+    if (!key.empty()) memcpy(text, key.data(), key.length());
+    return string_view(text, key.length());
+}
+
+//*******************************************************************
+// shareKey()
+//
+// record another use of the text of a key stored by a heap allocated
+// object with storeKey().
+// 
+// parameters:
+//    key - the stored key text
+// returns:
+//    the key text
+string_view JsonObject::shareKey(string_view key) {
+    ((KeyCount*)(key.data() - sizeof(KeyCount)))->fetch_add(1, memory_order_relaxed);
+    return key;
+}
+
+//*******************************************************************
+// releaseKey()
+//
+// release the text of a key that was stored with storeKey().  The
+// text is deleted once no object uses it.
+// 
+// parameters:
+//    key - the stored key text
+// returns:
+//    void
+void JsonObject::releaseKey(string_view key) {
+    if (arena) return;
+    KeyCount* count = (KeyCount*)(key.data() - sizeof(KeyCount));
+    if (count->fetch_sub(1, memory_order_acq_rel) != 1) return;
+    count->~KeyCount();
+    ::operator delete((void*)count);
+}
+
+//*******************************************************************
+// releaseEntries()
+//
+// release the keys and values of every entry of a heap allocated
+// object.  The entries themselves are left in place.
+// 
+// parameters:
+//    none
+// returns:
+//    void
+void JsonObject::releaseEntries() {
+    if (arena) return;
+    for (jsonentries::iterator it = entries.begin(); it != entries.end(); ++it) {
+        JsonAbstractValue::release(it->value);
+        releaseKey(it->key);
+    }
+}
+
+//*******************************************************************
+// findEntry()
+//
+// find the position of the entry with the specified key.  Small 
+// objects are searched linearly, otherwise the hash index is used.
+// 
+// parameters:
+//    key - the key to search for
+// returns:
+//    the position of the entry within the object, or -1 if not found
+long JsonObject::findEntry(string_view key) {
+    load();
+    if (index.empty()) {
+        for (unsigned long i = 0; i < entries.size(); i++) {
+            if (entries[i].key == key) return i;
+        }
+        return -1;
+    }
+    return findEntry(key, JsonKey::hashKey(key));
+}
+
+//*******************************************************************
+// findEntry()
+//
+// find the position of the entry with the specified key whose hash
+// has already been computed.  The key text is only compared for
+// entries with the same hash.
+// 
+// parameters:
+//    key - the key to search for
+//    hash - the hash of the key text
+// returns:
+//    the position of the entry within the object, or -1 if not found
+long JsonObject::findEntry(string_view key, unsigned long hash) {
+    load();
+    if (index.empty()) {
+        for (unsigned long i = 0; i < entries.size(); i++) {
+            if ((entries[i].hash == hash) && (entries[i].key == key)) return i;
+        }
+        return -1;
+    }
+    unsigned long mask = index.size() - 1;
+    for (unsigned long slot = hash & mask; index[slot]; slot = (slot + 1) & mask) {
+        Entry& entry = entries[index[slot] - 1];
+        if ((entry.hash == hash) && (entry.key == key)) return index[slot] - 1;
+    }
+    return -1;
+}
+
+//*******************************************************************
+// rebuildIndex()
+//
+// rebuild the hash index so that it has room for at least twice the
+// current number of entries.
+// 
+// parameters:
+//    none
+// returns:
+//    void
+void JsonObject::rebuildIndex() {
+    unsigned long capacity = 16;
+    while (capacity < entries.size() * 2) capacity *= 2;
+    index.assign(capacity, 0);
+    unsigned long mask = capacity - 1;
+    for (unsigned long i = 0; i < entries.size(); i++) {
+        unsigned long slot = entries[i].hash & mask;
+        while (index[slot]) slot = (slot + 1) & mask;
+        index[slot] = i + 1;
+    }
 }
 
 //*******************************************************************
 // copy()
 //
-// create a deep clone of this JsonValue and return the result.
+// create a copy of this object and return the result.  The copy
+// shares the values of the object, so only the fields of this object
+// are copied.
 // 
 // parameters:
 //    none
 // returns:
-//    a pointer to a deep clone of the object
+//    a pointer to a copy of the object
 JsonAbstractValue* JsonObject::copy() {
     return (JsonAbstractValue*) new JsonObject(*this);
 }
 
+//*******************************************************************
+// clone()
+//
+// create a deep clone of this object within an arena.
+// 
+// parameters:
+//    arena - the arena to allocate the clone from (or NULL for the heap)
+// returns:
+//    a pointer to a clone of the object
+JsonAbstractValue* JsonObject::clone(JsonArena* arena) {
+    if (!arena) return copy();
+    load();
+    JsonObject* result = arena->make<JsonObject>(arena);
+    result->reserve(entries.size());
+    for (jsonentries::iterator it = entries.begin(); it != entries.end(); ++it) {
+        result->put(it->key, it->hash, it->value->clone(arena));
+    }
+    return result;
+}
+
 //*******************************************************************
 // clear()
 //
-// clear the entire contents of the object.
+// clear the entire contents of the object.  The fields of an object
+// that has not been read yet are discarded without being read.
 // 
 // parameters:
 //    none
 // returns:
 void JsonObject::clear() {
-    for (jsonmap::iterator it = internal_map.begin(); it != internal_map.end(); ++it)
-        delete it->second;
-    internal_map.clear();
+    if (!modifiable("JsonObject")) return;
+    pending = NULL;
+    touch();
+    releaseEntries();
+    entries.clear();
+    index.clear();
 }
 
 //*******************************************************************
 // put()
 //
-// add a new element into the object.
+// add a new element into the object.  The object takes ownership of
+// the value - to add a value that is also held elsewhere, pass a copy
+// or a share() of it.  Values added to an arena-owned object must be
+// allocated from the same arena.  If the object is shared with a copy
+// of the structure, the value is released instead.
 // 
 // parameters:
 //    key - the key to associate the new value with
 //    val - the new value to add
 // returns:
 //    void
-void JsonObject::put(string key, JsonAbstractValue* val) {
-    jsonmap::iterator it2 = internal_map.find(key);
-    if (it2 != internal_map.end()) {
-        delete it2->second;
-        internal_map.erase(it2);
-
-        // add the new entry
-        internal_map.insert(pair<string, JsonAbstractValue*>(key, val));
+void JsonObject::put(string_view key, JsonAbstractValue* val) {
+    put(key, JsonKey::hashKey(key), val);
+}
+
+//*******************************************************************
+// put()
+//
+// add a new element into the object using a key that has already
+// been resolved.  The object takes ownership of the value.
+// 
+// parameters:
+//    key - the key to associate the new value with
+//    val - the new value to add
+// returns:
+//    void
+void JsonObject::put(const JsonKey& key, JsonAbstractValue* val) {
+    put(key.getText(), key.getHash(), val);
+}
+
+//*******************************************************************
+// put()
+//
+// add a new element into the object using a key whose hash has
+// already been computed.  The object takes ownership of the value.
+// 
+// parameters:
+//    key - the key to associate the new value with
+//    hash - the hash of the key text
+//    val - the new value to add
+// returns:
+//    void
+void JsonObject::put(string_view key, unsigned long hash, JsonAbstractValue* val) {
+    if (!modifiable("JsonObject")) {
+        if (!arena) JsonAbstractValue::release(val);
+        return;
     }
-    else {
-        // add the new entry and internal_map index
-        internal_map.insert(pair<string, JsonAbstractValue*>(key, val));
-        index.push_back(key);
+    long pos = findEntry(key, hash);
+    touch();
+    if (pos >= 0) {
+        // replace the existing entry
+        if (!arena) JsonAbstractValue::release(entries[pos].value);
+        entries[pos].value = val;
+        return;
+    }
+
+    // add the new entry
+    Entry entry = { storeKey(key), val, hash };
+    entries.push_back(entry);
+    if (entries.size() <= SMALL_OBJECT_SIZE) return;
+
+    // update the hash index
+    if (index.size() < entries.size() * 2) {
+        rebuildIndex();
+    } else {
+        unsigned long mask = index.size() - 1;
+        unsigned long slot = entry.hash & mask;
+        while (index[slot]) slot = (slot + 1) & mask;
+        index[slot] = entries.size();
+    }
+}
+
+//*******************************************************************
+// put()
+//
+// add a new element into the object, taking ownership of the value
+// from the caller.
+// 
+// parameters:
+//    key - the key to associate the new value with
+//    val - the new value to add
+// returns:
+//    void
+void JsonObject::put(string_view key, unique_ptr<JsonAbstractValue> val) {
+    put(key, val.release());
+}
+
+//*******************************************************************
+// put()
+//
+// add a new element into the object using a key that has already
+// been resolved, taking ownership of the value from the caller.
+// 
+// parameters:
+//    key - the key to associate the new value with
+//    val - the new value to add
+// returns:
+//    void
+void JsonObject::put(const JsonKey& key, unique_ptr<JsonAbstractValue> val) {
+    put(key, val.release());
+}
+
+//*******************************************************************
+// take()
+//
+// remove the field with the specified key from the object and return
+// its value.  The caller becomes the owner of the value (values within
+// an arena are released with the arena).  The order of the remaining
+// fields is preserved.
+// 
+// parameters:
+//    key - the key of the field to remove
+// returns:
+//    the value of the removed field, or NULL if there is no such field
+JsonAbstractValue* JsonObject::take(string_view key) {
+    long pos = findEntry(key);
+    if ((pos < 0) || (!modifiable("JsonObject"))) return NULL;
+    touch();
+    JsonAbstractValue* value = entries[pos].value;
+    releaseKey(entries[pos].key);
+    entries.erase(entries.begin() + pos);
+    if (entries.size() > SMALL_OBJECT_SIZE) {
+        rebuildIndex();
+    } else {
+        index.clear();
+    }
+    return value;
+}
+
+//*******************************************************************
+// remove()
+//
+// remove the field with the specified key from the object and release
+// its value.
+// 
+// parameters:
+//    key - the key of the field to remove
+// returns:
+//    true if the field was removed, false if there is no such field
+bool JsonObject::remove(string_view key) {
+    JsonAbstractValue* value = take(key);
+    if (!value) return false;
+    if (!arena) JsonAbstractValue::release(value);
+    return true;
+}
+
+//*******************************************************************
+// computeHash()
+//
+// compute the structural hash of the object.  The hash of each field
+// combines its key with the hash of its value, and the fields are
+// summed so that their order does not affect the result.  The values
+// of the fields have already been hashed by hash().
+// 
+// parameters:
+//    none
+// returns:
+//    the hash of the object
+uint64_t JsonObject::computeHash() {
+    load();
+    uint64_t sum = 0;
+    for (jsonentries::iterator it = entries.begin(); it != entries.end(); ++it) {
+        sum += JsonHash::combine(JsonHash::bytes(it->key, JsonHash::SEED_KEY), it->value->hash());
+    }
+    return JsonHash::combine(JsonHash::combine(JsonHash::SEED_OBJECT, sum), entries.size());
+}
+
+//*******************************************************************
+// children()
+//
+// add the values of the fields of the object to the list.
+// 
+// parameters:
+//    list - the list to add the values to
+// returns:
+//    void
+void JsonObject::children(vector<JsonAbstractValue*>& list) {
+    load();
+    for (jsonentries::iterator it = entries.begin(); it != entries.end(); ++it) {
+        list.push_back(it->value);
     }
 }
 
@@ -136,26 +548,9 @@ void JsonObject::put(string key, JsonAbstractValue* val) {
 // returns:
 //    void
 void JsonObject::dump(ostream& out, bool pretty, int indent, bool useIndent) {
-    if ((useIndent)&&(pretty))  for (int i = 0;i < indent;i++) out<<" ";
-    out << "{";
-    if (pretty) out<< endl;
-
-    for (jsonmapindex::iterator it = index.begin(); it != index.end(); ++it) {
-        if (pretty) for (int i = 0;i < indent + 3;i++) out<<" ";
-        string key = internal_map.find(it->data())->first;
-        JsonAbstractValue& value = *internal_map.find(it->data())->second;
-
-        out << "\""<<key<<"\":";
-        value.dump(out, pretty, indent + 3,false);
-        jsonmapindex::iterator itnext = it;
-        itnext++;
-        if (itnext != index.end()) {
-            out << ",";
-        }
-        if (pretty) out << endl;
-    }
-    if (pretty) for (int i = 0;i < indent;i++) out<<" ";
-    out<<"}";
+    JsonSerializer serializer(pretty);
+    serializer.write(this, indent, useIndent);
+    serializer.flush(out);
 }
 
 //*******************************************************************
@@ -187,30 +582,49 @@ void JsonObject::dump(ostream& out, bool pretty) {
 //       a string representation of the entire object (not normal)
 // returns:
 //    a string representation of the requested value
-string JsonObject::getValue(string specifier) {
-    if (internal_map.empty()) return "";
+string JsonObject::getValue(string_view specifier) {
+    load();
+    if (entries.empty()) return "";
 
     string result = "";
     if (specifier == "") {
         // The specifier is empty - return values for all records in the
         // object (this should not be normal)
-        for (jsonmap::iterator it = internal_map.begin(); it != internal_map.end(); ++it) {
-            string key = it->first;
-            JsonAbstractValue& value = *(it->second);
+        for (jsonentries::iterator it = entries.begin(); it != entries.end(); ++it) {
             result.append("\"");
-            result.append(key);
+            result.append(it->key);
             result.append("\":");
-            result.append(value.getValue(""));
+            result.append(it->value->getValue(""));
             result.append("\n");
         }
         return result;
     }
     // the specifier as the key
-    jsonmap::iterator it = internal_map.find(specifier);
-    if (it != internal_map.end()) return it->second->getValue("");
+    JsonAbstractValue* value = find(specifier);
+    if (value) return value->getValue("");
     return "";
 }
 
+
+//*******************************************************************
+// getValueView()
+//
+// returns a view of the text of the value associated with the
+// specified key.  No memory is allocated.
+// 
+// parameters:
+//    specifier - the key for the value to return
+// returns:
+//    a view of the requested value text (if found), otherwise an empty
+//    view.  The view is valid for the lifetime of the value.
+string_view JsonObject::getValueView(string_view specifier) {
+    if (specifier.empty()) return string_view();
+
+    // the specifier as the key
+    JsonAbstractValue* value = find(specifier);
+    if (value) return value->getValueView("");
+    return string_view();
+}
     
 //*******************************************************************
 // getBoolean()
@@ -223,13 +637,14 @@ string JsonObject::getValue(string specifier) {
 // returns:
 //    a boolean representation of the requested value (if found), 
 //    otherwise, false
-bool JsonObject::getBoolean(string specifier) {
-    if (internal_map.empty()) return "";
+bool JsonObject::getBoolean(string_view specifier) {
+    load();
+    if (entries.empty()) return false;
     if (specifier == "") return false;
 
     // the specifier as the key
-    jsonmap::iterator it = internal_map.find(specifier);
-    if (it != internal_map.end()) return it->second->getBoolean("");
+    JsonAbstractValue* value = find(specifier);
+    if (value) return value->getBoolean("");
     return false;
 }
 
@@ -245,13 +660,14 @@ bool JsonObject::getBoolean(string specifier) {
 // returns:
 //    a string representation of the requested handle (if found), 
 //    otherwise, an empty string
-string JsonObject::getHandle(string specifier) {
-    if (internal_map.empty()) return "";
+string JsonObject::getHandle(string_view specifier) {
+    load();
+    if (entries.empty()) return "";
     if (specifier == "") return "";
 
     // the specifier as the key
-    jsonmap::iterator it = internal_map.find(specifier);
-    if (it != internal_map.end()) return it->second->getHandle("");
+    JsonAbstractValue* value = find(specifier);
+    if (value) return value->getHandle("");
     return "NULL";
 }
 
@@ -267,13 +683,14 @@ string JsonObject::getHandle(string specifier) {
 // returns:
 //    an integer representation of the requested value (if found), 
 //    otherwise, zero
-long JsonObject::getInteger(string specifier) {
-    if (internal_map.empty()) return 0;
+long JsonObject::getInteger(string_view specifier) {
+    load();
+    if (entries.empty()) return 0;
     if (specifier == "") return 0;
 
     // the specifier as the key
-    jsonmap::iterator it = internal_map.find(specifier);
-    if (it != internal_map.end()) return it->second->getInteger("");
+    JsonAbstractValue* value = find(specifier);
+    if (value) return value->getInteger("");
     return 0;
 }
 
@@ -289,13 +706,14 @@ long JsonObject::getInteger(string specifier) {
 // returns:
 //    a double representation of the requested value (if found), 
 //    otherwise, zero
-double JsonObject::getDouble(string specifier) {
-    if (internal_map.empty()) return 0.0;
+double JsonObject::getDouble(string_view specifier) {
+    load();
+    if (entries.empty()) return 0.0;
     if (specifier == "") return 0.0;
 
     // the specifier as the key
-    jsonmap::iterator it = internal_map.find(specifier);
-    if (it != internal_map.end()) return it->second->getDouble("");
+    JsonAbstractValue* value = find(specifier);
+    if (value) return value->getDouble("");
     return 0.0;
 }
 
@@ -309,12 +727,215 @@ double JsonObject::getDouble(string specifier) {
 // returns:
 //    a pointer to a JsonAbstractValue associated with the key, otherwise
 //    NULL
-JsonAbstractValue* JsonObject::find(string key) {
-    map<string,JsonAbstractValue*>::iterator it = internal_map.find(key);
-    if (it == internal_map.end()) return NULL;
-    return internal_map.find(key)->second;
+JsonAbstractValue* JsonObject::find(string_view key) {
+    long pos = findEntry(key);
+    if (pos < 0) return NULL;
+    return entries[pos].value;
+}
+
+//*******************************************************************
+// find()
+//
+// find and return the value associated with the specified key that
+// has already been resolved.
+// 
+// parameters:
+//    key - the key for the value to return
+// returns:
+//    a pointer to a JsonAbstractValue associated with the key, otherwise
+//    NULL
+JsonAbstractValue* JsonObject::find(const JsonKey& key) {
+    long pos = findEntry(key);
+    if (pos < 0) return NULL;
+    return entries[pos].value;
+}
+
+//*******************************************************************
+// editEntry()
+//
+// return the value of the specified entry so that it can be modified,
+// first replacing it with a copy if it is shared with another
+// structure.  Values within an arena are never shared.
+// 
+// parameters:
+//    pos - the position of the entry, or -1
+// returns:
+//    a pointer to the value that may be modified, otherwise NULL
+JsonAbstractValue* JsonObject::editEntry(long pos) {
+    if ((pos < 0) || (!modifiable("JsonObject"))) return NULL;
+    touch();
+    JsonAbstractValue* value = entries[pos].value;
+    if ((!arena) && (value->isShared())) {
+        entries[pos].value = value->copy();
+        JsonAbstractValue::release(value);
+    }
+    return entries[pos].value;
+}
+
+//*******************************************************************
+// edit()
+//
+// return the value associated with the specified key so that it can
+// be modified without affecting copies of this object.
+// 
+// parameters:
+//    key - the key for the value to return
+// returns:
+//    a pointer to the value that may be modified, otherwise NULL
+JsonAbstractValue* JsonObject::edit(string_view key) {
+    return editEntry(findEntry(key));
+}
+
+//*******************************************************************
+// edit()
+//
+// return the value associated with the specified key that has already
+// been resolved so that it can be modified without affecting copies
+// of this object.
+// 
+// parameters:
+//    key - the key for the value to return
+// returns:
+//    a pointer to the value that may be modified, otherwise NULL
+JsonAbstractValue* JsonObject::edit(const JsonKey& key) {
+    return editEntry(findEntry(key));
+}
+
+//*******************************************************************
+// getValue()
+//
+// returns a string value of the value associated with the specified
+// key.
+// 
+// parameters:
+//    key - the key for the value to return
+// returns:
+//    a string representation of the requested value (if found),
+//    otherwise, an empty string
+string JsonObject::getValue(const JsonKey& key) {
+    JsonAbstractValue* value = find(key);
+    if (value) return value->getValue("");
+    return "";
+}
+
+//*******************************************************************
+// getValueView()
+//
+// returns a view of the text of the value associated with the
+// specified key.
+// 
+// parameters:
+//    key - the key for the value to return
+// returns:
+//    a view of the requested value text (if found), otherwise an empty
+//    view
+string_view JsonObject::getValueView(const JsonKey& key) {
+    JsonAbstractValue* value = find(key);
+    if (value) return value->getValueView("");
+    return string_view();
+}
+
+//*******************************************************************
+// getInteger()
+//
+// returns an integer representation of the value associated with the
+// specified key.
+// 
+// parameters:
+//    key - the key for the value to return
+// returns:
+//    an integer representation of the requested value (if found), 
+//    otherwise, zero
+long JsonObject::getInteger(const JsonKey& key) {
+    JsonAbstractValue* value = find(key);
+    if (value) return value->getInteger("");
+    return 0;
+}
+
+//*******************************************************************
+// getDouble()
+//
+// returns a double representation of the value associated with the
+// specified key.
+// 
+// parameters:
+//    key - the key for the value to return
+// returns:
+//    a double representation of the requested value (if found), 
+//    otherwise, zero
+double JsonObject::getDouble(const JsonKey& key) {
+    JsonAbstractValue* value = find(key);
+    if (value) return value->getDouble("");
+    return 0.0;
+}
+
+//*******************************************************************
+// getBoolean()
+//
+// returns a boolean representation of the value associated with the
+// specified key.
+// 
+// parameters:
+//    key - the key for the value to return
+// returns:
+//    a boolean representation of the requested value (if found), 
+//    otherwise, false
+bool JsonObject::getBoolean(const JsonKey& key) {
+    JsonAbstractValue* value = find(key);
+    if (value) return value->getBoolean("");
+    return false;
 }
     
+//*******************************************************************
+// reserve()
+//
+// reserve storage for the specified number of fields so that adding
+// them does not reallocate.
+// 
+// parameters:
+//    count - the number of fields to reserve storage for
+// returns:
+//    void
+void JsonObject::reserve(unsigned long count) {
+    load();
+    entries.reserve(count);
+}
+
+//*******************************************************************
+// defer()
+//
+// defer reading the fields of the object until they are first used.
+// Only an empty object allocated from the source's arena may be
+// deferred.
+// 
+// parameters:
+//    source - the source to read the fields from
+//    entry - the entry of the object within the source
+// returns:
+//    void
+void JsonObject::defer(JsonDeferred* source, unsigned long entry) {
+    pending = source;
+    pendingEntry = entry;
+}
+
+//*******************************************************************
+// expand()
+//
+// read the fields of the object from its source.  The object is
+// marked as read first so that the fields can be added normally.  If the
+// text is badly formed, the object is left empty (the error is recorded
+// on the source).
+// 
+// parameters:
+//    none
+// returns:
+//    void
+void JsonObject::expand() {
+    JsonDeferred* source = pending;
+    pending = NULL;
+    if (!source->expand(this, pendingEntry)) clear();
+}
+
 //*******************************************************************
 // size()
 //
@@ -325,7 +946,8 @@ JsonAbstractValue* JsonObject::find(string key) {
 // returns:
 //    the number of fields in this object.
 unsigned long JsonObject::size() {
-    return internal_map.size();
+    load();
+    return entries.size();
 }
 
 //*******************************************************************
@@ -338,12 +960,39 @@ unsigned long JsonObject::size() {
 // returns:
 //    the key for the nth element, otherwise an empty string.
 string JsonObject::getElementKey(unsigned long idx) {
-    if (idx >= index.size()) return "";
+    load();
+    if (idx >= entries.size()) return "";
+    return string(entries[idx].key);
+}
 
-    // attempt to find the indexed item in the array
-    jsonmapindex::iterator it = index.begin();
-    for (unsigned int i = 0; i < idx; i++) it++;
-    
-    // return the result
-    return it->data();
+//*******************************************************************
+// getElementKeyView()
+//
+// returns a view of the key for the nth indext element within the
+// object.  The view remains valid while the field is in the object
+// (and, for an arena-owned object, until the arena is reset).
+// 
+// parameters:
+//    idx - the index number for the element to retrieve the key for.
+// returns:
+//    the key for the nth element, otherwise an empty view.
+string_view JsonObject::getElementKeyView(unsigned long idx) {
+    load();
+    if (idx >= entries.size()) return string_view();
+    return entries[idx].key;
+}
+
+//*******************************************************************
+// getElement()
+//
+// returns the value for the nth indext element within the object.
+// 
+// parameters:
+//    idx - the index number for the element to retrieve the value for.
+// returns:
+//    the value for the nth element, otherwise NULL.
+JsonAbstractValue* JsonObject::getElement(unsigned long idx) {
+    load();
+    if (idx >= entries.size()) return NULL;
+    return entries[idx].value;
 }
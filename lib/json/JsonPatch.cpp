@@ -0,0 +1,323 @@
+//*******************************************************************
+//    JsonPatch.cpp
+//
+//    This file provides implementation for a class that applies a JSON
+//    Patch (RFC 6902) to a JSON structure.  This file is intended to be
+//    used as part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <algorithm>
+#include <iostream>
+#include "JsonPatch.h"
+#include "JsonArray.h"
+#include "JsonDiff.h"
+#include "JsonPointer.h"
+#include "JsonText.h"
+#include "JsonValue.h"
+
+//*******************************************************************
+// JsonPatch()
+//
+// constructor - the state used while a patch is applied.
+//
+// parameters:
+//    document - the structure to patch
+//    arena - the arena that owns the structure (or NULL for the heap)
+//    decoded - true if the strings of the structures are decoded
+JsonPatch::JsonPatch(JsonAbstractValue* document, JsonArena* arena, bool decoded) :
+    document(document), arena(arena), number(0), decoded(decoded)
+{
+}
+
+//*******************************************************************
+// error()
+//
+// report an operation that could not be applied.
+//
+// parameters:
+//    message - a description of the problem
+// returns:
+//    false
+bool JsonPatch::error(string_view message) {
+    cerr << "JSON patch operation " << number << ": " << message << endl;
+    return false;
+}
+
+//*******************************************************************
+// getText()
+//
+// return the decoded text of a string member of an operation.
+//
+// parameters:
+//    val - the member
+//    text - the string that receives the text
+// returns:
+//    true if the member is a value with valid text, otherwise false
+bool JsonPatch::getText(JsonAbstractValue* val, string& text) {
+    if (!dynamic_cast<JsonValue*>(val)) return false;
+    if (!decoded) return JsonText::decode(val->getValueView(""), text);
+    text = val->getValueView("");
+    return true;
+}
+
+//*******************************************************************
+// findKey()
+//
+// find the key of the field of an object that a reference token names.
+// Unless the structure is decoded, its keys hold their escape sequences
+// - a key without a backslash is its own decoded text, so it is looked
+// up directly, otherwise the keys with escape sequences are decoded
+// and compared.
+//
+// parameters:
+//    obj - the object
+//    token - the reference token
+//    key - receives the key of the field as it is stored, or if there
+//       is no such field, the key to store for a new field
+// returns:
+//    true if the object has the field, otherwise false
+bool JsonPatch::findKey(JsonObject* obj, const string& token, string& key) {
+    key = token;
+    if (decoded) return obj->find(key) != NULL;
+    if ((token.find('\\') == string::npos) && (obj->find(token))) return true;
+    string text;
+    for (unsigned long i = 0; i < obj->size(); i++) {
+        string_view stored = obj->getElementKeyView(i);
+        if ((JsonText::hasEscapes(stored)) && (JsonText::decode(stored, text)) && (text == token)) {
+            key = stored;
+            return true;
+        }
+    }
+    key.clear();
+    JsonText::encode(token, key);
+    return false;
+}
+
+//*******************************************************************
+// find()
+//
+// find the value referred to by the leading tokens of a pointer.  When
+// the value is about to be modified, each container along the path is
+// reached through edit(), so values shared with copies of the
+// structure are duplicated and the hashes along the path are cleared.
+//
+// parameters:
+//    tokens - the reference tokens of the pointer
+//    count - the number of leading tokens to follow
+//    edit - true if the value will be modified
+// returns:
+//    the value, or NULL if the path does not exist
+JsonAbstractValue* JsonPatch::find(const vector<string>& tokens, unsigned long count, bool edit) {
+    JsonAbstractValue* node = document;
+    for (unsigned long i = 0; (i < count) && (node); i++) {
+        JsonObject* obj = dynamic_cast<JsonObject*>(node);
+        JsonArray* ary = (obj) ? NULL : dynamic_cast<JsonArray*>(node);
+        unsigned long index;
+        string key;
+        if (obj) {
+            node = (!findKey(obj, tokens[i], key)) ? NULL : (edit) ? obj->edit(key) : obj->find(key);
+        } else if ((ary) && (JsonPointer::parseIndex(tokens[i], index))) {
+            node = (edit) ? ary->edit(index) : ary->getElement(index);
+        } else {
+            node = NULL;
+        }
+    }
+    return node;
+}
+
+//*******************************************************************
+// clone()
+//
+// copy a value so that it can be added to the structure.  Values added
+// to a heap allocated structure are copied with copy(), which shares
+// the contents of heap allocated containers.  Values added to a
+// structure within an arena are cloned into the arena.
+//
+// parameters:
+//    val - the value to copy
+// returns:
+//    the copy of the value
+JsonAbstractValue* JsonPatch::clone(JsonAbstractValue* val) {
+    return val->clone(arena);
+}
+
+//*******************************************************************
+// set()
+//
+// add a value to the structure, or replace an existing value.  Adding
+// a field that already exists replaces it, adding an array element
+// inserts it before the element at the index ("-" adds it to the end
+// of the array).  The structure takes ownership of the value - if it
+// cannot be placed, the value is released.
+//
+// parameters:
+//    path - the reference tokens of the location
+//    val - the value, allocated in the same way as the structure
+//    add - true to add the value, false to replace an existing value
+// returns:
+//    true if the value was placed, otherwise false
+bool JsonPatch::set(const vector<string>& path, JsonAbstractValue* val, bool add) {
+    if (path.empty()) {
+        if (!arena) JsonAbstractValue::release(document);
+        document = val;
+        return true;
+    }
+
+    JsonAbstractValue* parent = find(path, path.size() - 1, true);
+    JsonObject* obj = dynamic_cast<JsonObject*>(parent);
+    JsonArray* ary = (obj) ? NULL : dynamic_cast<JsonArray*>(parent);
+    const string& last = path.back();
+    bool placed = false;
+    if (obj) {
+        string key;
+        placed = ((findKey(obj, last, key)) || (add));
+        if (placed) obj->put(key, val);
+    } else if (ary) {
+        unsigned long index;
+        if ((add) && (last == "-")) {
+            placed = ary->insert(ary->size(), val);
+        } else if (JsonPointer::parseIndex(last, index)) {
+            placed = (add) ? ary->insert(index, val) : ary->replace(index, val);
+        }
+    }
+    if (placed) return true;
+    if (!arena) JsonAbstractValue::release(val);
+    return error("path does not exist");
+}
+
+//*******************************************************************
+// take()
+//
+// remove a value from the structure and return it.  The root of the
+// structure cannot be removed.
+//
+// parameters:
+//    path - the reference tokens of the location
+// returns:
+//    the removed value (owned by the caller), or NULL if the path does
+//    not exist
+JsonAbstractValue* JsonPatch::take(const vector<string>& path) {
+    if (path.empty()) return NULL;
+    JsonAbstractValue* parent = find(path, path.size() - 1, true);
+    JsonObject* obj = dynamic_cast<JsonObject*>(parent);
+    JsonArray* ary = (obj) ? NULL : dynamic_cast<JsonArray*>(parent);
+    unsigned long index;
+    string key;
+    if (obj) return (findKey(obj, path.back(), key)) ? obj->take(key) : NULL;
+    if ((ary) && (JsonPointer::parseIndex(path.back(), index))) return ary->take(index);
+    return NULL;
+}
+
+//*******************************************************************
+// applyOperation()
+//
+// apply a single operation of a patch.
+//
+// parameters:
+//    operation - the operation object
+// returns:
+//    true if the operation was applied (or the test passed), otherwise
+//    false
+bool JsonPatch::applyOperation(JsonObject* operation) {
+    if (!operation) return error("operation is not an object");
+    JsonAbstractValue* op = operation->find("op");
+    JsonAbstractValue* pathValue = operation->find("path");
+    JsonAbstractValue* value = operation->find("value");
+    string name;
+    string text;
+    if ((!getText(op, name)) || (!getText(pathValue, text))) {
+        return error("operation requires \"op\" and \"path\" members");
+    }
+    vector<string> path;
+    if (!JsonPointer::parse(text, path)) return error("invalid path");
+
+    if ((name == "add") || (name == "replace")) {
+        if (!value) return error("operation requires a \"value\" member");
+        return set(path, clone(value), name == "add");
+    }
+    if (name == "remove") {
+        JsonAbstractValue* removed = take(path);
+        if (!removed) return error("path does not exist");
+        if (!arena) JsonAbstractValue::release(removed);
+        return true;
+    }
+    if (name == "test") {
+        if (!value) return error("operation requires a \"value\" member");
+        JsonAbstractValue* target = find(path, path.size(), false);
+        if ((!target) || (!JsonDiff::equals(target, value))) return error("test failed");
+        return true;
+    }
+    if ((name != "move") && (name != "copy")) return error("unknown operation");
+
+    JsonAbstractValue* fromValue = operation->find("from");
+    vector<string> from;
+    if (!getText(fromValue, text)) return error("operation requires a \"from\" member");
+    if (!JsonPointer::parse(text, from)) return error("invalid from path");
+    if (name == "copy") {
+        JsonAbstractValue* source = find(from, from.size(), false);
+        if (!source) return error("from path does not exist");
+        return set(path, clone(source), true);
+    }
+
+    // a value cannot be moved into itself
+    if (path == from) return (find(from, from.size(), false) != NULL) ? true : error("from path does not exist");
+    if ((path.size() > from.size()) && (equal(from.begin(), from.end(), path.begin()))) {
+        return error("cannot move a value into itself");
+    }
+    JsonAbstractValue* moved = take(from);
+    if (!moved) return error("from path does not exist");
+    return set(path, moved, true);
+}
+
+//*******************************************************************
+// apply()
+//
+// apply the operations of a patch to a structure in order, stopping
+// at the first operation that fails.
+//
+// parameters:
+//    document - the structure to patch.  If the root is replaced, this
+//       is updated to the new root.
+//    patch - the array of patch operations
+//    decoded - true if the strings of both structures are decoded
+// returns:
+//    true if every operation was applied, otherwise false
+bool JsonPatch::apply(JsonAbstractValue*& document, JsonAbstractValue* patch, bool decoded) {
+    JsonObject* obj = dynamic_cast<JsonObject*>(document);
+    JsonArray* ary = (obj) ? NULL : dynamic_cast<JsonArray*>(document);
+    JsonArray* operations = dynamic_cast<JsonArray*>(patch);
+    if (((!obj) && (!ary)) || (!operations)) {
+        cerr << "JSON patch requires an object or array and an array of operations" << endl;
+        return false;
+    }
+
+    JsonPatch patcher(document, (obj) ? obj->getArena() : ary->getArena(), decoded);
+    bool result = true;
+    for (JsonArray::iterator it = operations->begin(); it != operations->end(); ++it) {
+        patcher.number++;
+        if (!patcher.applyOperation(dynamic_cast<JsonObject*>(*it))) {
+            result = false;
+            break;
+        }
+    }
+    document = patcher.document;
+    return result;
+}
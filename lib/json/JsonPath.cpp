@@ -0,0 +1,274 @@
+//*******************************************************************
+//    JsonPath.cpp
+//
+//    This file provides implementation for a class that represents a
+//    compiled path query over a JSON structure.  This file is intended
+//    to be used as part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <cctype>
+#include <cstdlib>
+#include "JsonPath.h"
+#include "JsonObject.h"
+#include "JsonArray.h"
+
+//*******************************************************************
+// JsonPath()
+//
+// default constructor - the path is empty and selects only the root.
+JsonPath::JsonPath() : valid(true) {
+}
+
+//*******************************************************************
+// JsonPath()
+//
+// Initialization constructor - compile the specified path.  isValid()
+// reports whether the path compiled successfully.
+//
+// parameters:
+//    path - the text of the path to compile
+JsonPath::JsonPath(string path) {
+    compile(path);
+}
+
+//*******************************************************************
+// compile()
+//
+// parse the specified path text into a sequence of steps.  An
+// optional leading '$' refers to the root of the structure.
+//
+// parameters:
+//    path - the text of the path to compile
+// returns:
+//    true if the path compiled successfully, otherwise false
+bool JsonPath::compile(string path) {
+    text = path;
+    steps.clear();
+    valid = false;
+
+    unsigned long pos = 0;
+    if ((pos < path.length()) && (path[pos] == '$')) pos++;
+    while (pos < path.length()) {
+        Step step;
+        step.index = 0;
+        if (path[pos] == '.') {
+            pos++;
+            continue;
+        }
+        if (path[pos] != '[') {
+            // a field name - ends at the next separator
+            unsigned long end = path.find_first_of(".[", pos);
+            if (end == string::npos) end = path.length();
+            step.type = STEP_FIELD;
+            step.key = JsonKey(string_view(path).substr(pos, end - pos));
+            steps.push_back(step);
+            pos = end;
+            continue;
+        }
+
+        // here if the step is enclosed in brackets.  The step ends at
+        // the first ']' that is not within a quoted literal.
+        unsigned long end = pos + 1;
+        char quote = 0;
+        while ((end < path.length()) && ((quote) || (path[end] != ']'))) {
+            if (path[end] == quote) {
+                quote = 0;
+            } else if ((!quote) && ((path[end] == '\'') || (path[end] == '"'))) {
+                quote = path[end];
+            }
+            end++;
+        }
+        if (end >= path.length()) {
+            cerr << "JsonPath: missing ']' in " << path << endl;
+            return false;
+        }
+        string body = path.substr(pos + 1, end - pos - 1);
+        pos = end + 1;
+        if (body == "*") {
+            step.type = STEP_WILDCARD;
+        } else if ((!body.empty()) && (body[0] == '?')) {
+            // a filter of the form ?key==literal or ?key!=literal.  The
+            // operator is the first one found, since the literal may
+            // contain either.
+            unsigned long op = body.find("==");
+            step.type = STEP_MATCH;
+            if (body.find("!=") < op) {
+                op = body.find("!=");
+                step.type = STEP_NOMATCH;
+            }
+            if ((op == string::npos) || (op < 2)) {
+                cerr << "JsonPath: invalid filter [" << body << "] in " << path << endl;
+                return false;
+            }
+            step.key = JsonKey(string_view(body).substr(1, op - 1));
+            step.literal = body.substr(op + 2);
+            if ((step.literal.length() >= 2) &&
+                ((step.literal[0] == '\'') || (step.literal[0] == '"')) &&
+                (step.literal[step.literal.length() - 1] == step.literal[0])) {
+                step.literal = step.literal.substr(1, step.literal.length() - 2);
+            }
+        } else if ((!body.empty()) && (isdigit((unsigned char)body[0]))) {
+            char* endptr;
+            step.type = STEP_INDEX;
+            step.index = strtoul(body.c_str(), &endptr, 10);
+            if (*endptr) {
+                cerr << "JsonPath: invalid index [" << body << "] in " << path << endl;
+                return false;
+            }
+        } else {
+            cerr << "JsonPath: invalid step [" << body << "] in " << path << endl;
+            return false;
+        }
+        steps.push_back(step);
+    }
+    valid = true;
+    return true;
+}
+
+//*******************************************************************
+// isValid()
+//
+// returns true if the path compiled successfully.
+//
+// parameters:
+//    none
+// returns:
+//    true if the path is valid, otherwise false
+bool JsonPath::isValid() const {
+    return valid;
+}
+
+//*******************************************************************
+// getText()
+//
+// returns the source text of the path.
+//
+// parameters:
+//    none
+// returns:
+//    the text the path was compiled from
+string JsonPath::getText() const {
+    return text;
+}
+
+//*******************************************************************
+// matches()
+//
+// returns true if the specified node satisfies a filter step.  Only
+// objects that have the field named by the filter can satisfy it.
+//
+// parameters:
+//    step - the filter step
+//    node - the node to test
+// returns:
+//    true if the node satisfies the filter, otherwise false
+bool JsonPath::matches(const Step& step, JsonAbstractValue* node) {
+    JsonObject* obj = dynamic_cast<JsonObject*>(node);
+    if ((!obj) || (!obj->find(step.key))) return false;
+    bool equal = (obj->getValueView(step.key) == step.literal);
+    return (step.type == STEP_MATCH) ? equal : !equal;
+}
+
+//*******************************************************************
+// apply()
+//
+// apply a single step to a node, adding the selected nodes to the
+// output list.
+//
+// parameters:
+//    step - the step to apply
+//    node - the node to apply the step to
+//    out - the list to add the selected nodes to
+// returns:
+//    void
+void JsonPath::apply(const Step& step, JsonAbstractValue* node, vector<JsonAbstractValue*>& out) const {
+    JsonObject* obj = dynamic_cast<JsonObject*>(node);
+    JsonArray* arr = (obj) ? NULL : dynamic_cast<JsonArray*>(node);
+    switch (step.type) {
+    case STEP_FIELD:
+        if (obj) {
+            JsonAbstractValue* value = obj->find(step.key);
+            if (value) out.push_back(value);
+        }
+        break;
+    case STEP_INDEX:
+        if (arr) {
+            JsonAbstractValue* value = arr->getElement(step.index);
+            if (value) out.push_back(value);
+        }
+        break;
+    default:
+        // wildcard and filter steps visit every child
+        if (arr) {
+            for (JsonArray::iterator it = arr->begin(); it != arr->end(); ++it) {
+                if ((step.type == STEP_WILDCARD) || (matches(step, *it))) out.push_back(*it);
+            }
+        } else if (obj) {
+            for (unsigned long i = 0; i < obj->size(); i++) {
+                JsonAbstractValue* value = obj->getElement(i);
+                if ((step.type == STEP_WILDCARD) || (matches(step, value))) out.push_back(value);
+            }
+        }
+        break;
+    }
+}
+
+//*******************************************************************
+// select()
+//
+// execute the path against the specified structure and return every
+// node that it selects, in document order.
+//
+// parameters:
+//    root - the structure to execute the path against
+// returns:
+//    the list of selected nodes (empty if none or the path is invalid)
+vector<JsonAbstractValue*> JsonPath::select(JsonAbstractValue* root) const {
+    vector<JsonAbstractValue*> current;
+    if ((!valid) || (!root)) return current;
+    current.push_back(root);
+    vector<JsonAbstractValue*> next;
+    for (vector<Step>::const_iterator step = steps.begin(); step != steps.end(); ++step) {
+        next.clear();
+        for (vector<JsonAbstractValue*>::iterator it = current.begin(); it != current.end(); ++it) {
+            apply(*step, *it, next);
+        }
+        current.swap(next);
+        if (current.empty()) break;
+    }
+    return current;
+}
+
+//*******************************************************************
+// first()
+//
+// execute the path against the specified structure and return the
+// first node that it selects.
+//
+// parameters:
+//    root - the structure to execute the path against
+// returns:
+//    the first selected node, otherwise NULL
+JsonAbstractValue* JsonPath::first(JsonAbstractValue* root) const {
+    vector<JsonAbstractValue*> result = select(root);
+    if (result.empty()) return NULL;
+    return result[0];
+}
@@ -0,0 +1,167 @@
+//*******************************************************************
+//    JsonPathCache.cpp
+//
+//    This file provides implementation for a class that caches
+//    compiled JSON paths and the results of executing them.  This file
+//    is intended to be used as part of the PICMG IoT library reference
+//    code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include "JsonPathCache.h"
+#include "JsonObject.h"
+#include "JsonArray.h"
+
+//*******************************************************************
+// JsonPathCache()
+//
+// default constructor.
+JsonPathCache::JsonPathCache() {
+}
+
+//*******************************************************************
+// ~JsonPathCache()
+//
+// destructor.
+JsonPathCache::~JsonPathCache() {
+}
+
+//*******************************************************************
+// plan()
+//
+// return the compiled form of the specified path, compiling it if it
+// has not been seen before.  The cache must be locked by the caller.
+//
+// parameters:
+//    path - the text of the path
+// returns:
+//    a reference to the compiled path
+const JsonPath& JsonPathCache::plan(string_view path) {
+    map<string, JsonPath, less<>>::iterator it = plans.find(path);
+    if (it == plans.end()) it = plans.emplace(string(path), JsonPath(string(path))).first;
+    return it->second;
+}
+
+//*******************************************************************
+// isCurrent()
+//
+// returns true if a cached result still refers to the structure that
+// it was found in.  A result is out of date if any arena has been
+// destroyed (the arena of the structure may be one of them), if the
+// arena that owns the structure has changed, or if any heap allocated
+// structure has changed since the result was found.
+//
+// parameters:
+//    result - the cached result
+// returns:
+//    true if the result may be used, otherwise false
+bool JsonPathCache::isCurrent(const Result& result) {
+    if (result.destroyed != JsonArena::destroyedCount()) return false;
+    if ((result.arena) && (result.arena->getVersion() != result.arenaVersion)) return false;
+    return result.heapVersion == JsonAbstractValue::heapVersion();
+}
+
+//*******************************************************************
+// compile()
+//
+// return the compiled form of the specified path, compiling it if it
+// has not been seen before.
+//
+// parameters:
+//    path - the text of the path
+// returns:
+//    a reference to the compiled path
+const JsonPath& JsonPathCache::compile(string_view path) {
+    lock_guard<mutex> guard(lock);
+    return plan(path);
+}
+
+//*******************************************************************
+// select()
+//
+// execute the specified path against a structure.  The result is
+// computed on first use and returned from the cache until it is out
+// of date.  The versions are taken once the path has been executed,
+// since reading the parts of a lazily built structure for the first
+// time adds to its containers.  Results for a single value (rather
+// than a container) are not cached.
+//
+// parameters:
+//    root - the structure to execute the path against
+//    path - the text of the path
+// returns:
+//    a copy of the list of selected nodes
+vector<JsonAbstractValue*> JsonPathCache::select(JsonAbstractValue* root, string_view path) {
+    const JsonPath* compiled;
+    {
+        lock_guard<mutex> guard(lock);
+        compiled = &plan(path);
+        map<resultkey, Result>::iterator it = results.find(resultkey(root, compiled));
+        if ((it != results.end()) && (isCurrent(it->second))) return it->second.nodes;
+    }
+
+    Result result = { compiled->select(root), NULL, 0, 0, 0 };
+    JsonObject* obj = dynamic_cast<JsonObject*>(root);
+    JsonArray* ary = (obj) ? NULL : dynamic_cast<JsonArray*>(root);
+    if ((!obj) && (!ary)) return result.nodes;
+
+    // find the arena that owns the structure
+    result.arena = (obj) ? obj->getArena() : ary->getArena();
+    if (result.arena) result.arenaVersion = result.arena->getVersion();
+    result.heapVersion = JsonAbstractValue::heapVersion();
+    result.destroyed = JsonArena::destroyedCount();
+
+    lock_guard<mutex> guard(lock);
+    results[resultkey(root, compiled)] = result;
+    return result.nodes;
+}
+
+//*******************************************************************
+// first()
+//
+// execute the specified path against a structure and return the first
+// node selected.
+//
+// parameters:
+//    root - the structure to execute the path against
+//    path - the text of the path
+// returns:
+//    the first selected node, otherwise NULL
+JsonAbstractValue* JsonPathCache::first(JsonAbstractValue* root, string_view path) {
+    jsonnodes nodes = select(root, path);
+    if (nodes.empty()) return NULL;
+    return nodes[0];
+}
+
+//*******************************************************************
+// clear()
+//
+// discard the cached results.  Results that are out of date are
+// never returned, so this is only needed to release memory.
+//
+// parameters:
+//    plansToo - if true, the compiled paths are discarded as well
+// returns:
+//    void
+void JsonPathCache::clear(bool plansToo) {
+    lock_guard<mutex> guard(lock);
+    results.clear();
+    if (plansToo) plans.clear();
+}
@@ -0,0 +1,107 @@
+//*******************************************************************
+//    JsonPointer.cpp
+//
+//    This file provides implementation for the functions used to build
+//    and split JSON Pointers (RFC 6901).  This file is intended to be
+//    used as part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include "JsonPointer.h"
+
+//*******************************************************************
+// appendToken()
+//
+// add a reference token to a JSON Pointer.  Within the token, '~' is
+// written as "~0" and '/' as "~1".
+//
+// parameters:
+//    path - the pointer to add the token to
+//    token - the token (an object key or array index)
+// returns:
+//    void
+void JsonPointer::appendToken(string& path, string_view token) {
+    path += '/';
+    for (char c : token) {
+        if (c == '~') {
+            path += "~0";
+        } else if (c == '/') {
+            path += "~1";
+        } else {
+            path += c;
+        }
+    }
+}
+
+//*******************************************************************
+// parse()
+//
+// split a JSON Pointer (RFC 6901) into its reference tokens.  Within
+// a token, "~1" stands for '/' and "~0" for '~'.
+//
+// parameters:
+//    pointer - the text of the pointer ("" for the root)
+//    tokens - the list to receive the unescaped tokens
+// returns:
+//    true if the pointer is well formed, otherwise false
+bool JsonPointer::parse(string_view pointer, vector<string>& tokens) {
+    tokens.clear();
+    if (pointer.empty()) return true;
+    if (pointer[0] != '/') return false;
+    for (unsigned long i = 0; i < pointer.length(); i++) {
+        char c = pointer[i];
+        if (c == '/') {
+            tokens.push_back(string());
+        } else if (c != '~') {
+            tokens.back() += c;
+        } else if ((i + 1 < pointer.length()) && (pointer[i + 1] == '0')) {
+            tokens.back() += '~';
+            i++;
+        } else if ((i + 1 < pointer.length()) && (pointer[i + 1] == '1')) {
+            tokens.back() += '/';
+            i++;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+//*******************************************************************
+// parseIndex()
+//
+// convert a reference token to an array index.  The token must be a
+// decimal number without leading zeros.
+//
+// parameters:
+//    token - the token to convert
+//    index - the index (on return)
+// returns:
+//    true if the token is an array index, otherwise false
+bool JsonPointer::parseIndex(string_view token, unsigned long& index) {
+    if ((token.empty()) || (token.length() > 18)) return false;
+    if ((token[0] == '0') && (token.length() > 1)) return false;
+    index = 0;
+    for (char c : token) {
+        if ((c < '0') || (c > '9')) return false;
+        index = index * 10 + (c - '0');
+    }
+    return true;
+}
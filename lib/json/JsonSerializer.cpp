@@ -0,0 +1,214 @@
+//*******************************************************************
+//    JsonSerializer.cpp
+//
+//    This file provides implementation for a class that writes JSON
+//    structures as compact or pretty-printed text.  This file is
+//    intended to be used as part of the PICMG IoT library reference
+//    code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include "JsonSerializer.h"
+
+//*******************************************************************
+// JsonSerializer()
+//
+// constructor.
+//
+// parameters:
+//    pretty - if true, the output will be indented with fields on
+//       separate lines.
+JsonSerializer::JsonSerializer(bool pretty) : pretty(pretty) {
+}
+
+//*******************************************************************
+// writeIndent()
+//
+// append the specified number of spaces to the buffer.
+//
+// parameters:
+//    indent - the number of spaces
+// returns:
+//    void
+void JsonSerializer::writeIndent(int indent) {
+    if (indent > 0) buffer.append(indent, ' ');
+}
+
+//*******************************************************************
+// writeValue()
+//
+// append a value primitive to the buffer.  The stored type of the
+// value determines whether it is quoted, so the text is not examined.
+//
+// parameters:
+//    val - the value to write
+// returns:
+//    void
+void JsonSerializer::writeValue(JsonValue* val) {
+    switch (val->getType()) {
+    case JSON_NULL:
+        buffer.append("null");
+        break;
+    case JSON_BOOLEAN:
+        buffer.append(val->getBoolean("") ? "true" : "false");
+        break;
+    case JSON_INTEGER:
+    case JSON_DOUBLE:
+        buffer.append(val->getValueView(""));
+        break;
+    default:
+        buffer += '\"';
+        buffer.append(val->getText());
+        buffer += '\"';
+        break;
+    }
+}
+
+//*******************************************************************
+// writeObject()
+//
+// append a json object to the buffer.
+//
+// parameters:
+//    obj - the object to write
+//    indent - the indentation level of the object
+// returns:
+//    void
+void JsonSerializer::writeObject(JsonObject* obj, int indent) {
+    buffer += '{';
+    if (pretty) buffer += '\n';
+    unsigned long count = obj->size();
+    for (unsigned long i = 0; i < count; i++) {
+        if (pretty) writeIndent(indent + 3);
+        buffer += '\"';
+        buffer.append(obj->getElementKeyView(i));
+        buffer.append("\":");
+        write(obj->getElement(i), indent + 3, false);
+        if (i + 1 < count) buffer += ',';
+        if (pretty) buffer += '\n';
+    }
+    if (pretty) writeIndent(indent);
+    buffer += '}';
+}
+
+//*******************************************************************
+// writeArray()
+//
+// append a json array to the buffer.
+//
+// parameters:
+//    ary - the array to write
+//    indent - the indentation level of the array
+// returns:
+//    void
+void JsonSerializer::writeArray(JsonArray* ary, int indent) {
+    buffer += '[';
+    if (pretty) buffer += '\n';
+    for (JsonArray::iterator it = ary->begin(); it != ary->end(); ++it) {
+        write(*it, indent + 3, true);
+        if (it + 1 != ary->end()) buffer += ',';
+        if (pretty) buffer += '\n';
+    }
+    if (pretty) writeIndent(indent);
+    buffer += ']';
+}
+
+//*******************************************************************
+// write()
+//
+// serialize a structure, appending the text to the buffer.  The
+// opening bracket of an array is never indented.
+//
+// parameters:
+//    val - the structure to write
+//    indent - the indentation level of the structure
+//    useIndent - true if the first line should be indented
+// returns:
+//    void
+void JsonSerializer::write(JsonAbstractValue* val, int indent, bool useIndent) {
+    // value primitives are the most common nodes, so are checked first
+    if (JsonValue* value = dynamic_cast<JsonValue*>(val)) {
+        if ((useIndent) && (pretty)) writeIndent(indent);
+        writeValue(value);
+    } else if (JsonObject* obj = dynamic_cast<JsonObject*>(val)) {
+        if ((useIndent) && (pretty)) writeIndent(indent);
+        writeObject(obj, indent);
+    } else if (JsonArray* ary = dynamic_cast<JsonArray*>(val)) {
+        writeArray(ary, indent);
+    }
+}
+
+//*******************************************************************
+// reserve()
+//
+// reserve space in the buffer for the text to be serialized.
+//
+// parameters:
+//    bytes - the expected size of the text
+// returns:
+//    void
+void JsonSerializer::reserve(unsigned long bytes) {
+    buffer.reserve(bytes);
+}
+
+//*******************************************************************
+// clear()
+//
+// discard the serialized text.  The buffer keeps its capacity so that
+// it can be reused.
+//
+// parameters:
+//    none
+// returns:
+//    void
+void JsonSerializer::clear() {
+    buffer.clear();
+}
+
+//*******************************************************************
+// flush()
+//
+// write the serialized text to the stream and clear the buffer.
+//
+// parameters:
+//    out - the output stream to write to
+// returns:
+//    void
+void JsonSerializer::flush(ostream& out) {
+    out.write(buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+//*******************************************************************
+// toString()
+//
+// serialize a structure to a string.
+//
+// parameters:
+//    val - the structure to serialize
+//    pretty - if true, the output will be indented with fields on
+//       separate lines.
+// returns:
+//    the serialized text
+string JsonSerializer::toString(JsonAbstractValue* val, bool pretty) {
+    JsonSerializer serializer(pretty);
+    serializer.write(val);
+    return serializer.buffer;
+}
@@ -0,0 +1,488 @@
+//*******************************************************************
+//    JsonSnapshot.cpp
+//
+//    This file provides implementation for a class that saves a JSON
+//    structure as a binary snapshot and restores it without parsing.
+//    This file is intended to be used as part of the PICMG IoT library
+//    reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "JsonSnapshot.h"
+
+// snapshot images begin with a header that identifies the format,
+// the byte order and record size of the machine that wrote it, and
+// the sizes of the tape and the text pool.
+struct SnapshotHeader {
+    char     magic[8];      // SNAPSHOT_MAGIC
+    uint32_t order;         // SNAPSHOT_ORDER in the byte order of the writer
+    uint32_t recordSize;    // size of each tape record
+    uint64_t records;       // number of records in the tape
+    uint64_t poolSize;      // number of bytes in the text pool
+};
+static const char SNAPSHOT_MAGIC[8] = { 'P', 'I', 'C', 'M', 'G', 'J', 'S', '1' };
+#define SNAPSHOT_ORDER 0x01020304
+
+// record tags
+#define TAG_OBJECT 1
+#define TAG_ARRAY  2
+#define TAG_KEY    3
+#define TAG_VALUE  4
+
+// the tape of a loaded snapshot image.  The tape is allocated from the
+// arena that holds the restored structure, and is the source that its
+// objects and arrays read their contents from.
+class JsonSnapshot::Tape :
+    public JsonDeferred
+{
+private:
+    const char* records;   // the first record of the tape
+    uint64_t    count;     // number of records in the tape
+    string_view text;      // the text pool
+    JsonArena*  arena;     // arena the structure is restored into
+
+    bool getRecord(uint64_t pos, Record& rec) const;
+    bool getText(const Record& rec, string_view& str) const;
+    JsonAbstractValue* node(uint64_t& pos);
+public:
+    Tape(const char* records, uint64_t count, string_view text, JsonArena* arena) :
+        records(records), count(count), text(text), arena(arena) {}
+
+    // check that the tape is well formed
+    bool check() const;
+    // return the value that the tape holds
+    JsonAbstractValue* root();
+    // read the contents of the container at the specified record
+    virtual bool expand(JsonObject* obj, unsigned long entry);
+    virtual bool expand(JsonArray* ary, unsigned long entry);
+};
+
+//*******************************************************************
+// JsonSnapshot()
+//
+// default constructor.
+JsonSnapshot::JsonSnapshot() {
+}
+
+//*******************************************************************
+// addText()
+//
+// add text to the pool, reusing the text if it is already there.
+//
+// parameters:
+//    str - the text to add
+// returns:
+//    the offset of the text within the pool
+uint64_t JsonSnapshot::addText(string_view str) {
+    unordered_map<string_view, uint64_t>::iterator it = strings.find(str);
+    if (it != strings.end()) return it->second;
+    uint64_t offset = pool.size();
+    pool.append(str);
+    strings.emplace(str, offset);
+    return offset;
+}
+
+//*******************************************************************
+// addValue()
+//
+// add the records for a value (and everything within it) to the tape.
+// Containers record the position of the record that follows them so
+// that a reader can skip over them.  The containers that are being
+// written are held on a stack rather than the call stack, so the
+// depth of the structure is only limited by available memory.
+//
+// parameters:
+//    root - the value to add
+// returns:
+//    true if the value was added, otherwise false
+bool JsonSnapshot::addValue(JsonAbstractValue* root) {
+    // a container whose records are being written
+    struct Frame {
+        JsonObject*   obj;      // the object being written (or NULL)
+        JsonArray*    ary;      // the array being written (or NULL)
+        unsigned long start;    // the position of the container record
+        unsigned long next;     // the next field or element to write
+    };
+    vector<Frame> stack;
+    JsonAbstractValue* val = root;
+    while (true) {
+        if (val) {
+            // add the record for the value
+            Record rec;
+            memset(&rec, 0, sizeof(rec));
+            if (JsonValue* value = dynamic_cast<JsonValue*>(val)) {
+                string_view str = value->getText();
+                if (str.length() > UINT32_MAX) return false;
+                rec.tag = TAG_VALUE;
+                rec.type = value->getType();
+                rec.boolean = value->getBoolean("");
+                rec.length = str.length();
+                rec.offset = addText(str);
+                rec.integer = value->getInteger("");
+                rec.real = value->getDouble("");
+                records.push_back(rec);
+            } else if (JsonObject* obj = dynamic_cast<JsonObject*>(val)) {
+                if (obj->size() > UINT32_MAX) return false;
+                Frame frame = { obj, NULL, records.size(), 0 };
+                rec.tag = TAG_OBJECT;
+                rec.length = obj->size();
+                records.push_back(rec);
+                stack.push_back(frame);
+            } else if (JsonArray* ary = dynamic_cast<JsonArray*>(val)) {
+                if (ary->size() > UINT32_MAX) return false;
+                Frame frame = { NULL, ary, records.size(), 0 };
+                rec.tag = TAG_ARRAY;
+                rec.length = ary->size();
+                records.push_back(rec);
+                stack.push_back(frame);
+            } else {
+                return false;
+            }
+            val = NULL;
+        }
+        if (stack.empty()) return true;
+
+        // move on to the next field or element of the innermost container
+        Frame& top = stack.back();
+        if ((top.obj) && (top.next < top.obj->size())) {
+            Record key;
+            memset(&key, 0, sizeof(key));
+            string_view name = top.obj->getElementKeyView(top.next);
+            key.tag = TAG_KEY;
+            key.length = name.length();
+            key.offset = addText(name);
+            records.push_back(key);
+            val = top.obj->getElement(top.next++);
+        } else if ((top.ary) && (top.next < top.ary->size())) {
+            val = top.ary->getElement(top.next++);
+        } else {
+            // the container is complete
+            records[top.start].offset = records.size();
+            stack.pop_back();
+        }
+    }
+}
+
+//*******************************************************************
+// encode()
+//
+// encode a structure as a snapshot image.
+//
+// parameters:
+//    root - the structure to encode
+//    result - the string that receives the image
+// returns:
+//    true if the structure was encoded, otherwise false
+bool JsonSnapshot::encode(JsonAbstractValue* root, string& result) {
+    records.clear();
+    pool.clear();
+    strings.clear();
+    bool ok = (root) && (addValue(root));
+    strings.clear();
+    if (!ok) {
+        cerr << "unable to encode json snapshot" << endl;
+        return false;
+    }
+
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.order = SNAPSHOT_ORDER;
+    header.recordSize = sizeof(Record);
+    header.records = records.size();
+    header.poolSize = pool.size();
+
+    result.clear();
+    result.reserve(sizeof(header) + records.size() * sizeof(Record) + pool.size());
+    result.append((const char*)&header, sizeof(header));
+    result.append((const char*)records.data(), records.size() * sizeof(Record));
+    result.append(pool);
+    records.clear();
+    pool.clear();
+    return true;
+}
+
+//*******************************************************************
+// save()
+//
+// save a structure to a snapshot file.
+//
+// parameters:
+//    root - the structure to save
+//    filename - the name of the file to write
+// returns:
+//    true if the file was written, otherwise false
+bool JsonSnapshot::save(JsonAbstractValue* root, string filename) {
+    string result;
+    if (!encode(root, result)) return false;
+    ofstream out(filename, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        cerr << "unable to open snapshot file " << filename << endl;
+        return false;
+    }
+    out.write(result.data(), result.size());
+    return out.good();
+}
+
+//*******************************************************************
+// isSnapshot()
+//
+// determine whether a buffer holds a snapshot image that was written
+// by a machine with the same byte order and record layout.
+//
+// parameters:
+//    image - the buffer to check
+// returns:
+//    true if the buffer holds a snapshot image, otherwise false
+bool JsonSnapshot::isSnapshot(string_view image) {
+    SnapshotHeader header;
+    if (image.length() < sizeof(header)) return false;
+    memcpy(&header, image.data(), sizeof(header));
+    return (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0) &&
+        (header.order == SNAPSHOT_ORDER) && (header.recordSize == sizeof(Record));
+}
+
+//*******************************************************************
+// getRecord()
+//
+// read a record from the tape.
+//
+// parameters:
+//    pos - the position of the record
+//    rec - the record that receives the contents
+// returns:
+//    true if the record exists, otherwise false
+bool JsonSnapshot::Tape::getRecord(uint64_t pos, Record& rec) const {
+    if (pos >= count) return false;
+    memcpy(&rec, records + pos * sizeof(Record), sizeof(Record));
+    return true;
+}
+
+//*******************************************************************
+// getText()
+//
+// return the text of a key or value record.
+//
+// parameters:
+//    rec - the record
+//    str - the view that receives the text
+// returns:
+//    true if the text lies within the pool, otherwise false
+bool JsonSnapshot::Tape::getText(const Record& rec, string_view& str) const {
+    if ((rec.offset > text.length()) || (rec.length > text.length() - rec.offset)) return false;
+    str = text.substr(rec.offset, rec.length);
+    return true;
+}
+
+//*******************************************************************
+// check()
+//
+// check that the tape is well formed: every record has a known tag,
+// its text lies within the pool, each container holds the number of
+// children that it records and ends where it records, the fields of
+// objects have keys, and the tape holds exactly one value.  Nothing is
+// allocated for the nodes of the structure, and the containers being
+// checked are held on a stack rather than the call stack, so an image
+// cannot exhaust the call stack however deeply it is nested.  Once the
+// tape is checked, containers can be restored from it without
+// further checks failing.
+//
+// parameters:
+//    none
+// returns:
+//    true if the tape is well formed, otherwise false
+bool JsonSnapshot::Tape::check() const {
+    // a container that is being checked
+    struct Frame {
+        bool     object;     // true if the container is an object
+        uint32_t remaining;  // the number of children still to check
+        uint64_t end;        // the position of the record after the container
+    };
+    vector<Frame> stack;
+    uint64_t pos = 0;
+    while (true) {
+        Record rec;
+        string_view str;
+        if ((!stack.empty()) && (stack.back().object)) {
+            // the key of the next field
+            if ((!getRecord(pos++, rec)) || (rec.tag != TAG_KEY) || (!getText(rec, str))) return false;
+        }
+        if (!getRecord(pos++, rec)) return false;
+        if (rec.tag == TAG_VALUE) {
+            if ((!getText(rec, str)) || (rec.type > JSON_STRING)) return false;
+        } else if ((rec.tag != TAG_OBJECT) && (rec.tag != TAG_ARRAY)) {
+            return false;
+        } else if (rec.length > count - pos) {
+            return false;
+        }
+        if (!stack.empty()) stack.back().remaining--;
+        if (rec.tag != TAG_VALUE) {
+            Frame frame = { rec.tag == TAG_OBJECT, rec.length, rec.offset };
+            stack.push_back(frame);
+        }
+
+        // complete the containers that have all of their children
+        while ((!stack.empty()) && (stack.back().remaining == 0)) {
+            if (pos != stack.back().end) return false;
+            stack.pop_back();
+        }
+        if (stack.empty()) return pos == count;
+    }
+}
+
+//*******************************************************************
+// node()
+//
+// create the node for the value at the specified record.  Objects and
+// arrays are created empty and deferred to the tape, so their contents
+// are restored when they are first used.
+//
+// parameters:
+//    pos - the position of the record.  On return, the position of the
+//       record that follows the value.
+// returns:
+//    the node, or NULL if the record is not a value
+JsonAbstractValue* JsonSnapshot::Tape::node(uint64_t& pos) {
+    Record rec;
+    if (!getRecord(pos, rec)) return NULL;
+    if (rec.tag == TAG_VALUE) {
+        string_view str;
+        if (!getText(rec, str)) return NULL;
+        pos++;
+        return arena->make<JsonValue>(str, (JsonValueType)rec.type, rec.boolean != 0,
+            (long)rec.integer, rec.real);
+    }
+    if (rec.tag == TAG_OBJECT) {
+        JsonObject* obj = arena->make<JsonObject>(arena);
+        obj->defer(this, pos);
+        pos = rec.offset;
+        return obj;
+    }
+    if (rec.tag == TAG_ARRAY) {
+        JsonArray* ary = arena->make<JsonArray>(arena);
+        ary->defer(this, pos);
+        pos = rec.offset;
+        return ary;
+    }
+    return NULL;
+}
+
+//*******************************************************************
+// root()
+//
+// return the value that the tape holds.
+//
+// parameters:
+//    none
+// returns:
+//    the value, or NULL if the tape is empty
+JsonAbstractValue* JsonSnapshot::Tape::root() {
+    uint64_t pos = 0;
+    return node(pos);
+}
+
+//*******************************************************************
+// expand()
+//
+// read the fields of the object at the specified record from the tape.
+//
+// parameters:
+//    obj - the object to fill
+//    entry - the position of the object record
+// returns:
+//    true if the fields were read, otherwise false
+bool JsonSnapshot::Tape::expand(JsonObject* obj, unsigned long entry) {
+    Record rec;
+    if ((!getRecord(entry, rec)) || (rec.tag != TAG_OBJECT)) return false;
+    obj->reserve(rec.length);
+    uint64_t pos = entry + 1;
+    for (uint32_t i = 0; i < rec.length; i++) {
+        Record key;
+        string_view name;
+        if ((!getRecord(pos++, key)) || (!getText(key, name))) return false;
+        JsonAbstractValue* val = node(pos);
+        if (!val) return false;
+        obj->put(name, val);
+    }
+    return true;
+}
+
+//*******************************************************************
+// expand()
+//
+// read the elements of the array at the specified record from the tape.
+//
+// parameters:
+//    ary - the array to fill
+//    entry - the position of the array record
+// returns:
+//    true if the elements were read, otherwise false
+bool JsonSnapshot::Tape::expand(JsonArray* ary, unsigned long entry) {
+    Record rec;
+    if ((!getRecord(entry, rec)) || (rec.tag != TAG_ARRAY)) return false;
+    ary->reserve(rec.length);
+    uint64_t pos = entry + 1;
+    for (uint32_t i = 0; i < rec.length; i++) {
+        JsonAbstractValue* val = node(pos);
+        if (!val) return false;
+        ary->add(val);
+    }
+    return true;
+}
+
+//*******************************************************************
+// load()
+//
+// restore the structure held in a snapshot image.  The tape is checked
+// in full and then only the outermost value is created - the records
+// of each object and array are converted into nodes the first time the
+// container is used.  No text is parsed or copied.
+//
+// parameters:
+//    image - the snapshot image.  The values of the structure refer
+//       into the image, so it must outlive the structure.
+//    arena - the arena that will own the structure
+// returns:
+//    the restored structure, or NULL if the image is not a valid
+//    snapshot.  The structure is released by resetting the arena.
+JsonAbstractValue* JsonSnapshot::load(string_view image, JsonArena& arena) {
+    if (!isSnapshot(image)) {
+        cerr << "not a json snapshot" << endl;
+        return NULL;
+    }
+    SnapshotHeader header;
+    memcpy(&header, image.data(), sizeof(header));
+    unsigned long available = image.length() - sizeof(header);
+    if ((header.records > available / sizeof(Record)) ||
+        (header.poolSize != available - header.records * sizeof(Record))) {
+        cerr << "json snapshot is truncated" << endl;
+        return NULL;
+    }
+
+    Tape* tape = arena.make<Tape>(image.data() + sizeof(header), header.records,
+        image.substr(sizeof(header) + header.records * sizeof(Record)), &arena);
+    if (!tape->check()) {
+        cerr << "json snapshot is corrupt" << endl;
+        return NULL;
+    }
+    return tape->root();
+}
@@ -0,0 +1,375 @@
+//*******************************************************************
+//    JsonStructuralIndex.cpp
+//
+//    This file provides implementation for a class that builds an index
+//    of the structural characters within JSON text.  This file is
+//    intended to be used as part of the PICMG IoT library reference
+//    code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <cstring>
+#include "JsonStructuralIndex.h"
+
+// SIMD instructions are used on x86 processors unless JSON_NO_SIMD is defined
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)) && !defined(JSON_NO_SIMD)
+#define JSON_INDEX_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// the highest bit of a block mask
+#define HIGH_BIT (((uint64_t)1) << 63)
+
+// the character classes found within one 64-byte block of text - bit
+// n of each mask corresponds to byte n of the block
+struct BlockMasks {
+    uint64_t quote;        // double quote characters
+    uint64_t backslash;    // backslash characters
+    uint64_t structural;   // { } [ ] : , characters
+};
+
+//*******************************************************************
+// countTrailingZeros()
+//
+// This is a static helper that returns the position of the lowest set
+// bit of a non-zero mask.
+static inline unsigned int countTrailingZeros(uint64_t mask) {
+#ifdef _MSC_VER
+    unsigned long bit;
+    _BitScanForward64(&bit, mask);
+    return bit;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+//*******************************************************************
+// countBits()
+//
+// This is a static helper that returns the number of set bits in a
+// mask.
+static inline unsigned int countBits(uint64_t mask) {
+#ifdef _MSC_VER
+    return (unsigned int)__popcnt64(mask);
+#else
+    return __builtin_popcountll(mask);
+#endif
+}
+
+//*******************************************************************
+// prefixXor()
+//
+// This is a static helper that returns a mask in which each bit is the
+// exclusive-or of that bit and every lower bit of the input.  Applied
+// to the quote mask, the result marks the bytes inside strings.
+static inline uint64_t prefixXor(uint64_t mask) {
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+
+//*******************************************************************
+// escapedCharacters()
+//
+// This is a static helper that returns a mask of the characters in a
+// block that are escaped by a backslash.  A character is escaped when
+// it follows a run of backslashes of odd length.  Adding the first
+// backslash of each run that starts on an odd bit to the backslash mask
+// carries through the run and leaves a bit set just past its end; the
+// parity of that bit and of the run's start tells whether the run is of
+// odd length.  Runs that continue into the next block are handled by
+// the carry.
+//
+// parameters:
+//    backslash - the mask of backslashes within the block
+//    carry - 1 if the first character of the block is escaped.  On
+//       return, 1 if the first character of the next block is escaped.
+// returns:
+//    the mask of escaped characters
+static inline uint64_t escapedCharacters(uint64_t backslash, uint64_t& carry) {
+    const uint64_t EVEN_BITS = 0x5555555555555555ULL;
+    // a backslash that is itself escaped does not start a run
+    backslash &= ~carry;
+    uint64_t followsEscape = (backslash << 1) | carry;
+    uint64_t oddStarts = backslash & ~EVEN_BITS & ~followsEscape;
+    uint64_t evenSequences = oddStarts + backslash;
+    carry = (evenSequences < oddStarts) ? 1 : 0;
+    uint64_t invert = evenSequences << 1;
+    return (EVEN_BITS ^ invert) & followsEscape;
+}
+
+#ifndef JSON_INDEX_X86
+//*******************************************************************
+// classifyScalar()
+//
+// This is a static helper that classifies the characters of a 64-byte
+// block one byte at a time.
+static void classifyScalar(const char* block, BlockMasks& masks) {
+    masks.quote = 0;
+    masks.backslash = 0;
+    masks.structural = 0;
+    for (unsigned int i = 0; i < 64; i++) {
+        uint64_t bit = ((uint64_t)1) << i;
+        switch (block[i]) {
+        case '"':
+            masks.quote |= bit;
+            break;
+        case '\\':
+            masks.backslash |= bit;
+            break;
+        case '{': case '}': case '[': case ']': case ':': case ',':
+            masks.structural |= bit;
+            break;
+        }
+    }
+}
+#else
+//*******************************************************************
+// classifySse2()
+//
+// This is a static helper that classifies the characters of a 64-byte
+// block sixteen bytes at a time using SSE2 instructions.
+static void classifySse2(const char* block, BlockMasks& masks) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    // setting bit 0x20 maps '[' to '{' and ']' to '}'
+    const __m128i lower = _mm_set1_epi8(0x20);
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    masks.quote = 0;
+    masks.backslash = 0;
+    masks.structural = 0;
+    for (unsigned int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+        __m128i folded = _mm_or_si128(v, lower);
+        __m128i brackets = _mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close));
+        __m128i structural = _mm_or_si128(brackets,
+            _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+        masks.quote |= ((uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote))) << (16 * i);
+        masks.backslash |= ((uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash))) << (16 * i);
+        masks.structural |= ((uint64_t)(uint16_t)_mm_movemask_epi8(structural)) << (16 * i);
+    }
+}
+
+//*******************************************************************
+// classifyAvx2()
+//
+// This is a static helper that classifies the characters of a 64-byte
+// block thirty-two bytes at a time using AVX2 instructions.
+TARGET_AVX2 static void classifyAvx2(const char* block, BlockMasks& masks) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i lower = _mm256_set1_epi8(0x20);
+    const __m256i open = _mm256_set1_epi8('{');
+    const __m256i close = _mm256_set1_epi8('}');
+    masks.quote = 0;
+    masks.backslash = 0;
+    masks.structural = 0;
+    for (unsigned int i = 0; i < 2; i++) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(block + 32 * i));
+        __m256i folded = _mm256_or_si256(v, lower);
+        __m256i brackets = _mm256_or_si256(_mm256_cmpeq_epi8(folded, open), _mm256_cmpeq_epi8(folded, close));
+        __m256i structural = _mm256_or_si256(brackets,
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, colon), _mm256_cmpeq_epi8(v, comma)));
+        masks.quote |= ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote))) << (32 * i);
+        masks.backslash |= ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash))) << (32 * i);
+        masks.structural |= ((uint64_t)(uint32_t)_mm256_movemask_epi8(structural)) << (32 * i);
+    }
+}
+
+//*******************************************************************
+// hasAvx2()
+//
+// This is a static helper that returns true if the processor and
+// operating system support AVX2 instructions.
+static bool hasAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if ((!osxsave) || ((_xgetbv(0) & 6) != 6)) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+// the block classifier selected for this processor
+typedef void (*BlockClassifier)(const char* block, BlockMasks& masks);
+
+//*******************************************************************
+// selectClassifier()
+//
+// This is a static helper that returns the fastest block classifier
+// supported by the processor.
+static BlockClassifier selectClassifier() {
+#ifdef JSON_INDEX_X86
+    static const BlockClassifier classifier = hasAvx2() ? classifyAvx2 : classifySse2;
+    return classifier;
+#else
+    return classifyScalar;
+#endif
+}
+
+//*******************************************************************
+// JsonStructuralIndex()
+//
+// default constructor.
+JsonStructuralIndex::JsonStructuralIndex() : count(0) {
+}
+
+//*******************************************************************
+// build()
+//
+// build the index for the specified text.  The text is processed in
+// 64-byte blocks.  For each block, the quotes that are not escaped (that
+// do not follow an odd length run of backslashes) are found, and a running exclusive-or of those quotes
+// gives the bytes that lie within strings.  The quotes and the
+// structural characters outside strings are then added to the index.
+//
+// parameters:
+//    str - the text to index
+// returns:
+//    true if the index was built, false if the text is too large
+bool JsonStructuralIndex::build(string_view str) {
+    count = 0;
+    if (str.length() >= 0xFFFFFFFFUL) return false;
+
+    BlockClassifier classify = selectClassifier();
+    uint64_t prevEscape = 0;      // 1 if the first character of the block is escaped
+    uint64_t inString = 0;        // all ones if the previous block ended in a string
+    char tail[64];
+    for (unsigned long base = 0; base < str.length(); base += 64) {
+        // classify the block - the final partial block is padded with spaces
+        BlockMasks masks;
+        if (str.length() - base >= 64) {
+            classify(str.data() + base, masks);
+        } else {
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, str.data() + base, str.length() - base);
+            classify(tail, masks);
+        }
+
+        // find the quotes that are not escaped and the bytes within strings
+        uint64_t escaped = escapedCharacters(masks.backslash, prevEscape);
+        uint64_t quotes = masks.quote & ~escaped;
+        uint64_t strings = prefixXor(quotes) ^ inString;
+        inString = (uint64_t)(((int64_t)strings) >> 63);
+
+        // add the quotes and the structural characters outside of strings
+        // to the index
+        uint64_t entries = quotes | (masks.structural & ~strings);
+        if (count + 64 > positions.size()) {
+            unsigned long capacity = positions.size() * 2;
+            if (capacity < count + 64) capacity = count + 64;
+            positions.resize(capacity);
+        }
+        // the first eight positions are always written so that the loop
+        // does not branch on each bit - any extra positions written are
+        // beyond the end of the index and are overwritten by the next block
+        uint32_t* out = positions.data() + count;
+        unsigned int found = countBits(entries);
+        for (unsigned int i = 0; i < 8; i++) {
+            out[i] = (uint32_t)(base + countTrailingZeros(entries | HIGH_BIT));
+            entries &= entries - 1;
+        }
+        for (unsigned int i = 8; i < found; i++) {
+            out[i] = (uint32_t)(base + countTrailingZeros(entries));
+            entries &= entries - 1;
+        }
+        count += found;
+    }
+    return true;
+}
+
+//*******************************************************************
+// clear()
+//
+// empty the index.
+//
+// parameters:
+//    none
+// returns:
+//    void
+void JsonStructuralIndex::clear() {
+    count = 0;
+}
+
+//*******************************************************************
+// skipWhitespace()
+//
+// return the position of the first character at or after pos that is
+// not whitespace.  Any character that compares less than or equal to a
+// space is treated as whitespace, matching the JsonFactory tokenizer.
+//
+// parameters:
+//    str - the text to search
+//    pos - the position to start from
+// returns:
+//    the position of the first non-whitespace character, or the length
+//    of the text if there is none
+unsigned long JsonStructuralIndex::skipWhitespace(string_view str, unsigned long pos) {
+#ifdef JSON_INDEX_X86
+    // whitespace runs are usually short - only use vectors for long runs
+    if ((pos < str.length()) && (str[pos] > ' ')) return pos;
+    const __m128i space = _mm_set1_epi8(' ');
+    while (pos + 16 <= str.length()) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(str.data() + pos));
+        unsigned int mask = _mm_movemask_epi8(_mm_cmpgt_epi8(v, space));
+        if (mask) return pos + countTrailingZeros(mask);
+        pos += 16;
+    }
+#endif
+    while ((pos < str.length()) && (str[pos] <= ' ')) pos++;
+    return pos;
+}
+
+//*******************************************************************
+// implementation()
+//
+// return the name of the instruction set used to build the index.
+//
+// parameters:
+//    none
+// returns:
+//    "avx2", "sse2" or "scalar"
+const char* JsonStructuralIndex::implementation() {
+#ifdef JSON_INDEX_X86
+    return (selectClassifier() == classifyAvx2) ? "avx2" : "sse2";
+#else
+    return "scalar";
+#endif
+}
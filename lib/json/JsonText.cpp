@@ -0,0 +1,467 @@
+//*******************************************************************
+//    JsonText.cpp
+//
+//    This file provides implementation for a set of functions that
+//    process the text of JSON strings.  This file is intended to be
+//    used as part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <cstring>
+#include "JsonText.h"
+
+// SIMD instructions are used on x86 processors unless JSON_NO_SIMD is defined
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)) && !defined(JSON_NO_SIMD)
+#define JSON_TEXT_X86
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// the character used in place of invalid UTF-8 sequences
+#define REPLACEMENT_CHARACTER 0xFFFD
+
+#ifdef JSON_TEXT_X86
+//*******************************************************************
+// countTrailingZeros()
+//
+// This is a static helper that returns the position of the lowest set
+// bit of a non-zero mask.
+static inline unsigned int countTrailingZeros(unsigned int mask) {
+#ifdef _MSC_VER
+    unsigned long bit;
+    _BitScanForward(&bit, mask);
+    return bit;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+//*******************************************************************
+// plainLength()
+//
+// This is a static helper that returns the number of characters at
+// the start of the text that are ASCII (and, if requested, are not a
+// backslash).  Sixteen characters are checked at a time where SSE2
+// instructions are available.
+//
+// parameters:
+//    str - the text to check
+//    len - the length of the text
+//    stopAtBackslash - true if a backslash ends the plain text
+// returns:
+//    the number of plain characters at the start of the text
+static unsigned long plainLength(const char* str, unsigned long len, bool stopAtBackslash) {
+    unsigned long pos = 0;
+#ifdef JSON_TEXT_X86
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (pos + 16 <= len) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(str + pos));
+        unsigned int mask = _mm_movemask_epi8(v);
+        if (stopAtBackslash) mask |= _mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash));
+        if (mask) return pos + countTrailingZeros(mask);
+        pos += 16;
+    }
+#endif
+    while ((pos < len) && ((unsigned char)str[pos] < 0x80) && ((!stopAtBackslash) || (str[pos] != '\\'))) pos++;
+    return pos;
+}
+
+//*******************************************************************
+// readUtf8()
+//
+// This is a static helper that reads one UTF-8 encoded character.
+// Overlong encodings, surrogates and values above U+10FFFF are
+// rejected.
+//
+// parameters:
+//    str - the text of the character
+//    len - the number of characters available
+//    cp - set to the code point of the character
+// returns:
+//    the length of the character in bytes, or 0 if it is invalid
+static unsigned int readUtf8(const char* str, unsigned long len, unsigned long& cp) {
+    unsigned char c = str[0];
+    if (c < 0x80) {
+        cp = c;
+        return 1;
+    }
+    unsigned int count;
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    if ((c >= 0xC2) && (c <= 0xDF)) {
+        count = 2;
+        cp = c & 0x1F;
+    } else if ((c >= 0xE0) && (c <= 0xEF)) {
+        count = 3;
+        cp = c & 0x0F;
+        if (c == 0xE0) low = 0xA0;
+        if (c == 0xED) high = 0x9F;
+    } else if ((c >= 0xF0) && (c <= 0xF4)) {
+        count = 4;
+        cp = c & 0x07;
+        if (c == 0xF0) low = 0x90;
+        if (c == 0xF4) high = 0x8F;
+    } else {
+        return 0;
+    }
+    if (len < count) return 0;
+    for (unsigned int i = 1; i < count; i++) {
+        unsigned char b = str[i];
+        if ((b < low) || (b > high)) return 0;
+        low = 0x80;
+        high = 0xBF;
+        cp = (cp << 6) | (b & 0x3F);
+    }
+    return count;
+}
+
+//*******************************************************************
+// writeUtf8()
+//
+// This is a static helper that writes the UTF-8 encoding of a code
+// point.
+//
+// parameters:
+//    cp - the code point to write
+//    out - the buffer to write to (with room for four characters)
+// returns:
+//    the number of characters written
+static unsigned int writeUtf8(unsigned long cp, char* out) {
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+//*******************************************************************
+// readHex()
+//
+// This is a static helper that reads the four hexadecimal digits of a
+// \u escape sequence.
+//
+// parameters:
+//    str - the text
+//    pos - the position of the first digit
+//    value - set to the value of the digits
+// returns:
+//    true if four hexadecimal digits were found, otherwise false
+static bool readHex(string_view str, unsigned long pos, unsigned long& value) {
+    if (pos + 4 > str.length()) return false;
+    value = 0;
+    for (unsigned long i = pos; i < pos + 4; i++) {
+        char c = str[i];
+        value <<= 4;
+        if ((c >= '0') && (c <= '9')) {
+            value |= c - '0';
+        } else if ((c >= 'a') && (c <= 'f')) {
+            value |= c - 'a' + 10;
+        } else if ((c >= 'A') && (c <= 'F')) {
+            value |= c - 'A' + 10;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+//*******************************************************************
+// isValidUtf8()
+//
+// return true if the text is well formed UTF-8.
+//
+// parameters:
+//    str - the text to check
+// returns:
+//    true if the text is valid, otherwise false
+bool JsonText::isValidUtf8(string_view str) {
+    unsigned long pos = 0;
+    while (pos < str.length()) {
+        pos += plainLength(str.data() + pos, str.length() - pos, false);
+        if (pos >= str.length()) break;
+        unsigned long cp;
+        unsigned int count = readUtf8(str.data() + pos, str.length() - pos, cp);
+        if (!count) return false;
+        pos += count;
+    }
+    return true;
+}
+
+//*******************************************************************
+// hasEscapes()
+//
+// return true if the text holds escape sequences.
+//
+// parameters:
+//    str - the text to check
+// returns:
+//    true if the text contains a backslash, otherwise false
+bool JsonText::hasEscapes(string_view str) {
+    return (!str.empty()) && (memchr(str.data(), '\\', str.length()) != NULL);
+}
+
+//*******************************************************************
+// decode()
+//
+// decode the escape sequences of the text of a JSON string and
+// validate the result as UTF-8.  Runs of plain text are copied
+// unchanged.  A \u escape for a high surrogate must be followed by one
+// for a low surrogate, and the pair is decoded as a single character.
+//
+// parameters:
+//    str - the text of the string, without its quotes
+//    out - the buffer to receive the decoded text, with room for
+//       str.length() characters
+// returns:
+//    the length of the decoded text, or -1 if the text is invalid
+long JsonText::decode(string_view str, char* out) {
+    unsigned long pos = 0;
+    unsigned long len = 0;
+    while (pos < str.length()) {
+        // copy the plain text up to the next escape or non-ASCII character
+        unsigned long run = plainLength(str.data() + pos, str.length() - pos, true);
+        memcpy(out + len, str.data() + pos, run);
+        pos += run;
+        len += run;
+        if (pos >= str.length()) break;
+
+        if (str[pos] != '\\') {
+            // here if the character is not ASCII
+            unsigned long cp;
+            unsigned int count = readUtf8(str.data() + pos, str.length() - pos, cp);
+            if (!count) return -1;
+            memcpy(out + len, str.data() + pos, count);
+            pos += count;
+            len += count;
+            continue;
+        }
+
+        // here if the character starts an escape sequence
+        if (pos + 1 >= str.length()) return -1;
+        char c = str[pos + 1];
+        pos += 2;
+        switch (c) {
+        case '"': case '\\': case '/':
+            out[len++] = c;
+            break;
+        case 'b':
+            out[len++] = '\b';
+            break;
+        case 'f':
+            out[len++] = '\f';
+            break;
+        case 'n':
+            out[len++] = '\n';
+            break;
+        case 'r':
+            out[len++] = '\r';
+            break;
+        case 't':
+            out[len++] = '\t';
+            break;
+        case 'u': {
+            unsigned long cp;
+            if (!readHex(str, pos, cp)) return -1;
+            pos += 4;
+            if ((cp >= 0xDC00) && (cp <= 0xDFFF)) return -1;
+            if ((cp >= 0xD800) && (cp <= 0xDBFF)) {
+                // a high surrogate must be followed by a low surrogate
+                unsigned long low;
+                if ((pos + 2 > str.length()) || (str[pos] != '\\') || (str[pos + 1] != 'u')) return -1;
+                if ((!readHex(str, pos + 2, low)) || (low < 0xDC00) || (low > 0xDFFF)) return -1;
+                pos += 6;
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            }
+            len += writeUtf8(cp, out + len);
+            break;
+        }
+        default:
+            return -1;
+        }
+    }
+    return len;
+}
+
+//*******************************************************************
+// decode()
+//
+// decode the escape sequences of the text of a JSON string into a
+// string.
+//
+// parameters:
+//    str - the text of the string, without its quotes
+//    out - the string to receive the decoded text
+// returns:
+//    true if the text was decoded, false if it is invalid (out is then
+//    left empty)
+bool JsonText::decode(string_view str, string& out) {
+    out.resize(str.length());
+    long len = decode(str, &out[0]);
+    if (len < 0) {
+        out.clear();
+        return false;
+    }
+    out.resize(len);
+    return true;
+}
+
+//*******************************************************************
+// decode()
+//
+// decode the escape sequences of the text of a JSON string into the
+// arena.  Text without escape sequences is only validated, so it can
+// continue to refer to the original buffer.
+//
+// parameters:
+//    str - the text of the string, without its quotes
+//    arena - the arena to hold the decoded text
+//    copy - true if text without escape sequences should be copied into
+//       the arena
+//    ok - set to false if the text is invalid, otherwise true
+// returns:
+//    the decoded text, or an empty view if the text is invalid
+string_view JsonText::decode(string_view str, JsonArena& arena, bool copy, bool& ok) {
+    ok = true;
+    if (!hasEscapes(str)) {
+        ok = isValidUtf8(str);
+        if (!ok) return string_view();
+        return (copy) ? arena.copy(str) : str;
+    }
+    char* buffer = (char*)arena.allocate(str.length(), 1);
+    long len = decode(str, buffer);
+    ok = (len >= 0);
+    if (!ok) return string_view();
+    return string_view(buffer, len);
+}
+
+//*******************************************************************
+// encode()
+//
+// append text to a string as the contents of a JSON string, so that
+// decode() returns the original text.  Quotes, backslashes and the
+// common control characters use their short escapes, other control
+// characters are written as \u escapes.
+//
+// parameters:
+//    str - the text to encode
+//    out - the string to append the encoded text to
+// returns:
+//    void
+void JsonText::encode(string_view str, string& out) {
+    static const char hex[] = "0123456789abcdef";
+    for (unsigned long i = 0; i < str.length(); i++) {
+        unsigned char ch = (unsigned char)str[i];
+        switch (ch) {
+        case '"':  out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\b': out.append("\\b"); break;
+        case '\f': out.append("\\f"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        default:
+            if (ch < 0x20) {
+                out.append("\\u00");
+                out += hex[ch >> 4];
+                out += hex[ch & 15];
+            } else {
+                out += (char)ch;
+            }
+            break;
+        }
+    }
+}
+
+//*******************************************************************
+// utf8ToUtf16be()
+//
+// append the UTF-16BE encoding of UTF-8 text to a string.  Runs of
+// ASCII text are widened sixteen characters at a time where SSE2
+// instructions are available.  Characters outside the basic
+// multilingual plane are encoded as surrogate pairs.
+//
+// parameters:
+//    str - the UTF-8 text to transcode
+//    out - the string to append the UTF-16BE bytes to
+// returns:
+//    true if the text was valid, false if invalid sequences were
+//    replaced by U+FFFD
+bool JsonText::utf8ToUtf16be(string_view str, string& out) {
+    // each input character produces at most two output characters
+    unsigned long start = out.size();
+    out.resize(start + 2 * str.length());
+    char* dst = &out[0] + start;
+    unsigned long pos = 0;
+    unsigned long len = 0;
+    bool result = true;
+    while (pos < str.length()) {
+#ifdef JSON_TEXT_X86
+        const __m128i zero = _mm_setzero_si128();
+        while (pos + 16 <= str.length()) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(str.data() + pos));
+            if (_mm_movemask_epi8(v)) break;
+            _mm_storeu_si128((__m128i*)(dst + len), _mm_unpacklo_epi8(zero, v));
+            _mm_storeu_si128((__m128i*)(dst + len + 16), _mm_unpackhi_epi8(zero, v));
+            pos += 16;
+            len += 32;
+        }
+        if (pos >= str.length()) break;
+#endif
+        unsigned long cp;
+        unsigned int count = readUtf8(str.data() + pos, str.length() - pos, cp);
+        if (!count) {
+            cp = REPLACEMENT_CHARACTER;
+            count = 1;
+            result = false;
+        }
+        pos += count;
+        if (cp >= 0x10000) {
+            unsigned long high = 0xD800 + ((cp - 0x10000) >> 10);
+            unsigned long low = 0xDC00 + ((cp - 0x10000) & 0x3FF);
+            dst[len++] = (char)(high >> 8);
+            dst[len++] = (char)(high & 0xFF);
+            dst[len++] = (char)(low >> 8);
+            dst[len++] = (char)(low & 0xFF);
+        } else {
+            dst[len++] = (char)(cp >> 8);
+            dst[len++] = (char)(cp & 0xFF);
+        }
+    }
+    out.resize(start + len);
+    return result;
+}
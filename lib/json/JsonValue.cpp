@@ -28,21 +28,29 @@
 //    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 #include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
 #include "JsonValue.h"
+#include "JsonArena.h"
+#include "JsonHash.h"
+#include "JsonSerializer.h"
 
 //*******************************************************************
 // trimend()
 //
 // This is a static helper function that trims whitespace from the end
-// of a given string.  The new string is returned as a result.
+// of a given string.  The trimmed view is returned as a result.
 //
 // parameters:
 //   str - the string to trim
 // returns:
-//   a new version of the string with whitespace removed from the end
-static string trimend(const string& str)
+//   a view of the string with whitespace removed from the end
+static string_view trimend(string_view str)
 {
     unsigned long end = str.find_last_not_of(" \f\n\r\t\v");
+    if (end == string_view::npos) return str.substr(0, 0);
     return str.substr(0, end+1);
 }
 
@@ -57,37 +65,150 @@ static string trimend(const string& str)
 //   str1, str2 - the strings to compare
 // returns:
 //   true if equivalent, otherwise, false.
-static bool match_no_case(string str1, string str2) {
-    // make str1 and str2 upper-casae
-    transform(str1.begin(), str1.end(), str1.begin(), ::toupper);
-    transform(str2.begin(), str2.end(), str2.begin(), ::toupper);
-    return (str1.compare(str2)==0)?true:false;
+static bool match_no_case(string_view str1, string_view str2) {
+    if (str1.length() != str2.length()) return false;
+    for (unsigned long i = 0; i < str1.length(); i++) {
+        if (toupper((unsigned char)str1[i]) != toupper((unsigned char)str2[i])) return false;
+    }
+    return true;
+}
+
+//*******************************************************************
+// terminate()
+//
+// This is a static helper that copies the leading portion of a value
+// into a null-terminated buffer so that it can be passed to the
+// C library numeric conversion functions.  Values that are borrowed
+// from a source buffer are not null-terminated.
+//
+// parameters:
+//   str - the string to copy
+//   buffer - the destination buffer
+//   size - the size of the destination buffer
+// returns:
+//   a pointer to the null-terminated buffer
+static const char* terminate(string_view str, char* buffer, unsigned long size) {
+    unsigned long len = min((unsigned long)str.length(), size - 1);
+    str.copy(buffer, len);
+    buffer[len] = 0;
+    return buffer;
 }
 
 //*******************************************************************
 // JsonValue()
 //
 // default constructor.
-JsonValue::JsonValue() {
+JsonValue::JsonValue() : type(JSON_STRING), boolean(false), integer(0), real(0.0) {
 }
 
 //*******************************************************************
 // JsonValue()
 //
 // Copy constructor - initialize this object as a deep clone of the 
-// specified object.
+// specified object.  The new object always owns a copy of the text.
 // 
 // parameters:
 //    val - a reference of the object to clone.
-JsonValue::JsonValue(const JsonValue &val) {
-    value = val.value;
+JsonValue::JsonValue(const JsonValue &val) : 
+    JsonAbstractValue(val),
+    storage(val.value), 
+    type(val.type), 
+    boolean(val.boolean), 
+    integer(val.integer), 
+    real(val.real) 
+{
+    value = storage;
+}
+
+//*******************************************************************
+// JsonValue()
+//
+// Restoring constructor.  Initialize this object from text whose
+// interpretations are already known, so the text is not examined.
+// The object refers to the text rather than owning a copy of it.
+//
+// parameters:
+//    value - the text of the value
+//    type - the type of the value
+//    boolean - the boolean interpretation of the value
+//    integer - the integer interpretation of the value
+//    real - the floating-point interpretation of the value
+JsonValue::JsonValue(string_view value, JsonValueType type, bool boolean, long integer, double real) :
+    value(value),
+    type(type),
+    boolean(boolean),
+    integer(integer),
+    real(real)
+{
+}
+
+//*******************************************************************
+// operator=()
+//
+// Assignment operator - make this object a deep clone of the
+// specified object.  The object always owns a copy of the text.
+// 
+// parameters:
+//    val - a reference of the object to clone.
+JsonValue& JsonValue::operator=(const JsonValue &val) {
+    if (this != &val) {
+        invalidateHash();
+        noteModified();
+        storage = string(val.value);
+        value = storage;
+        type = val.type;
+        boolean = val.boolean;
+        integer = val.integer;
+        real = val.real;
+    }
+    return *this;
+}
+
+//*******************************************************************
+// JsonValue()
+//
+// Move constructor - initialize this object with the contents of the
+// specified object.  Owned text is moved rather than copied, and
+// borrowed text remains borrowed.
+// 
+// parameters:
+//    val - a reference of the object to move from.
+JsonValue::JsonValue(JsonValue &&val) : JsonValue() {
+    *this = std::move(val);
+}
+
+//*******************************************************************
+// operator=()
+//
+// Move assignment operator - take the contents of the specified
+// object.  The source is left as an empty string value.
+// 
+// parameters:
+//    val - a reference of the object to move from.
+JsonValue& JsonValue::operator=(JsonValue &&val) {
+    if (this != &val) {
+        invalidateHash();
+        noteModified();
+        bool owned = (val.value.data() == val.storage.data());
+        storage = std::move(val.storage);
+        value = (owned) ? string_view(storage) : val.value;
+        type = val.type;
+        boolean = val.boolean;
+        integer = val.integer;
+        real = val.real;
+        val.storage.clear();
+        val.value = string_view();
+        val.type = JSON_STRING;
+    }
+    return *this;
 }
 
 //*******************************************************************
 // JsonValue()
 //
 // Initialization constructor.  Initialize this object from the
-// specified string.
+// specified string.  The type of the value is inferred from the
+// text.
 //
 // parameters:
 //    value - the string to initialize this object from
@@ -96,8 +217,198 @@ JsonValue::JsonValue(string value) {
         this->value = "NULL";
     }
     else {
+        storage = std::move(value);
+        this->value = storage;
+    }
+    classify(false);
+}
+
+//*******************************************************************
+// JsonValue()
+//
+// Initialization constructor.  Initialize this object from the
+// specified view.  If borrow is true, the object refers to the
+// viewed text directly, and the underlying buffer must outlive the
+// object.  Otherwise, the object owns a copy of the text.
+//
+// parameters:
+//    value - the text to initialize this object from
+//    borrow - true if the text should be referenced rather than copied
+//    quoted - true if the text was a quoted json string, otherwise the
+//       type of the value is inferred from the text.
+JsonValue::JsonValue(string_view value, bool borrow, bool quoted) {
+    if (match_no_case(value,"null")) {
+        this->value = "NULL";
+    }
+    else if (borrow) {
         this->value = value;
     }
+    else {
+        storage = string(value);
+        this->value = storage;
+    }
+    classify(quoted);
+}
+
+//*******************************************************************
+// classify()
+//
+// determine the type of the value and convert its text to the
+// numeric and boolean representations returned by the getters.  The
+// conversions match those of the C library (atol/atof) so that quoted
+// numbers may also be read as numbers.
+//
+// parameters:
+//    quoted - true if the text was a quoted json string
+// returns:
+//    void
+void JsonValue::classify(bool quoted) {
+    string_view text = trimend(value);
+    boolean = match_no_case(text, "true");
+    integer = 0;
+    real = 0.0;
+
+    // convert the numeric representations - text that cannot begin a
+    // number converts to zero
+    bool numeric = false;
+    bool inRange = true;
+    if ((!text.empty()) && (strchr("0123456789+-. \f\n\r\t\v", text[0]))) {
+        char buffer[64];
+        char* endptr;
+        const char* str = terminate(text, buffer, sizeof(buffer));
+        errno = 0;
+        integer = strtol(str, NULL, 10);
+        inRange = (errno != ERANGE);
+        real = strtod(str, &endptr);
+        numeric = (text.length() < sizeof(buffer)) && (endptr != str) && (*endptr == 0) &&
+            (text.find_first_not_of("0123456789+-.eE") == string_view::npos);
+    }
+
+    // determine the type of the value
+    if (quoted) {
+        type = JSON_STRING;
+    } else if (match_no_case(text, "null")) {
+        type = JSON_NULL;
+    } else if ((boolean) || (match_no_case(text, "false"))) {
+        type = JSON_BOOLEAN;
+    } else if ((numeric) && (inRange) && (text.find_first_of(".eE") == string_view::npos)) {
+        type = JSON_INTEGER;
+    } else if (numeric) {
+        type = JSON_DOUBLE;
+    } else {
+        type = JSON_STRING;
+    }
+}
+
+//*******************************************************************
+// wholeNumber()
+//
+// determine whether a floating-point number holds a whole number that
+// can be represented as a long integer.
+//
+// parameters:
+//    number - the number to test
+//    whole - set to the whole number if there is one
+// returns:
+//    true if the number is a whole number within range, otherwise false
+static bool wholeNumber(double number, long& whole) {
+    if ((number < (double)LONG_MIN) || (number >= -(double)LONG_MIN)) return false;
+    whole = (long)number;
+    return (double)whole == number;
+}
+
+//*******************************************************************
+// computeHash()
+//
+// compute the structural hash of the value.  Numbers are hashed by
+// value and other values by their text, so the same value written in
+// different ways (1.50 and 1.5, or 1.0 and 1) has the same hash.
+// 
+// parameters:
+//    none
+// returns:
+//    the hash of the value
+uint64_t JsonValue::computeHash() {
+    switch (type) {
+    case JSON_NULL:
+        return JsonHash::combine(JsonHash::SEED_NULL, 0);
+    case JSON_BOOLEAN:
+        return JsonHash::combine(JsonHash::SEED_BOOLEAN, boolean);
+    case JSON_INTEGER:
+        return JsonHash::combine(JsonHash::SEED_INTEGER, (uint64_t)integer);
+    case JSON_DOUBLE: {
+        // a whole number is hashed as the integer it is equal to
+        long whole;
+        if (wholeNumber(real, whole)) return JsonHash::combine(JsonHash::SEED_INTEGER, (uint64_t)whole);
+        uint64_t bits;
+        memcpy(&bits, &real, sizeof(bits));
+        return JsonHash::combine(JsonHash::SEED_DOUBLE, bits);
+    }
+    default:
+        return JsonHash::bytes(trimend(value), JsonHash::SEED_STRING);
+    }
+}
+
+//*******************************************************************
+// equals()
+//
+// return true if this value is the same as another.  Values are
+// compared in the same way as they are hashed, so numbers are equal
+// if they have the same value (RFC 6902 section 4.6) - an integer is
+// equal to a floating-point number that holds the same whole number.
+// 
+// parameters:
+//    val - the value to compare with
+// returns:
+//    true if the values are the same, otherwise false
+bool JsonValue::equals(JsonValue& val) {
+    long whole;
+    if ((type == JSON_INTEGER) && (val.type == JSON_DOUBLE)) {
+        return (wholeNumber(val.real, whole)) && (whole == integer);
+    }
+    if ((type == JSON_DOUBLE) && (val.type == JSON_INTEGER)) {
+        return (wholeNumber(real, whole)) && (whole == val.integer);
+    }
+    if (type != val.type) return false;
+    switch (type) {
+    case JSON_NULL:
+        return true;
+    case JSON_BOOLEAN:
+        return boolean == val.boolean;
+    case JSON_INTEGER:
+        return integer == val.integer;
+    case JSON_DOUBLE:
+        return real == val.real;
+    default:
+        return trimend(value) == trimend(val.value);
+    }
+}
+
+//*******************************************************************
+// getType()
+//
+// returns the type of the value.
+// 
+// parameters:
+//    none
+// returns:
+//    the type of the value
+JsonValueType JsonValue::getType() {
+    return type;
+}
+
+//*******************************************************************
+// getText()
+//
+// returns the text of the value exactly as it was stored.  Unlike
+// getValueView(), trailing whitespace is not removed.
+// 
+// parameters:
+//    none
+// returns:
+//    a view of the value text
+string_view JsonValue::getText() {
+    return value;
 }
 
 //*******************************************************************
@@ -110,9 +421,22 @@ JsonValue::JsonValue(string value) {
 // returns:
 //    a pointer to a deep clone of the object
 JsonAbstractValue * JsonValue::copy() {
-    JsonValue* val = new JsonValue;
-    val->value = value;
-    return val;
+    return new JsonValue(*this);
+}
+
+//*******************************************************************
+// clone()
+//
+// create a deep clone of this JsonValue within an arena.  The text is
+// copied into the arena and the interpretations of the text are kept.
+// 
+// parameters:
+//    arena - the arena to allocate the clone from (or NULL for the heap)
+// returns:
+//    a pointer to a deep clone of the object
+JsonAbstractValue * JsonValue::clone(JsonArena* arena) {
+    if (!arena) return copy();
+    return arena->make<JsonValue>(arena->copy(value), type, boolean, integer, real);
 }
 
 //*******************************************************************
@@ -130,20 +454,9 @@ JsonAbstractValue * JsonValue::copy() {
 // returns:
 //    void
 void JsonValue::dump(ostream& out, bool pretty, int indent,bool useIndent) {
-    if ((useIndent)&&(pretty)) for (int i = 0;i < indent;i++) out<<" ";
-    bool isNumber = false;
-    char* endptr;
-
-    string trimmed = trimend(value.c_str());
-    strtod(trimmed.c_str(), &endptr);
-    if (*endptr == 0) isNumber |= true;
-    strtol(trimmed.c_str(), &endptr, 10);
-    if (!isNumber) {
-        out << "\"" << value << "\"";
-    }
-    else {
-        out << trimmed;
-    }
+    JsonSerializer serializer(pretty);
+    serializer.write(this, indent, useIndent);
+    serializer.flush(out);
 }
 
 //*******************************************************************
@@ -172,13 +485,31 @@ void JsonValue::dump(ostream& out, bool pretty) {
 //       select a specific field.  This should be "" for JsonValue objects.
 // returns:
 //    a string representation of the value.
-string JsonValue::getValue(string specifier) {
+string JsonValue::getValue(string_view specifier) {
     if (specifier == "") {
-        return trimend(value);
+        return string(trimend(value));
     }
     return "";
 }
 
+//*******************************************************************
+// getValueView()
+//
+// returns a view of the value text.  Unlike getValue(), no copy of the
+// text is made.
+// 
+// parameters:
+//    specifier - used by other typues of AbstractJsonValue types to
+//       select a specific field.  This should be "" for JsonValue objects.
+// returns:
+//    a view of the value text that is valid for the lifetime of the value.
+string_view JsonValue::getValueView(string_view specifier) {
+    if (specifier.empty()) {
+        return trimend(value);
+    }
+    return string_view();
+}
+
 //*******************************************************************
 // getInteger()
 //
@@ -189,9 +520,9 @@ string JsonValue::getValue(string specifier) {
 //       select a specific field.  This should be "" for JsonValue objects.
 // returns:
 //    an integer representation of the value.
-long JsonValue::getInteger(string specifier) {
+long JsonValue::getInteger(string_view specifier) {
     if (specifier == "") {
-        return atol(value.c_str());
+        return integer;
     }
     return 0;
 }
@@ -206,9 +537,9 @@ long JsonValue::getInteger(string specifier) {
 //       select a specific field.  This should be "" for JsonValue objects.
 // returns:
 //    a double representation of the value.
-double  JsonValue::getDouble(string specifier) {
+double  JsonValue::getDouble(string_view specifier) {
     if (specifier == "") {
-        return atof(value.c_str());
+        return real;
     }
     return 0.0;
 }
@@ -223,9 +554,9 @@ double  JsonValue::getDouble(string specifier) {
 //       select a specific field.  This should be "" for JsonValue objects.
 // returns:
 //    a bool representation of the value.
-bool JsonValue::getBoolean(string specifier) {
+bool JsonValue::getBoolean(string_view specifier) {
     if (specifier == "") {
-        if (match_no_case(value,"true")) return true;
+        return boolean;
     }
     return false;
 }
@@ -240,6 +571,6 @@ bool JsonValue::getBoolean(string specifier) {
 //       select a specific field.  This should be "" for JsonValue objects.
 // returns:
 //    a string representation of the handle.
-string  JsonValue::getHandle(string specifier) {
+string  JsonValue::getHandle(string_view specifier) {
     return getValue(specifier);
 };
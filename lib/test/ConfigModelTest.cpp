@@ -0,0 +1,344 @@
+//*******************************************************************
+//    ConfigModelTest.cpp
+//
+//    This file provides a test program for the typed config model used
+//    by the builder.  It checks that reading a config from its text and
+//    from a json structure fill the model in the same way, and that
+//    configs that do not fit the expected layout are rejected with the
+//    location of the problem.  This file is intended to be used as part
+//    of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "ConfigModel.h"
+#include "JsonFactory.h"
+#include "JsonTest.h"
+
+using namespace std;
+
+// the directory holding the sample configs
+#ifndef CONFIG_DIR
+#define CONFIG_DIR "src/builder"
+#endif
+
+// a small config holding each part of the model
+static const char* CONFIG = R"({
+    "capabilities": { "device": "test", "channels": [
+        { "name": "ch1", "type": "analog_in", "accuracy": 0.5, "precision": 12, "minValueAtPin": 0, "maxValueAtPin": 5 }
+    ] },
+    "configuration": {
+        "fruRecords": [ { "vendorIANA": 412, "fields": [
+            { "type": 1, "format": "string", "value": "abc" },
+            { "type": 2, "format": "bytes", "value": [1, 2, 255] }
+        ] } ],
+        "logicalEntities": [ {
+            "name": "entity", "entityVendorIANA": 412, "vendorEntityID": 7, "unused": { "x": [1, 2] },
+            "ioBindings": [ {
+                "name": "binding", "bindingType": "sensor", "boundChannel": "ch1", "isVirtual": false,
+                "stateSet": null, "sensorID": 3, "normalMax": 4.5,
+                "inputCurve": [ { "in": 0, "out": 0 }, { "in": 1, "out": 2.5 } ],
+                "sensor": { "nominalValue": 2, "responseCurve": [ { "in": 0, "out": 1 } ] },
+                "effecter": null
+            } ],
+            "parameters": [ { "name": "p", "type": "int", "value": 3 } ]
+        } ]
+    },
+    "oemStateSets": [ { "stateSetID": 32768, "vendorIANA": 412, "oemStateValueRecords": [
+        { "minStateValue": 0, "maxStateValue": 1, "languageTags": ["en", "fr"], "stateName": ["off", "arr\u00eat"] }
+    ] } ]
+})";
+
+// the members of a binding that hold a single value
+static ConfigValue ConfigBinding::* const BINDING_VALUES[] = {
+    &ConfigBinding::name, &ConfigBinding::bindingType, &ConfigBinding::boundChannel, &ConfigBinding::isVirtual,
+    &ConfigBinding::includeInPdr, &ConfigBinding::sensorID, &ConfigBinding::effecterID, &ConfigBinding::stateSet,
+    &ConfigBinding::stateSetVendor, &ConfigBinding::usedStates, &ConfigBinding::stateWhenHigh,
+    &ConfigBinding::stateWhenLow, &ConfigBinding::defaultState, &ConfigBinding::defaultValue,
+    &ConfigBinding::normalMin, &ConfigBinding::normalMax, &ConfigBinding::upperThresholdWarning,
+    &ConfigBinding::upperThresholdCritical, &ConfigBinding::upperThresholdFatal,
+    &ConfigBinding::lowerThresholdWarning, &ConfigBinding::lowerThresholdCritical,
+    &ConfigBinding::lowerThresholdFatal, &ConfigBinding::physicalBaseUnit, &ConfigBinding::physicalUnitModifier,
+    &ConfigBinding::physicalRateUnit, &ConfigBinding::physicalAuxUnit, &ConfigBinding::physicalAuxUnitModifier,
+    &ConfigBinding::physicalAuxRateUnit, &ConfigBinding::rel, &ConfigBinding::inputGearingRatio,
+    &ConfigBinding::outputGearingRatio
+};
+
+//*******************************************************************
+// describe()
+//
+// append a description of a value to a string.
+//
+// parameters:
+//    val - the value
+//    out - the string to append to
+// returns:
+//    void
+static void describe(const ConfigValue& val, string& out) {
+    if (!val.present) {
+        out += "-;";
+        return;
+    }
+    out += string(val.text) + "," + to_string(val.integer) + "," + to_string(val.real) + "," +
+        to_string(val.boolean) + ";";
+}
+
+//*******************************************************************
+// describe()
+//
+// append a description of a curve to a string.
+//
+// parameters:
+//    curve - the curve
+//    out - the string to append to
+// returns:
+//    void
+static void describe(const ConfigCurve& curve, string& out) {
+    out += "curve";
+    for (unsigned long i = 0; i < curve.in.size(); i++) {
+        out += " " + to_string(curve.in[i]) + ":" + to_string(curve.out[i]);
+    }
+    out += ";";
+}
+
+//*******************************************************************
+// describe()
+//
+// return a description of every field of a model, so that two models
+// can be compared.
+//
+// parameters:
+//    model - the model
+// returns:
+//    the description
+static string describe(const ConfigModel& model) {
+    string out;
+    describe(model.capabilities.device, out);
+    for (const ConfigChannel& channel : model.capabilities.channels) {
+        out += "\nchannel ";
+        for (const ConfigValue* val : { &channel.name, &channel.type, &channel.accuracy, &channel.precision,
+            &channel.minValue, &channel.maxValue, &channel.minValueAtPin, &channel.maxValueAtPin }) {
+            describe(*val, out);
+        }
+    }
+    for (const ConfigFruRecord& record : model.fruRecords) {
+        out += "\nfru ";
+        describe(record.vendorIANA, out);
+        for (const ConfigFruField& field : record.fields) {
+            out += "\n  field ";
+            describe(field.type, out);
+            describe(field.format, out);
+            describe(field.value, out);
+            for (long b : field.bytes) out += to_string(b) + " ";
+        }
+    }
+    for (const ConfigEntity& entity : model.logicalEntities) {
+        out += "\nentity ";
+        describe(entity.name, out);
+        describe(entity.entityVendorIANA, out);
+        describe(entity.vendorEntityID, out);
+        for (const ConfigBinding& binding : entity.ioBindings) {
+            out += "\n  binding ";
+            for (ConfigValue ConfigBinding::* member : BINDING_VALUES) describe(binding.*member, out);
+            describe(binding.inputCurve, out);
+            describe(binding.outputCurve, out);
+            for (const ConfigTransducer* transducer : { &binding.sensor, &binding.effecter }) {
+                describe(transducer->responseCurve, out);
+                describe(transducer->nominalValue, out);
+                describe(transducer->ratedMax, out);
+            }
+        }
+        for (const ConfigParameter& parameter : entity.parameters) {
+            out += "\n  parameter ";
+            describe(parameter.name, out);
+            describe(parameter.type, out);
+            describe(parameter.value, out);
+        }
+    }
+    for (const ConfigStateSet& set : model.oemStateSets) {
+        out += "\nstate set ";
+        describe(set.stateSetID, out);
+        describe(set.vendorIANA, out);
+        for (const ConfigStateValueRecord& record : set.oemStateValueRecords) {
+            out += "\n  record ";
+            describe(record.minStateValue, out);
+            describe(record.maxStateValue, out);
+            for (unsigned long i = 0; i < record.languageTags.size(); i++) {
+                out += string(record.languageTags[i]) + "=" + string(record.stateName[i]) + " ";
+            }
+        }
+    }
+    return out;
+}
+
+//*******************************************************************
+// readBoth()
+//
+// fill a model from the text of a config and from a json structure
+// built from the same text.
+//
+// parameters:
+//    text - the text of the config
+//    parsed - the model to fill from the text
+//    loaded - the model to fill from the structure
+//    parseError - set to the error reported when reading the text
+//    loadError - set to the error reported when reading the structure
+// returns:
+//    true if both models were filled, false if both were rejected.  A
+//    config that is accepted one way and not the other is reported as
+//    rejected with differing errors.
+static bool readBoth(const string& text, ConfigModel& parsed, ConfigModel& loaded, string& parseError,
+    string& loadError) {
+    ostringstream errors;
+    streambuf* saved = cerr.rdbuf(errors.rdbuf());
+    bool parseOk = parsed.parse(text);
+    parseError = errors.str();
+    errors.str("");
+    JsonFactory jf;
+    JsonAbstractValue* config = jf.build(text);
+    bool loadOk = loaded.load(config);
+    loadError = errors.str();
+    delete config;
+    cerr.rdbuf(saved);
+    if (parseOk != loadOk) loadError += " (accepted one way only)";
+    return (parseOk) && (loadOk);
+}
+
+//*******************************************************************
+// rejects()
+//
+// check that a config is rejected, from its text and from a json
+// structure, with the expected error, and that the models are left
+// empty.
+//
+// parameters:
+//    name - the name of the test
+//    text - the text of the config
+//    error - the expected error
+// returns:
+//    true if the test passed, otherwise false
+static bool rejects(const string& name, const string& text, const string& error) {
+    ConfigModel parsed;
+    ConfigModel loaded;
+    string parseError;
+    string loadError;
+    bool accepted = readBoth(text, parsed, loaded, parseError, loadError);
+    string expected = "Config layout error at " + error + "\n";
+    bool passed = (!accepted) && (parseError == expected) && (loadError == expected) &&
+        (describe(parsed) == describe(ConfigModel())) && (describe(loaded) == describe(ConfigModel()));
+    if (!passed) cout << "  parse: " << parseError << "  load: " << loadError;
+    return check(name, passed);
+}
+
+//*******************************************************************
+// replace()
+//
+// return a config with the first occurrence of some text replaced.
+//
+// parameters:
+//    from - the text to replace
+//    to - the replacement
+// returns:
+//    the text of the config
+static string replace(const string& from, const string& to) {
+    string text = CONFIG;
+    size_t pos = text.find(from);
+    if (pos != string::npos) text.replace(pos, from.length(), to);
+    return text;
+}
+
+//*******************************************************************
+// main()
+//
+// read configs into models and check the results.
+//
+// This program returns non-zero if a test fails.
+//
+int main() {
+    bool passed = true;
+
+    // reading the text and reading a structure fill the model alike
+    {
+        ConfigModel parsed;
+        ConfigModel loaded;
+        string parseError;
+        string loadError;
+        bool ok = readBoth(CONFIG, parsed, loaded, parseError, loadError);
+        string description = describe(parsed);
+        passed &= check("parse matches load", (ok) && (description == describe(loaded)));
+        passed &= check("model filled", (parsed.capabilities.channels.size() == 1) &&
+            (parsed.fruRecords[0].fields[1].bytes.size() == 3) &&
+            (parsed.logicalEntities[0].ioBindings[0].inputCurve.out[1] == 2.5) &&
+            (parsed.logicalEntities[0].ioBindings[0].sensor.responseCurve.in.size() == 1) &&
+            (!parsed.logicalEntities[0].ioBindings[0].stateSet.isSet()) &&
+            (parsed.logicalEntities[0].ioBindings[0].stateSet.present) &&
+            (!parsed.logicalEntities[0].ioBindings[0].effecterID.present) &&
+            (parsed.oemStateSets[0].oemStateValueRecords[0].stateName[1] == "arr\\u00eat"));
+        // a model can be filled again
+        passed &= check("model reused", (parsed.parse(CONFIG)) && (describe(parsed) == description));
+    }
+
+    // the sample configs
+    for (const char* file : { "sample_config.json", "simple_config.json", "stepper_config.json" }) {
+        ifstream in(string(CONFIG_DIR) + "/" + file);
+        stringstream buffer;
+        buffer << in.rdbuf();
+        ConfigModel parsed;
+        ConfigModel loaded;
+        string parseError;
+        string loadError;
+        bool ok = (in) && (readBoth(buffer.str(), parsed, loaded, parseError, loadError));
+        passed &= check(string(file) + " parse matches load", (ok) && (!parsed.logicalEntities.empty()) &&
+            (describe(parsed) == describe(loaded)));
+    }
+
+    // missing required fields
+    passed &= rejects("missing entity name", replace("\"name\": \"entity\", ", ""),
+        "\"/configuration/logicalEntities/0\": missing required field \"name\"");
+    passed &= rejects("missing binding name", replace("\"name\": \"binding\", ", ""),
+        "\"/configuration/logicalEntities/0/ioBindings/0\": missing required field \"name\"");
+    passed &= rejects("missing state set field", replace("\"vendorIANA\": 412, \"oemStateValueRecords\"",
+        "\"oemStateValueRecords\""), "\"/oemStateSets/0\": missing required field \"vendorIANA\"");
+
+    // values of the wrong kind or out of range
+    passed &= rejects("string for integer", replace("\"sensorID\": 3", "\"sensorID\": \"3\""),
+        "\"/configuration/logicalEntities/0/ioBindings/0/sensorID\": value does not have an allowed type");
+    passed &= rejects("number for string", replace("\"name\": \"p\"", "\"name\": 5"),
+        "\"/configuration/logicalEntities/0/parameters/0/name\": value does not have an allowed type");
+    passed &= rejects("object for value", replace("\"isVirtual\": false", "\"isVirtual\": {}"),
+        "\"/configuration/logicalEntities/0/ioBindings/0/isVirtual\": value does not have an allowed type");
+    passed &= rejects("object for array", replace("\"ioBindings\": [", "\"ioBindings\": {\"a\":1}, \"x\": ["),
+        "\"/configuration/logicalEntities/0/ioBindings\": value does not have an allowed type");
+    passed &= rejects("string for curve point", replace("\"in\": 1,", "\"in\": \"1\","),
+        "\"/configuration/logicalEntities/0/ioBindings/0/inputCurve/1/in\": value does not have an allowed type");
+    passed &= rejects("out of range", replace("\"stateSetID\": 32768", "\"stateSetID\": 65536"),
+        "\"/oemStateSets/0/stateSetID\": value is out of range");
+    passed &= rejects("fru byte type", replace("[1, 2, 255]", "[1, \"2\", 255]"),
+        "\"/configuration/fruRecords/0/fields/1/value/1\": value does not have an allowed type");
+
+    // arrays and records of the wrong size
+    passed &= rejects("no entities", replace("\"logicalEntities\": [", "\"logicalEntities\": [], \"x\": ["),
+        "\"/configuration/logicalEntities\": array does not have an allowed number of elements");
+    passed &= rejects("state names", replace("[\"off\", \"arr\\u00eat\"]", "[\"off\"]"),
+        "\"/oemStateSets/0/oemStateValueRecords/0\": stateName does not have an entry for each language tag");
+    return (passed) ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+//*******************************************************************
+//    JsonCopyTest.cpp
+//
+//    This file provides a test program for copies of heap allocated
+//    JSON structures.  It checks that copies share the unchanged parts
+//    of the original, and that changes made to a copy through edit()
+//    leave the original and other copies unchanged.  This file is
+//    intended to be used as part of the PICMG IoT library reference
+//    code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <string>
+#include "JsonFactory.h"
+#include "JsonObject.h"
+#include "JsonArray.h"
+#include "JsonValue.h"
+#include "JsonTest.h"
+
+using namespace std;
+
+// the structure that the copies are made from
+static const char* BASE =
+    "{\"name\":\"base\",\"limits\":{\"low\":0,\"high\":10},"
+    "\"entities\":[{\"id\":1},{\"id\":2}],\"meta\":{\"owner\":\"x\"}}";
+
+//*******************************************************************
+// main()
+//
+// make variants of a structure and check the results.
+//
+// This program returns non-zero if a test fails.
+//
+int main() {
+    JsonFactory jf;
+    bool passed = true;
+
+    // two variants stamped from the same base, each changed through edit()
+    JsonObject* base = static_cast<JsonObject*>(jf.build(string(BASE)));
+    string original = text(base);
+    JsonObject* first = static_cast<JsonObject*>(base->copy());
+    JsonObject* second = static_cast<JsonObject*>(base->copy());
+    static_cast<JsonObject*>(first->edit("limits"))->put("high", new JsonValue(string("20")));
+    static_cast<JsonObject*>(static_cast<JsonArray*>(second->edit("entities"))->edit(0))->put("id", new JsonValue(string("9")));
+    second->put("name", new JsonValue(string("second")));
+    passed &= check("base unchanged", text(base) == original);
+    passed &= check("first variant", text(first) ==
+        "{\"name\":\"base\",\"limits\":{\"low\":0,\"high\":20},\"entities\":[{\"id\":1},{\"id\":2}],\"meta\":{\"owner\":\"x\"}}");
+    passed &= check("second variant", text(second) ==
+        "{\"name\":\"second\",\"limits\":{\"low\":0,\"high\":10},\"entities\":[{\"id\":9},{\"id\":2}],\"meta\":{\"owner\":\"x\"}}");
+
+    // unchanged values and key text are shared with the base
+    passed &= check("values shared", (first->find("entities") == base->find("entities")) &&
+        (second->find("limits") == base->find("limits")) &&
+        (static_cast<JsonArray*>(second->find("entities"))->getElement(1) ==
+         static_cast<JsonArray*>(base->find("entities"))->getElement(1)));
+    passed &= check("keys shared", first->getElementKeyView(3).data() == base->getElementKeyView(3).data());
+
+    // a value reached through find() rather than edit() is shared with
+    // the base, so it cannot be changed
+    static_cast<JsonObject*>(first->find("meta"))->put("owner", new JsonValue(string("y")));
+    passed &= check("put on shared object refused", text(base) == original);
+    passed &= check("take from shared array refused",
+        (!static_cast<JsonArray*>(first->find("entities"))->take(0)) && (text(base) == original));
+    static_cast<JsonObject*>(first->edit("meta"))->put("owner", new JsonValue(string("y")));
+    passed &= check("put after edit", (text(first->find("meta")) == "{\"owner\":\"y\"}") && (text(base) == original));
+
+    // the copy of a large object keeps a working index
+    JsonObject large;
+    for (int i = 0; i < 40; i++) large.put("field" + to_string(i), new JsonValue(to_string(i)));
+    JsonObject* copy = static_cast<JsonObject*>(large.copy());
+    copy->put("field40", new JsonValue(string("40")));
+    passed &= check("large copy", (copy->size() == 41) && (large.size() == 40) &&
+        (copy->getInteger("field17") == 17) && (copy->getInteger("field40") == 40) && (!large.find("field40")));
+    JsonAbstractValue::release(copy);
+
+    JsonAbstractValue::release(second);
+    JsonAbstractValue::release(first);
+    passed &= check("base unchanged after release", text(base) == original);
+    JsonAbstractValue::release(base);
+    return (passed) ? 0 : 1;
+}
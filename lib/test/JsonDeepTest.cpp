@@ -0,0 +1,84 @@
+//*******************************************************************
+//    JsonDeepTest.cpp
+//
+//    This file provides a test program that checks that deeply nested
+//    JSON structures can be hashed and compared without exhausting the
+//    call stack.  This file is intended to be used as part of the
+//    PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <iostream>
+#include <string>
+#include "JsonFactory.h"
+#include "JsonArena.h"
+#include "JsonDiff.h"
+#include "JsonTest.h"
+
+using namespace std;
+
+// the nesting depth of the test documents
+#define DEPTH 1000000
+
+//*******************************************************************
+// nested()
+//
+// return the text of an array nested to the test depth around a value.
+//
+// parameters:
+//    value - the text of the innermost value
+// returns:
+//    the text of the document
+static string nested(string value) {
+    return string(DEPTH, '[') + value + string(DEPTH, ']');
+}
+
+//*******************************************************************
+// main()
+//
+// build deeply nested documents and check that they can be hashed and
+// compared.
+//
+// This program returns non-zero if a test fails.
+//
+int main() {
+    JsonFactory jf;
+    JsonArena arena;
+    JsonAbstractValue* a = jf.build(nested("1"), arena);
+    JsonAbstractValue* b = jf.build(nested("1"), arena);
+    JsonAbstractValue* c = jf.build(nested("2"), arena);
+    if ((!a) || (!b) || (!c)) {
+        cerr << "unable to build the test documents" << endl;
+        return 1;
+    }
+
+    bool passed = true;
+    passed &= check("deep hash", (a->hash() == b->hash()) && (a->hash() != c->hash()));
+    passed &= check("deep equals", (JsonDiff::equals(a, b)) && (!JsonDiff::equals(a, c)));
+    passed &= check("deep compare equal", JsonDiff::compare(a, b).empty());
+    passed &= check("deep confirmed compare equal", JsonDiff::compare(a, b, true).empty());
+
+    vector<JsonDiff::Change> changes = JsonDiff::compare(a, c);
+    string path;
+    for (unsigned long i = 0; i < DEPTH; i++) path += "/0";
+    passed &= check("deep compare changed", (changes.size() == 1) &&
+        (changes[0].type == JsonDiff::CHANGE_CHANGED) && (changes[0].path == path));
+    return (passed) ? 0 : 1;
+}
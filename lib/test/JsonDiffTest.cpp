@@ -0,0 +1,141 @@
+//*******************************************************************
+//    JsonDiffTest.cpp
+//
+//    This file provides a test program for the structural comparison
+//    of JSON structures.  It checks the changes that are reported, and
+//    that comparing large structures whose hashes are known costs little
+//    more than comparing their hashes.  This file is intended to be
+//    used as part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <chrono>
+#include <string>
+#include "JsonFactory.h"
+#include "JsonArena.h"
+#include "JsonDiff.h"
+#include "JsonTest.h"
+
+using namespace std;
+
+// the number of records in the large test documents
+#define RECORDS 200000
+
+//*******************************************************************
+// records()
+//
+// return the text of a document holding an array of records.
+//
+// parameters:
+//    changed - the number of the record whose value differs (or -1)
+// returns:
+//    the text of the document
+static string records(long changed) {
+    string result = "{\"name\":\"records\",\"records\":[";
+    for (long i = 0; i < RECORDS; i++) {
+        if (i) result += ",";
+        result += "{\"id\":" + to_string(i) + ",\"name\":\"r" + to_string(i) +
+            "\",\"value\":" + ((i == changed) ? "2.5" : "1.5") + ",\"tags\":[\"a\",\"b\"]}";
+    }
+    return result + "]}";
+}
+
+//*******************************************************************
+// elapsed()
+//
+// return the time taken to compare two structures.
+//
+// parameters:
+//    a - the first structure
+//    b - the second structure
+//    changes - the changes that were found (on return)
+// returns:
+//    the time taken in seconds
+static double elapsed(JsonAbstractValue* a, JsonAbstractValue* b, vector<JsonDiff::Change>& changes) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    changes = JsonDiff::compare(a, b);
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+//*******************************************************************
+// changesOf()
+//
+// return a summary of a list of changes, one line per change.
+//
+// parameters:
+//    changes - the changes to summarize
+// returns:
+//    the summary
+static string changesOf(const vector<JsonDiff::Change>& changes) {
+    string result;
+    for (vector<JsonDiff::Change>::const_iterator it = changes.begin(); it != changes.end(); ++it) {
+        result += (it->type == JsonDiff::CHANGE_ADDED) ? "+" : (it->type == JsonDiff::CHANGE_REMOVED) ? "-" : "~";
+        result += it->path + "\n";
+    }
+    return result;
+}
+
+//*******************************************************************
+// main()
+//
+// compare small and large structures and check the results.
+//
+// This program returns non-zero if a test fails.
+//
+int main() {
+    JsonFactory jf;
+    JsonArena arena;
+    bool passed = true;
+
+    // changes to fields, array elements and values of different kinds
+    JsonAbstractValue* before = jf.build(string(
+        "{\"a\":1,\"b\":[1,2,3,4],\"c\":{\"d\":\"x\",\"e/f\":true},\"g\":null}"), arena);
+    JsonAbstractValue* after = jf.build(string(
+        "{\"c\":{\"d\":\"y\",\"e/f\":true},\"a\":1.0,\"b\":[1,2,9,3,4],\"h\":[]}"), arena);
+    vector<JsonDiff::Change> changes = JsonDiff::compare(before, after);
+    passed &= check("compare changes", changesOf(changes) == "+/b/2\n~/c/d\n-/g\n+/h\n");
+    passed &= check("confirmed compare changes", changesOf(JsonDiff::compare(before, after, true)) == changesOf(changes));
+    passed &= check("equals", (JsonDiff::equals(before, before)) && (!JsonDiff::equals(before, after)));
+
+    // numbers are compared by value, so a number written differently is
+    // not a change - integers and doubles of the same value are equal
+    JsonAbstractValue* written = jf.build(string("{\"n\":1,\"r\":1.5,\"l\":[2]}"), arena);
+    JsonAbstractValue* rewritten = jf.build(string("{\"n\":1.0,\"r\":1.50,\"l\":[2e0]}"), arena);
+    passed &= check("numbers compare by value", (written->hash() == rewritten->hash()) &&
+        (JsonDiff::equals(written, rewritten)) && (JsonDiff::compare(written, rewritten, true).empty()));
+
+    // separately built structures with the same content are compared by
+    // their hashes once the hashes are known
+    JsonAbstractValue* a = jf.build(records(-1), arena);
+    JsonAbstractValue* b = jf.build(records(-1), arena);
+    JsonAbstractValue* c = jf.build(records(RECORDS / 2), arena);
+    double first = elapsed(a, b, changes);
+    passed &= check("large compare equal", changes.empty());
+    double repeat = elapsed(a, b, changes);
+    passed &= check("large compare equal again", changes.empty());
+    cout << "first compare " << first * 1000 << "ms, repeat " << repeat * 1000 << "ms" << endl;
+    passed &= check("repeat compare skips the unchanged structure", repeat * 20 < first);
+
+    // a single change is found without confirming the rest
+    elapsed(a, c, changes);
+    passed &= check("large compare changed", changesOf(changes) == "~/records/" + to_string(RECORDS / 2) + "/value\n");
+    passed &= check("large confirmed compare", changesOf(JsonDiff::compare(a, c, true)) == changesOf(changes));
+    return (passed) ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+//*******************************************************************
+//    JsonIndexTest.cpp
+//
+//    This file provides a test program for the structural index used by
+//    the JSON parser.  Text holding runs of backslashes is built from a
+//    buffer (which uses the index) and from a stream (which does not),
+//    and the structures are compared.  The runs are placed so that they
+//    cross the 64-byte blocks in which the index is built.  This file is
+//    intended to be used as part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <sstream>
+#include <string>
+#include "JsonFactory.h"
+#include "JsonArena.h"
+#include "JsonArray.h"
+#include "JsonObject.h"
+#include "JsonStructuralIndex.h"
+#include "JsonTest.h"
+
+using namespace std;
+
+//*******************************************************************
+// document()
+//
+// return the text of an object whose first member holds a run of
+// backslashes.  A run of even length ends the string at the quote that
+// follows it.  A run of odd length escapes that quote, and the string
+// continues with text that would be structural outside of a string.
+//
+// parameters:
+//    offset - the position within the text at which the run starts
+//    length - the number of backslashes in the run
+// returns:
+//    the text of the document
+static string document(unsigned long offset, unsigned long length) {
+    string result = "{\"s\":\"";
+    result.append(offset - result.length(), 'a');
+    result.append(length, '\\');
+    result += "\"";
+    if (length % 2) result += ",\\\"],[{:\"";
+    return result + ",\"next\":[1,{\"k\":2}]}";
+}
+
+//*******************************************************************
+// main()
+//
+// build each document from a buffer and from a stream and check that
+// the results agree.
+//
+// This program returns non-zero if a test fail.
+//
+int main() {
+    JsonFactory jf;
+    bool passed = true;
+
+    // escaped quotes are not added to the index
+    {
+        JsonStructuralIndex index;
+        string text = "[\"x\\\\\",\"y\\\"\"]";
+        index.build(text);
+        passed &= check("index entries", index.size() == 7);
+        passed &= check("index even run", (index[2] == 5) && (text[index[2]] == '"'));
+        passed &= check("index odd run", (index[4] == 7) && (index[5] == 11));
+    }
+
+    // runs of each length starting on either side of the first block
+    // boundaries
+    unsigned long failures = 0;
+    unsigned long tested = 0;
+    for (unsigned long offset = 6; offset < 200; offset++) {
+        for (unsigned long length = 1; length <= 9; length++) {
+            string text = document(offset, length);
+            JsonArena arena;
+            JsonAbstractValue* indexed = jf.buildView(text, arena);
+            istringstream in(text);
+            JsonAbstractValue* streamed = jf.build(in, arena);
+            JsonObject* obj = dynamic_cast<JsonObject*>(indexed);
+            bool ok = (indexed) && (streamed) && (::text(indexed) == ::text(streamed)) && (obj) &&
+                (obj->size() == 2) && (::text(obj->find("next")) == "[1,{\"k\":2}]");
+            tested++;
+            if (!ok) {
+                if (failures++ < 5) cout << "  offset " << offset << " length " << length << ": " << text << endl;
+            }
+        }
+    }
+    cout << tested << " documents built" << endl;
+    passed &= check("backslash runs across blocks", failures == 0);
+
+    // a run of backslashes that fills whole blocks
+    {
+        string text = "[\"" + string(64 * 3 - 2, '\\') + "\",\"" + string(64 * 2 + 1, '\\') + "\"\"]";
+        JsonArena arena;
+        JsonAbstractValue* indexed = jf.buildView(text, arena);
+        istringstream in(text);
+        JsonAbstractValue* streamed = jf.build(in, arena);
+        JsonArray* ary = dynamic_cast<JsonArray*>(indexed);
+        passed &= check("long backslash runs", (ary) && (ary->size() == 2) && (streamed) &&
+            (::text(indexed) == ::text(streamed)));
+    }
+    return (passed) ? 0 : 1;
+}
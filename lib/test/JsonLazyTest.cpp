@@ -0,0 +1,132 @@
+//*******************************************************************
+//    JsonLazyTest.cpp
+//
+//    This file provides a test program for JSON structures built on
+//    demand.  It checks that a lazily built structure matches one built
+//    in full, that only the parts of it that are used are built, and
+//    that badly formed text is reported when (and only when) the part
+//    of the structure holding it is used.  This file is intended to be
+//    used as part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <string>
+#include "JsonFactory.h"
+#include "JsonArena.h"
+#include "JsonDiff.h"
+#include "JsonLazyDocument.h"
+#include "JsonTest.h"
+
+using namespace std;
+
+// a document holding each kind of value, with brackets and escaped
+// quotes within strings
+static const char* DOCUMENT =
+    "{ \"name\" : \"la[zy}\\\"\", \"count\":3, \"ratio\":-1.5e3, \"flags\":[true,false,null],\n"
+    "  \"empty\":{}, \"none\":[ ], \"nested\":{\"a\":[{\"b\":[[1],[2,{\"c\":\"d]\"}]]}]},\n"
+    "  \"list\":[1,\"two\",{\"three\":3}] }";
+
+//*******************************************************************
+// records()
+//
+// return the text of a document holding an array of records.
+//
+// parameters:
+//    count - the number of records
+// returns:
+//    the text of the document
+static string records(long count) {
+    string result = "{\"first\":{\"id\":-1},\"records\":[";
+    for (long i = 0; i < count; i++) {
+        if (i) result += ",";
+        result += "{\"id\":" + to_string(i) + ",\"tags\":[\"a\",\"b\"]}";
+    }
+    return result + "]}";
+}
+
+//*******************************************************************
+// main()
+//
+// build structures lazily and in full and check the results.
+//
+// This program returns non-zero if a test fails.
+//
+int main() {
+    JsonFactory jf;
+    bool passed = true;
+
+    // lazy and full builds give the same structure
+    {
+        JsonArena arena;
+        string text = DOCUMENT;
+        JsonLazyDocument* document;
+        JsonAbstractValue* lazy = jf.buildLazy(text, arena, &document);
+        JsonAbstractValue* eager = jf.buildView(text, arena);
+        passed &= check("lazy document", (lazy) && (document));
+        passed &= check("lazy matches eager", (lazy) && (eager) && (JsonDiff::equals(lazy, eager)));
+        passed &= check("lazy text", ::text(lazy) == ::text(eager));
+        passed &= check("lazy no error", !document->hasError());
+        passed &= check("lazy array root", ::text(jf.buildLazy("[1,[2,{\"a\":[]}]]", arena)) == "[1,[2,{\"a\":[]}]]");
+    }
+
+    // only the parts that are used are built
+    {
+        JsonArena arena;
+        string text = records(10000);
+        JsonObject* root = static_cast<JsonObject*>(jf.buildLazy(text, arena));
+        unsigned long before = arena.bytesUsed();
+        JsonObject* first = static_cast<JsonObject*>(root->find("first"));
+        passed &= check("lazy access", (first) && (first->getInteger("id") == -1));
+        unsigned long used = arena.bytesUsed();
+        JsonArray* list = static_cast<JsonArray*>(root->find("records"));
+        JsonObject* last = static_cast<JsonObject*>(list->getElement(9999));
+        passed &= check("lazy later access", (last) && (last->getInteger("id") == 9999));
+        ::text(root);
+        cout << "first access used " << used - before << " bytes, full use " << arena.bytesUsed() - before << " bytes" << endl;
+        passed &= check("lazy builds on use", (arena.bytesUsed() - before) > 1000 * (used - before));
+        JsonArena full;
+        passed &= check("lazy large matches eager", JsonDiff::equals(root, jf.buildView(text, full)));
+    }
+
+    // an error within a part of the structure is only found when that
+    // part is used
+    {
+        JsonArena arena;
+        string text = "{\"good\":{\"a\":[1,2]},\"bad\":{\"x\" 1,\"y\":1},\"after\":3}";
+        JsonLazyDocument* document;
+        JsonObject* root = static_cast<JsonObject*>(jf.buildLazy(text, arena, &document));
+        passed &= check("eager build rejects", jf.buildView(text, arena) == NULL);
+        passed &= check("lazy build accepts", (root) && (document) && (!document->hasError()));
+        passed &= check("untouched error not reported",
+            (::text(root->find("good")) == "{\"a\":[1,2]}") && (root->getInteger("after") == 3) &&
+            (!document->hasError()));
+        JsonObject* bad = static_cast<JsonObject*>(root->find("bad"));
+        passed &= check("error reported on use", (bad) && (!bad->find("y")) && (document->hasError()));
+        passed &= check("bad container left empty", bad->size() == 0);
+    }
+
+    // text whose brackets do not balance is built in full, and rejected
+    {
+        JsonArena arena;
+        JsonLazyDocument* document;
+        passed &= check("unbalanced text", (jf.buildLazy("{\"a\":[1,2}", arena, &document) == NULL) && (!document));
+    }
+    return (passed) ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+//*******************************************************************
+//    JsonParallelTest.cpp
+//
+//    This file provides a test program for building large JSON arrays
+//    on several threads.  Each document is built with parallel parsing
+//    enabled and disabled, and the structures are compared.  This file
+//    is intended to be used as part of the PICMG IoT library reference
+//    code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <string>
+#include "JsonFactory.h"
+#include "JsonArena.h"
+#include "JsonArray.h"
+#include "JsonDiff.h"
+#include "JsonTest.h"
+
+using namespace std;
+
+// the smallest array split between threads by the tests
+static const unsigned long MINIMUM = 256;
+
+//*******************************************************************
+// elements()
+//
+// return the text of the elements of an array holding each kind of
+// value.  Strings hold brackets, commas and escapes so that they are
+// not mistaken for the boundaries of elements.
+//
+// parameters:
+//    count - the number of elements
+// returns:
+//    the text of the elements
+static string elements(long count) {
+    string result;
+    for (long i = 0; i < count; i++) {
+        if (i) result += (i % 7) ? "," : " ,\n ";
+        switch (i % 6) {
+        case 0: result += to_string(i); break;
+        case 1: result += "-" + to_string(i) + ".5e-3"; break;
+        case 2: result += "\"s,]" + to_string(i) + "\\\"[\\\\\""; break;
+        case 3: result += "{\"id\":" + to_string(i) + ",\"list\":[true,false,null,{\"a\":[]}],\"e\":{}}"; break;
+        case 4: result += "[[" + to_string(i) + "],[],\"\\u00e9\"]"; break;
+        case 5: result += (i % 4) ? "true" : "null"; break;
+        }
+    }
+    return result;
+}
+
+//*******************************************************************
+// compare()
+//
+// build the text with and without parallel parsing, in each of the
+// ways that a structure can be built from a buffer, and check that the
+// results are the same.
+//
+// parameters:
+//    name - the name of the test
+//    text - the text to build
+//    valid - true if the text is expected to build
+// returns:
+//    true if the test passed, otherwise false
+static bool compare(const string& name, const string& text, bool valid = true) {
+    bool passed = true;
+    for (int decode = 0; decode < 2; decode++) {
+        JsonFactory sequential;
+        JsonFactory parallel;
+        sequential.setDecode(decode);
+        parallel.setDecode(decode);
+        parallel.setParallel(4, MINIMUM);
+        string mode = name + ((decode) ? " decoded" : "");
+
+        // heap structures owning their text
+        JsonAbstractValue* expected = sequential.build(text);
+        JsonAbstractValue* actual = parallel.build(text);
+        if (valid) {
+            passed &= check(mode + " build", (expected) && (actual) &&
+                (JsonDiff::equals(expected, actual)) && (::text(expected) == ::text(actual)));
+        } else {
+            passed &= check(mode + " build rejects", (!expected) && (!actual));
+        }
+        delete expected;
+        delete actual;
+
+        // heap structures referring to the text
+        expected = sequential.buildView(text);
+        actual = parallel.buildView(text);
+        passed &= check(mode + " view", (valid) ? ((expected) && (actual) && (::text(expected) == ::text(actual))) :
+            ((!expected) && (!actual)));
+        delete expected;
+        delete actual;
+
+        // arena structures
+        JsonArena arena;
+        expected = sequential.buildView(text, arena);
+        actual = parallel.buildView(text, arena);
+        passed &= check(mode + " arena", (valid) ? ((expected) && (actual) && (::text(expected) == ::text(actual))) :
+            ((!expected) && (!actual)));
+    }
+    return passed;
+}
+
+//*******************************************************************
+// main()
+//
+// build documents with large arrays with and without parallel parsing.
+//
+// This program returns non-zero if a test fails.
+//
+int main() {
+    bool passed = true;
+    string list = elements(5000);
+
+    // the outermost value
+    passed &= compare("outer array", "[" + list + "]");
+    passed &= compare("outer array with whitespace", " \n[ " + list + " ]\n");
+
+    // fields of the outermost object, including arrays nested too deeply
+    // to be split
+    passed &= compare("object fields", "{\"first\":[" + list + "],\"n\":1,\"second\":[" + elements(777) +
+        "],\"deep\":{\"inner\":[" + list + "]}}");
+
+    // few elements, fewer elements than threads, and a trailing comma
+    passed &= compare("large elements", "[{\"a\":[" + list + "]},[" + list + "]]");
+    passed &= compare("single element", "[[" + list + "]]");
+    passed &= compare("trailing comma", "[" + list + ",]");
+
+    // a badly formed element rejects the whole document
+    passed &= compare("bad element", "[" + list + ",{\"x\" 1}," + list + "]", false);
+    passed &= compare("bad last element", "[" + list + ",[1,}]", false);
+    return (passed) ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+//*******************************************************************
+//    JsonPatchTest.cpp
+//
+//    This file provides a test program for JSON Patch (RFC 6902).  It
+//    applies each kind of operation to small structures and checks the
+//    results, including pointers and keys that hold escape sequences
+//    and operations on the root of the structure.  This file is
+//    intended to be used as part of the PICMG IoT library reference
+//    code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <string>
+#include "JsonFactory.h"
+#include "JsonArena.h"
+#include "JsonPatch.h"
+#include "JsonTest.h"
+
+using namespace std;
+
+//*******************************************************************
+// patched()
+//
+// apply a patch to a structure built in an arena and return the text
+// of the result.
+//
+// parameters:
+//    jf - the factory to build the structures with
+//    document - the text of the structure
+//    patch - the text of the patch
+// returns:
+//    the text of the patched structure, or "FAILED" if the patch
+//    could not be applied
+static string patched(JsonFactory& jf, const string& document, const string& patch) {
+    JsonArena arena;
+    JsonAbstractValue* root = jf.build(document, arena);
+    JsonAbstractValue* operations = jf.build(patch, arena);
+    if (!JsonPatch::apply(root, operations)) return "FAILED";
+    return text(root);
+}
+
+//*******************************************************************
+// main()
+//
+// apply patches and check the results.
+//
+// This program returns non-zero if a test fails.
+//
+int main() {
+    JsonFactory jf;
+    bool passed = true;
+
+    // add
+    passed &= check("add field", patched(jf, "{\"a\":1}",
+        "[{\"op\":\"add\",\"path\":\"/b\",\"value\":[1,{\"c\":2}]}]") == "{\"a\":1,\"b\":[1,{\"c\":2}]}");
+    passed &= check("add replaces field", patched(jf, "{\"a\":1}",
+        "[{\"op\":\"add\",\"path\":\"/a\",\"value\":2}]") == "{\"a\":2}");
+    passed &= check("add element", patched(jf, "{\"a\":[1,2]}",
+        "[{\"op\":\"add\",\"path\":\"/a/1\",\"value\":9}]") == "{\"a\":[1,9,2]}");
+    passed &= check("add at end", patched(jf, "{\"a\":[1,2]}",
+        "[{\"op\":\"add\",\"path\":\"/a/-\",\"value\":3},{\"op\":\"add\",\"path\":\"/a/3\",\"value\":4}]") ==
+        "{\"a\":[1,2,3,4]}");
+    passed &= check("add past end", patched(jf, "{\"a\":[1,2]}",
+        "[{\"op\":\"add\",\"path\":\"/a/3\",\"value\":3}]") == "FAILED");
+    passed &= check("add without parent", patched(jf, "{\"a\":1}",
+        "[{\"op\":\"add\",\"path\":\"/b/c\",\"value\":3}]") == "FAILED");
+
+    // remove
+    passed &= check("remove field", patched(jf, "{\"a\":1,\"b\":2}",
+        "[{\"op\":\"remove\",\"path\":\"/a\"}]") == "{\"b\":2}");
+    passed &= check("remove element", patched(jf, "{\"a\":[1,2,3]}",
+        "[{\"op\":\"remove\",\"path\":\"/a/1\"}]") == "{\"a\":[1,3]}");
+    passed &= check("remove missing", patched(jf, "{\"a\":[1]}",
+        "[{\"op\":\"remove\",\"path\":\"/a/-\"}]") == "FAILED");
+
+    // replace
+    passed &= check("replace field", patched(jf, "{\"a\":1}",
+        "[{\"op\":\"replace\",\"path\":\"/a\",\"value\":{\"b\":null}}]") == "{\"a\":{\"b\":null}}");
+    passed &= check("replace element", patched(jf, "{\"a\":[1,2]}",
+        "[{\"op\":\"replace\",\"path\":\"/a/1\",\"value\":true}]") == "{\"a\":[1,true]}");
+    passed &= check("replace missing", patched(jf, "{\"a\":1}",
+        "[{\"op\":\"replace\",\"path\":\"/b\",\"value\":2}]") == "FAILED");
+
+    // move
+    passed &= check("move field", patched(jf, "{\"a\":{\"x\":1},\"b\":[]}",
+        "[{\"op\":\"move\",\"from\":\"/a\",\"path\":\"/b/-\"}]") == "{\"b\":[{\"x\":1}]}");
+    passed &= check("move into itself", patched(jf, "{\"a\":{\"x\":1}}",
+        "[{\"op\":\"move\",\"from\":\"/a\",\"path\":\"/a/y\"}]") == "FAILED");
+    passed &= check("move to same place", patched(jf, "{\"a\":{\"x\":1}}",
+        "[{\"op\":\"move\",\"from\":\"/a\",\"path\":\"/a\"}]") == "{\"a\":{\"x\":1}}");
+    passed &= check("move to sibling prefix", patched(jf, "{\"a\":1,\"ab\":2}",
+        "[{\"op\":\"move\",\"from\":\"/a\",\"path\":\"/abc\"}]") == "{\"ab\":2,\"abc\":1}");
+
+    // copy
+    passed &= check("copy", patched(jf, "{\"a\":{\"x\":[1]}}",
+        "[{\"op\":\"copy\",\"from\":\"/a\",\"path\":\"/a/y\"}]") == "{\"a\":{\"x\":[1],\"y\":{\"x\":[1]}}}");
+    passed &= check("copy missing", patched(jf, "{\"a\":1}",
+        "[{\"op\":\"copy\",\"from\":\"/b\",\"path\":\"/c\"}]") == "FAILED");
+
+    // test
+    passed &= check("test passes", patched(jf, "{\"a\":{\"b\":[1,\"x\"]}}",
+        "[{\"op\":\"test\",\"path\":\"/a\",\"value\":{\"b\":[1.0,\"x\"]}}]") == "{\"a\":{\"b\":[1,\"x\"]}}");
+    passed &= check("test fails", patched(jf, "{\"a\":1}",
+        "[{\"op\":\"test\",\"path\":\"/a\",\"value\":\"1\"}]") == "FAILED");
+    passed &= check("unknown operation", patched(jf, "{\"a\":1}",
+        "[{\"op\":\"frob\",\"path\":\"/a\"}]") == "FAILED");
+
+    // pointers and keys that hold escape sequences
+    passed &= check("pointer escapes", patched(jf, "{\"a/b\":1,\"m~n\":2}",
+        "[{\"op\":\"replace\",\"path\":\"/a~1b\",\"value\":3},{\"op\":\"remove\",\"path\":\"/m~0n\"}]") ==
+        "{\"a/b\":3}");
+    passed &= check("string escapes in pointer", patched(jf, "{\"a\":1}",
+        "[{\"op\":\"replace\",\"path\":\"/\\u0061\",\"value\":2}]") == "{\"a\":2}");
+    passed &= check("escaped keys", patched(jf, "{\"q\\\"uote\":1,\"t\\u0061b\":2}",
+        "[{\"op\":\"replace\",\"path\":\"/q\\\"uote\",\"value\":3},{\"op\":\"remove\",\"path\":\"/tab\"}]") ==
+        "{\"q\\\"uote\":3}");
+    passed &= check("new escaped key", patched(jf, "{}",
+        "[{\"op\":\"add\",\"path\":\"/new\\\"\\\\key\\t\",\"value\":1}]") == "{\"new\\\"\\\\key\\t\":1}");
+    passed &= check("invalid pointer text", patched(jf, "{\"a\":1}",
+        "[{\"op\":\"remove\",\"path\":\"/\\ud800\"}]") == "FAILED");
+
+    // structures built with their strings decoded
+    {
+        JsonFactory decoding;
+        decoding.setDecode(true);
+        JsonArena arena;
+        JsonAbstractValue* root = decoding.build(string("{\"q\\\"uote\":1,\"a\\\\b\":2}"), arena);
+        JsonAbstractValue* operations = decoding.build(string(
+            "[{\"op\":\"replace\",\"path\":\"/q\\\"uote\",\"value\":3},{\"op\":\"remove\",\"path\":\"/a\\\\b\"}]"), arena);
+        passed &= check("decoded structures", (JsonPatch::apply(root, operations, true)) &&
+            (static_cast<JsonObject*>(root)->size() == 1) && (static_cast<JsonObject*>(root)->getInteger("q\"uote") == 3));
+    }
+
+    // operations on the root replace (and release) the structure
+    passed &= check("replace root", patched(jf, "{\"a\":1}",
+        "[{\"op\":\"replace\",\"path\":\"\",\"value\":[1]},{\"op\":\"add\",\"path\":\"/-\",\"value\":2}]") == "[1,2]");
+    passed &= check("move to root", patched(jf, "{\"a\":{\"b\":1}}",
+        "[{\"op\":\"move\",\"from\":\"/a\",\"path\":\"\"}]") == "{\"b\":1}");
+    passed &= check("remove root", patched(jf, "{\"a\":1}", "[{\"op\":\"remove\",\"path\":\"\"}]") == "FAILED");
+    JsonAbstractValue* heap = jf.build(string("{\"a\":{\"b\":[1,2]}}"));
+    JsonAbstractValue* original = heap;
+    JsonAbstractValue* operations = jf.build(string(
+        "[{\"op\":\"copy\",\"from\":\"/a/b\",\"path\":\"\"},{\"op\":\"add\",\"path\":\"/0\",\"value\":0}]"));
+    passed &= check("heap root replaced", (JsonPatch::apply(heap, operations)) && (heap != original) &&
+        (text(heap) == "[0,1,2]"));
+    JsonAbstractValue::release(heap);
+    JsonAbstractValue::release(operations);
+
+    // a failed operation leaves the operations before it applied
+    JsonArena arena;
+    JsonAbstractValue* root = jf.build(string("{\"a\":1}"), arena);
+    operations = jf.build(string(
+        "[{\"op\":\"add\",\"path\":\"/b\",\"value\":2},{\"op\":\"test\",\"path\":\"/a\",\"value\":2},"
+        "{\"op\":\"add\",\"path\":\"/c\",\"value\":3}]"), arena);
+    passed &= check("failure stops the patch", (!JsonPatch::apply(root, operations)) &&
+        (text(root) == "{\"a\":1,\"b\":2}"));
+    return (passed) ? 0 : 1;
+}
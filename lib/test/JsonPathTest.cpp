@@ -0,0 +1,158 @@
+//*******************************************************************
+//    JsonPathTest.cpp
+//
+//    This file provides a test program for compiled JSON paths and the
+//    cache of their results.  It checks the nodes selected by each kind
+//    of step, and that cached results are reused until the structure
+//    they were found in changes.  This file is intended to be used as
+//    part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <string>
+#include <vector>
+#include "JsonFactory.h"
+#include "JsonArena.h"
+#include "JsonObject.h"
+#include "JsonArray.h"
+#include "JsonValue.h"
+#include "JsonPath.h"
+#include "JsonPathCache.h"
+#include "JsonTest.h"
+
+using namespace std;
+
+// the document that the paths are executed against
+static const char* DOCUMENT =
+    "{\"name\":\"config\",\"entities\":["
+    "{\"name\":\"a]b\",\"kind\":\"sensor\",\"id\":1},"
+    "{\"name\":\"c\",\"kind\":\"effecter\",\"id\":2},"
+    "{\"name\":\"d\",\"id\":3},"
+    "[\"not\",\"an\",\"object\"]],"
+    "\"limits\":{\"low\":0,\"high\":10}}";
+
+//*******************************************************************
+// texts()
+//
+// return the text of a list of nodes, separated by spaces.
+//
+// parameters:
+//    nodes - the nodes
+// returns:
+//    the text of the nodes
+static string texts(const vector<JsonAbstractValue*>& nodes) {
+    string result;
+    for (vector<JsonAbstractValue*>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        if (!result.empty()) result += " ";
+        result += text(*it);
+    }
+    return result;
+}
+
+//*******************************************************************
+// selects()
+//
+// returns true if a path compiles and selects the expected nodes.
+//
+// parameters:
+//    root - the structure to execute the path against
+//    path - the text of the path
+//    expected - the text of the nodes that should be selected
+// returns:
+//    true if the expected nodes were selected, otherwise false
+static bool selects(JsonAbstractValue* root, const string& path, const string& expected) {
+    JsonPath compiled(path);
+    string found = texts(compiled.select(root));
+    if ((compiled.isValid()) && (found == expected)) return true;
+    cout << "     " << path << " selected " << found << endl;
+    return false;
+}
+
+//*******************************************************************
+// main()
+//
+// execute paths against a structure and check the results.
+//
+// This program returns non-zero if a test fails.
+//
+int main() {
+    JsonFactory jf;
+    JsonArena arena;
+    bool passed = true;
+
+    // each kind of step
+    JsonAbstractValue* root = jf.build(string(DOCUMENT), arena);
+    passed &= check("field", selects(root, "$.name", "\"config\""));
+    passed &= check("nested field", selects(root, "limits.high", "10"));
+    passed &= check("index", selects(root, "entities[1].id", "2"));
+    passed &= check("index past the end", selects(root, "entities[9]", ""));
+    passed &= check("array wildcard", selects(root, "entities[*].id", "1 2 3"));
+    passed &= check("object wildcard", selects(root, "limits[*]", "0 10"));
+    passed &= check("match filter", selects(root, "entities[?kind=='sensor'].id", "1"));
+    passed &= check("mismatch filter skips missing fields", selects(root, "entities[?kind!='sensor'].id", "2"));
+    passed &= check("quoted ']' in a filter", selects(root, "entities[?name=='a]b'].id", "1"));
+    passed &= check("quoted operator in a filter", selects(root, "entities[?name!=\"x==y\"].id", "1 2 3"));
+    passed &= check("invalid paths", (!JsonPath("entities[?name=='a]").isValid()) &&
+        (!JsonPath("entities[x]").isValid()) && (!JsonPath("entities[?=='a']").isValid()));
+
+    // cached results are reused while the structure is unchanged
+    JsonPathCache cache;
+    passed &= check("cached plan", &cache.compile("entities[*].id") == &cache.compile("entities[*].id"));
+    vector<JsonAbstractValue*> ids = cache.select(root, "entities[*].id");
+    passed &= check("cached select", texts(ids) == "1 2 3");
+    passed &= check("cached select again", cache.select(root, "entities[*].id") == ids);
+    passed &= check("cached first", text(cache.first(root, "entities[?kind=='effecter'].name")) == "\"c\"");
+
+    // changes to an arena allocated structure are seen
+    JsonArray* entities = static_cast<JsonArray*>(static_cast<JsonObject*>(root)->find("entities"));
+    static_cast<JsonObject*>(entities->getElement(2))->put("kind", JsonValue(string("sensor")).clone(&arena));
+    passed &= check("arena put", texts(cache.select(root, "entities[?kind=='sensor'].id")) == "1 3");
+    entities->take(0);
+    passed &= check("arena take", texts(cache.select(root, "entities[*].id")) == "2 3");
+    arena.reset();
+    root = jf.build(string("{\"entities\":[{\"id\":7}]}"), arena);
+    passed &= check("arena reset", texts(cache.select(root, "entities[*].id")) == "7");
+
+    // changes to a heap allocated structure are seen, including changes
+    // made through edit() and to a copy that shares its values
+    JsonObject* heap = static_cast<JsonObject*>(jf.build(string(DOCUMENT)));
+    JsonObject* copy = static_cast<JsonObject*>(heap->copy());
+    passed &= check("heap select", texts(cache.select(copy, "entities[*].id")) == "1 2 3");
+    static_cast<JsonObject*>(static_cast<JsonArray*>(copy->edit("entities"))->edit(1))->put("id", new JsonValue(string("5")));
+    passed &= check("heap edit", texts(cache.select(copy, "entities[*].id")) == "1 5 3");
+    passed &= check("heap original unchanged", texts(cache.select(heap, "entities[*].id")) == "1 2 3");
+    static_cast<JsonObject*>(copy->edit("limits"))->remove("low");
+    JsonAbstractValue::release(copy->take("limits"));
+    passed &= check("heap take", texts(cache.select(copy, "limits[*]")) == "");
+    JsonAbstractValue::release(copy);
+    JsonAbstractValue::release(heap);
+
+    // a structure in an arena that has been destroyed is not confused
+    // with one at the same address in a new arena
+    {
+        JsonArena first;
+        JsonAbstractValue* doc = jf.build(string("{\"a\":1}"), first);
+        passed &= check("first arena", texts(cache.select(doc, "a")) == "1");
+    }
+    JsonArena second;
+    JsonAbstractValue* doc = jf.build(string("{\"a\":2}"), second);
+    passed &= check("second arena", texts(cache.select(doc, "a")) == "2");
+    return (passed) ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+//*******************************************************************
+//    JsonSerializerTest.cpp
+//
+//    This file provides a test program for the JSON serializer.  It
+//    checks that structures written as compact and pretty-printed text
+//    build the same structure again, that strings and numbers are
+//    written exactly as they were read, and that decoded strings are
+//    restored by JsonText::encode().  This file is intended to be used as
+//    part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <sstream>
+#include <string>
+#include "JsonFactory.h"
+#include "JsonArena.h"
+#include "JsonDiff.h"
+#include "JsonSerializer.h"
+#include "JsonText.h"
+#include "JsonTest.h"
+
+using namespace std;
+
+// a document holding each kind of value, with escapes in keys and
+// strings and numbers in several forms
+static const char* DOCUMENT =
+    "{\"name\":\"a\\\"b\\\\c\\/d\\n\\t\\u00e9\\ud83d\\ude00\",\"key \\\"q\\\"\":\"\xc3\xa9\","
+    "\"numbers\":[0,-0,1.50,-2e3,1E-2,12345678901],\"flags\":[true,false,null],"
+    "\"empty\":{},\"none\":[],\"nested\":{\"a\":[{\"b\":[[1],[]]},{}]}}";
+
+// the pretty-printed text of a small document
+static const char* PRETTY =
+    "{\n"
+    "   \"a\":[\n"
+    "      1,\n"
+    "      {\n"
+    "         \"b\":[\n"
+    "         ]\n"
+    "      },\n"
+    "      {\n"
+    "      }\n"
+    "   ],\n"
+    "   \"c\":{\n"
+    "      \"d\":\"x\"\n"
+    "   }\n"
+    "}";
+
+//*******************************************************************
+// roundTrip()
+//
+// serialize a structure, build the text again, and check that the
+// structure and its text are unchanged.
+//
+// parameters:
+//    name - the name of the test
+//    val - the structure to serialize
+//    pretty - true to pretty print the text
+// returns:
+//    true if the test passed, otherwise false
+static bool roundTrip(const string& name, JsonAbstractValue* val, bool pretty) {
+    JsonFactory jf;
+    string first = JsonSerializer::toString(val, pretty);
+    JsonAbstractValue* rebuilt = jf.build(first);
+    bool passed = (rebuilt) && (JsonDiff::equals(val, rebuilt)) &&
+        (JsonSerializer::toString(rebuilt, pretty) == first);
+    delete rebuilt;
+    return check(name, passed);
+}
+
+//*******************************************************************
+// decodedMatches()
+//
+// check that encoding each decoded string and key of a structure gives
+// the text that it was read from.
+//
+// parameters:
+//    decoded - the structure built with decoding enabled
+//    raw - the same structure built without decoding
+// returns:
+//    true if every string matches, otherwise false
+static bool decodedMatches(JsonAbstractValue* decoded, JsonAbstractValue* raw) {
+    if (JsonValue* val = dynamic_cast<JsonValue*>(decoded)) {
+        JsonValue* original = dynamic_cast<JsonValue*>(raw);
+        if ((!original) || (val->getType() != original->getType())) return false;
+        if (val->getType() != JSON_STRING) return val->getText() == original->getText();
+        string encoded;
+        JsonText::encode(val->getText(), encoded);
+        string expected;
+        return (JsonText::decode(original->getText(), expected)) && (expected == val->getText()) &&
+            (JsonText::decode(encoded, expected)) && (expected == val->getText());
+    }
+    if (JsonObject* obj = dynamic_cast<JsonObject*>(decoded)) {
+        JsonObject* original = dynamic_cast<JsonObject*>(raw);
+        if ((!original) || (obj->size() != original->size())) return false;
+        for (unsigned long i = 0; i < obj->size(); i++) {
+            string key;
+            if (!JsonText::decode(original->getElementKeyView(i), key)) return false;
+            if (key != obj->getElementKeyView(i)) return false;
+            if (!decodedMatches(obj->getElement(i), original->getElement(i))) return false;
+        }
+        return true;
+    }
+    JsonArray* ary = dynamic_cast<JsonArray*>(decoded);
+    JsonArray* original = dynamic_cast<JsonArray*>(raw);
+    if ((!ary) || (!original) || (ary->size() != original->size())) return false;
+    for (unsigned long i = 0; i < ary->size(); i++) {
+        if (!decodedMatches(ary->getElement(i), original->getElement(i))) return false;
+    }
+    return true;
+}
+
+//*******************************************************************
+// main()
+//
+// serialize structures and check the results.
+//
+// This program returns non-zero if a test fails.
+//
+int main() {
+    JsonFactory jf;
+    bool passed = true;
+    string text = DOCUMENT;
+
+    // strings, keys and numbers are written exactly as they were read
+    JsonAbstractValue* root = jf.build(text);
+    passed &= check("compact text unchanged", JsonSerializer::toString(root) == text);
+    passed &= roundTrip("compact round trip", root, false);
+    passed &= roundTrip("pretty round trip", root, true);
+
+    // dump() and flush() give the same text as toString()
+    {
+        ostringstream dumped;
+        root->dump(dumped, true);
+        ostringstream flushed;
+        JsonSerializer serializer(true);
+        serializer.write(root);
+        serializer.flush(flushed);
+        passed &= check("dump matches serializer", (dumped.str() == JsonSerializer::toString(root, true)) &&
+            (flushed.str() == dumped.str()) && (serializer.size() == 0));
+    }
+
+    // the layout of pretty-printed text
+    {
+        JsonAbstractValue* small = jf.build(string("{\"a\":[1,{\"b\":[]},{}],\"c\":{\"d\":\"x\"}}"));
+        passed &= check("pretty layout", JsonSerializer::toString(small, true) == PRETTY);
+        JsonAbstractValue* rebuilt = jf.build(string(PRETTY));
+        passed &= check("pretty rebuilds", ::text(rebuilt) == ::text(small));
+        delete rebuilt;
+        delete small;
+    }
+
+    // a serializer may be reused, appending until it is cleared
+    {
+        JsonSerializer serializer;
+        serializer.reserve(1024);
+        serializer.write(root);
+        serializer.write(root);
+        bool appended = serializer.view() == text + text;
+        serializer.clear();
+        serializer.write(root);
+        passed &= check("serializer reuse", (appended) && (serializer.view() == text));
+    }
+
+    // structures built from a buffer and into an arena are written alike
+    {
+        JsonArena arena;
+        passed &= check("arena text unchanged", JsonSerializer::toString(jf.buildView(text, arena)) == text);
+        passed &= roundTrip("arena round trip", jf.buildView(text, arena), true);
+    }
+
+    // decoded strings are held, and written, without escapes - encoding
+    // them restores text that decodes to the same string
+    {
+        JsonFactory decoder;
+        decoder.setDecode(true);
+        JsonAbstractValue* decoded = decoder.build(text);
+        passed &= check("decoded strings encode", (decoded) && (decodedMatches(decoded, root)));
+        string encoded;
+        JsonText::encode(string("q\"b\\s\x01\x1f\n\r\t\b\f/\xc3\xa9"), encoded);
+        passed &= check("encode escapes", encoded == "q\\\"b\\\\s\\u0001\\u001f\\n\\r\\t\\b\\f/\xc3\xa9");
+        delete decoded;
+    }
+
+    // a large structure
+    {
+        string large = "[";
+        for (int i = 0; i < 20000; i++) {
+            if (i) large += ",";
+            large += text;
+        }
+        large += "]";
+        JsonAbstractValue* big = jf.build(large);
+        passed &= check("large text unchanged", JsonSerializer::toString(big) == large);
+        passed &= roundTrip("large round trip", big, true);
+        delete big;
+    }
+    delete root;
+    return (passed) ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+//*******************************************************************
+//    JsonSnapshotTest.cpp
+//
+//    This file provides a test program for JSON snapshots.  It checks
+//    that structures survive being encoded and loaded, that loading
+//    restores containers only when they are used, and that truncated
+//    and corrupt images are rejected.  This file is intended to be
+//    used as part of the PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <cstring>
+#include <string>
+#include "JsonFactory.h"
+#include "JsonArena.h"
+#include "JsonDiff.h"
+#include "JsonSnapshot.h"
+#include "JsonTest.h"
+
+using namespace std;
+
+// the layout of a snapshot image - a 32 byte header followed by 32
+// byte records, the first of which is the outermost value
+#define HEADER_SIZE 32
+#define RECORD_SIZE 32
+
+// a document holding each kind of value
+static const char* DOCUMENT =
+    "{\"name\":\"snap\\\"shot\",\"count\":3,\"ratio\":-1.5e3,\"flags\":[true,false,null],"
+    "\"empty\":{},\"none\":[],\"nested\":{\"a\":[{\"b\":[[1],[2,{\"c\":\"d\"}]]}]},\"name2\":\"snap\\\"shot\"}";
+
+//*******************************************************************
+// records()
+//
+// return the text of a document holding an array of records.
+//
+// parameters:
+//    count - the number of records
+// returns:
+//    the text of the document
+static string records(long count) {
+    string result = "[";
+    for (long i = 0; i < count; i++) {
+        if (i) result += ",";
+        result += "{\"id\":" + to_string(i) + ",\"tags\":[\"a\",\"b\"]}";
+    }
+    return result + "]";
+}
+
+//*******************************************************************
+// main()
+//
+// encode and load snapshots and check the results.
+//
+// This program returns non-zero if a test fails.
+//
+int main() {
+    JsonFactory jf;
+    JsonArena arena;
+    JsonSnapshot snapshot;
+    bool passed = true;
+
+    // a structure survives being encoded and loaded
+    JsonAbstractValue* original = jf.build(string(DOCUMENT), arena);
+    string image;
+    passed &= check("encode", (snapshot.encode(original, image)) && (JsonSnapshot::isSnapshot(image)));
+    JsonArena restored;
+    JsonAbstractValue* copy = snapshot.load(image, restored);
+    passed &= check("round trip text", text(copy) == text(original));
+    passed &= check("round trip equal", (copy) && (JsonDiff::equals(original, copy)));
+    string scalar;
+    snapshot.encode(jf.build(string("[42]"), arena), scalar);
+    passed &= check("round trip array", text(snapshot.load(scalar, restored)) == "[42]");
+
+    // loading builds only the outermost container - its contents are
+    // built when they are used
+    JsonAbstractValue* large = jf.build(records(10000), arena);
+    snapshot.encode(large, image);
+    JsonArena lazy;
+    JsonAbstractValue* loaded = snapshot.load(image, lazy);
+    unsigned long loadBytes = lazy.bytesUsed();
+    string all = text(loaded);
+    cout << "load used " << loadBytes << " bytes, use " << lazy.bytesUsed() << " bytes" << endl;
+    passed &= check("load is lazy", (loadBytes < 1024) && (lazy.bytesUsed() > 100 * loadBytes));
+    passed &= check("lazy round trip", all == text(large));
+
+    // truncated and corrupt images are rejected
+    snapshot.encode(original, image);
+    passed &= check("empty image", !snapshot.load(string_view(), restored));
+    passed &= check("header only", !snapshot.load(string_view(image).substr(0, HEADER_SIZE), restored));
+    passed &= check("truncated pool", !snapshot.load(string_view(image).substr(0, image.length() - 1), restored));
+    passed &= check("truncated tape", !snapshot.load(string_view(image).substr(0, HEADER_SIZE + RECORD_SIZE), restored));
+    string corrupt = image;
+    corrupt[HEADER_SIZE] = 9;
+    passed &= check("bad tag", !snapshot.load(corrupt, restored));
+    corrupt = image;
+    corrupt[HEADER_SIZE + 4]++;
+    passed &= check("bad child count", !snapshot.load(corrupt, restored));
+    corrupt = image;
+    corrupt[HEADER_SIZE + RECORD_SIZE + 4] = 0x7f;
+    passed &= check("bad key text", !snapshot.load(corrupt, restored));
+    corrupt = image;
+    corrupt[0] = 'X';
+    passed &= check("bad magic", !JsonSnapshot::isSnapshot(corrupt) && !snapshot.load(corrupt, restored));
+
+    // an image damaged anywhere is either rejected or restores a
+    // structure that can be used in full (the errors are not reported)
+    bool survived = true;
+    streambuf* errors = cerr.rdbuf(NULL);
+    for (unsigned long i = 0; i < image.length(); i++) {
+        for (int change = 1; change < 256; change *= 2) {
+            corrupt = image;
+            corrupt[i] ^= change;
+            JsonArena damaged;
+            JsonAbstractValue* val = snapshot.load(corrupt, damaged);
+            if ((val) && (text(val).empty())) survived = false;
+        }
+    }
+    cerr.rdbuf(errors);
+    cerr.clear();
+    passed &= check("damaged images", survived);
+    return (passed) ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+//*******************************************************************
+//    JsonStreamTest.cpp
+//
+//    This file provides a test program for building a sequence of JSON
+//    documents (NDJSON) with JsonFactory::next().  Each input is read
+//    from a buffer and from streams with windows of several sizes, and
+//    badly formed lines are checked to yield exactly one NULL document
+//    each without disturbing the lines that follow.  This file is
+//    intended to be used as part of the PICMG IoT library reference
+//    code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <sstream>
+#include <string>
+#include <vector>
+#include "JsonFactory.h"
+#include "JsonArena.h"
+#include "JsonTest.h"
+
+using namespace std;
+
+// newline delimited documents, with badly formed lines
+static const char* LINES =
+    "{\"a\":1}\n"
+    "[1,2,3]\n"
+    "\"str\"\n"
+    "{\"a\":\n"                         // unfinished document
+    "{\"b\":\"x\ny\"}\n"                // raw newline within a string
+    "garbage\n"                         // not a document
+    "{\"c\":[1,2}\n"                    // mismatched brackets
+    "{\"d\":\"q \\\" \\\\\"}\n"         // escaped quote and backslash
+    "{\"e\":1} {\"f\":2}\n"             // two documents on a line
+    "{\"g\":1}x\n"                      // a document followed by text
+    "  \n"                              // a blank line
+    "{\"h\":[\n1]}\n"                   // a document spanning lines
+    "{\"last\":true}";                  // no final newline
+
+// the documents built from the lines above
+static const char* EXPECTED[] = {
+    "{\"a\":1}", "[1,2,3]", "\"str\"",
+    "NULL", "NULL", "NULL", "NULL", "NULL",
+    "{\"d\":\"q \\\" \\\\\"}", "{\"e\":1}", "{\"f\":2}", "{\"g\":1}",
+    "NULL", "NULL", "NULL",
+    "{\"last\":true}"
+};
+
+//*******************************************************************
+// readAll()
+//
+// build every document of the input.
+//
+// parameters:
+//    jf - the factory the input was opened with
+//    arena - the arena to build the documents in, or NULL to build them
+//       on the heap
+// returns:
+//    the text of each document, or "NULL" for a badly formed document
+static vector<string> readAll(JsonFactory& jf, JsonArena* arena) {
+    vector<string> result;
+    while (!jf.atEnd()) {
+        if (arena) {
+            // the arena is reset between documents so its memory is reused
+            arena->reset();
+            result.push_back(::text(jf.next(*arena)));
+        } else {
+            JsonAbstractValue* doc = jf.next();
+            result.push_back(::text(doc));
+            delete doc;
+        }
+    }
+    jf.close();
+    return result;
+}
+
+//*******************************************************************
+// readEach()
+//
+// build every document of the input from a buffer and from streams
+// with windows of several sizes, on the heap and in an arena, and check
+// that the results are as expected.
+//
+// parameters:
+//    name - the name of the test
+//    text - the input
+//    expected - the text of each document
+//    delimited - true if each document must lie on a single line
+// returns:
+//    true if the test passed, otherwise false
+static bool readEach(const string& name, const string& text, const vector<string>& expected, bool delimited) {
+    static const unsigned long windows[] = { 0, 1, 5, 64, 4096 };
+    bool passed = true;
+    for (int useArena = 0; useArena < 2; useArena++) {
+        for (unsigned long window : windows) {
+            JsonFactory jf;
+            JsonArena arena;
+            jf.setDelimited(delimited);
+            istringstream in(text);
+            if (window) {
+                jf.open(in, window);
+            } else {
+                jf.open(text);
+            }
+            vector<string> actual = readAll(jf, (useArena) ? &arena : NULL);
+            if (actual != expected) {
+                cout << "  " << ((window) ? "window " + to_string(window) : string("buffer")) <<
+                    ((useArena) ? " arena" : " heap") << ": " << actual.size() << " documents" << endl;
+                passed = false;
+            }
+        }
+    }
+    return check(name, passed);
+}
+
+//*******************************************************************
+// main()
+//
+// build sequences of documents and check the results.
+//
+// This program returns non-zero if a test fails.
+//
+int main() {
+    bool passed = true;
+
+    // each badly formed line yields one NULL document
+    {
+        // silence the reports of the badly formed lines
+        streambuf* saved = cerr.rdbuf(NULL);
+        vector<string> expected(EXPECTED, EXPECTED + sizeof(EXPECTED) / sizeof(EXPECTED[0]));
+        passed &= readEach("bad line recovery", LINES, expected, true);
+        cerr.rdbuf(saved);
+        cerr.clear();
+    }
+
+    // without delimiting, documents may span lines and need not be
+    // separated
+    {
+        string text = "{\"a\":1}{\"b\":[2,\n3]}[4]\"five\"\n\n  {\"six\":\n{}}  ";
+        vector<string> expected = { "{\"a\":1}", "{\"b\":[2,3]}", "[4]", "\"five\"", "{\"six\":{}}" };
+        passed &= readEach("concatenated documents", text, expected, false);
+    }
+
+    // many documents, with bad lines scattered among them
+    {
+        streambuf* saved = cerr.rdbuf(NULL);
+        string text;
+        vector<string> expected;
+        for (int i = 0; i < 2000; i++) {
+            string doc = "{\"id\":" + to_string(i) + ",\"name\":\"device \\\"" + to_string(i) +
+                "\\\"\",\"pins\":[\"J1.1\",\"J1.2\"],\"limits\":{\"min\":-1.5,\"max\":2e3}}";
+            if (i % 97 == 0) {
+                // cut the document short
+                text += doc.substr(0, doc.length() / 2) + "\n";
+                expected.push_back("NULL");
+            } else {
+                text += doc + "\n";
+                expected.push_back(doc);
+            }
+        }
+        passed &= readEach("large input", text, expected, true);
+        cerr.rdbuf(saved);
+        cerr.clear();
+    }
+
+    // an empty input holds no documents
+    {
+        JsonFactory jf;
+        jf.open(string_view(" \n \n"));
+        passed &= check("empty input", (jf.atEnd()) && (jf.next() == NULL));
+    }
+    return (passed) ? 0 : 1;
+}
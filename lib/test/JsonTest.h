@@ -0,0 +1,66 @@
+//*******************************************************************
+//    JsonTest.h
+//
+//    This file provides the helpers shared by the test programs of the
+//    JSON library.  Each test program runs a set of checks, reports
+//    each one on the standard output and returns non-zero if any of
+//    them failed.  This header is intended to be used as part of the
+//    PICMG IoT library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "JsonAbstractValue.h"
+
+using namespace std;
+
+//*******************************************************************
+// check()
+//
+// report the result of a test.
+//
+// parameters:
+//    name - the name of the test
+//    passed - true if the test passed
+// returns:
+//    true if the test passed, otherwise false
+static inline bool check(const string& name, bool passed) {
+    cout << ((passed) ? "PASS " : "FAIL ") << name << endl;
+    return passed;
+}
+
+//*******************************************************************
+// text()
+//
+// return the compact serialized text of a value.
+//
+// parameters:
+//    val - the value to serialize (may be NULL)
+// returns:
+//    the text of the value, or "NULL" if there is no value
+static inline string text(JsonAbstractValue* val) {
+    if (!val) return "NULL";
+    ostringstream out;
+    val->dump(out, false);
+    return out.str();
+}
@@ -0,0 +1,302 @@
+//*******************************************************************
+//    JsonTextTest.cpp
+//
+//    This file provides a test program for the JSON string helpers.  It
+//    checks UTF-8 validation, the decoding of escape sequences and the
+//    UTF-8 to UTF-16BE transcoder against simple reference encoders, with
+//    the text placed so that both the vector and the scalar paths are
+//    used.  This file is intended to be used as part of the PICMG IoT
+//    library reference code.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2020,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <string>
+#include <vector>
+#include "JsonFactory.h"
+#include "JsonArena.h"
+#include "JsonText.h"
+#include "JsonTest.h"
+
+using namespace std;
+
+// the state of the pseudo-random number generator
+static unsigned long seed = 12345;
+
+//*******************************************************************
+// nextRandom()
+//
+// return a pseudo-random number.  A fixed sequence is used so that any
+// failure can be repeated.
+//
+// parameters:
+//    limit - one more than the largest number to return
+// returns:
+//    a number from 0 to limit - 1
+static unsigned long nextRandom(unsigned long limit) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (seed >> 33) % limit;
+}
+
+//*******************************************************************
+// utf8()
+//
+// append the UTF-8 encoding of a code point to a string.
+//
+// parameters:
+//    cp - the code point
+//    out - the string to append to
+// returns:
+//    void
+static void utf8(unsigned long cp, string& out) {
+    if (cp < 0x80) {
+        out += (char)cp;
+    } else if (cp < 0x800) {
+        out += (char)(0xC0 | (cp >> 6));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += (char)(0xE0 | (cp >> 12));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else {
+        out += (char)(0xF0 | (cp >> 18));
+        out += (char)(0x80 | ((cp >> 12) & 0x3F));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+//*******************************************************************
+// utf16be()
+//
+// append the UTF-16BE encoding of a code point to a string.
+//
+// parameters:
+//    cp - the code point
+//    out - the string to append to
+// returns:
+//    void
+static void utf16be(unsigned long cp, string& out) {
+    if (cp >= 0x10000) {
+        utf16be(0xD800 + ((cp - 0x10000) >> 10), out);
+        cp = 0xDC00 + ((cp - 0x10000) & 0x3FF);
+    }
+    out += (char)(cp >> 8);
+    out += (char)(cp & 0xFF);
+}
+
+//*******************************************************************
+// escape()
+//
+// append a code point to a string as JSON escape sequences.
+//
+// parameters:
+//    cp - the code point
+//    out - the string to append to
+// returns:
+//    void
+static void escape(unsigned long cp, string& out) {
+    static const char hex[] = "0123456789abcdef";
+    if (cp >= 0x10000) {
+        escape(0xD800 + ((cp - 0x10000) >> 10), out);
+        cp = 0xDC00 + ((cp - 0x10000) & 0x3FF);
+    }
+    out += "\\u";
+    for (int shift = 12; shift >= 0; shift -= 4) out += hex[(cp >> shift) & 15];
+}
+
+//*******************************************************************
+// randomCharacter()
+//
+// return a pseudo-random code point.  Runs of ASCII are favoured so
+// that the vector paths are used, and surrogates are never returned.
+//
+// parameters:
+//    none
+// returns:
+//    the code point
+static unsigned long randomCharacter() {
+    switch (nextRandom(4)) {
+    case 0: return 0x80 + nextRandom(0x800 - 0x80);
+    case 1: {
+        unsigned long cp = 0x800 + nextRandom(0x10000 - 0x800 - 0x800);
+        return (cp >= 0xD800) ? cp + 0x800 : cp;
+    }
+    case 2: return 0x10000 + nextRandom(0x110000 - 0x10000);
+    default: return 0x20 + nextRandom(0x5F);
+    }
+}
+
+//*******************************************************************
+// main()
+//
+// check the string helpers.
+//
+// This program returns non-zero if a test fails.
+//
+int main() {
+    bool passed = true;
+
+    // the boundaries of each encoding length
+    {
+        static const unsigned long points[] = { 0x00, 0x7F, 0x80, 0x7FF, 0x800, 0xD7FF, 0xE000, 0xFFFD,
+            0xFFFF, 0x10000, 0x10FFFF };
+        string text;
+        string expected;
+        string escaped;
+        for (unsigned long cp : points) {
+            utf8(cp, text);
+            utf16be(cp, expected);
+            escape(cp, escaped);
+        }
+        string actual;
+        string decoded;
+        passed &= check("boundaries valid", JsonText::isValidUtf8(text));
+        passed &= check("boundaries transcode", (JsonText::utf8ToUtf16be(text, actual)) && (actual == expected));
+        passed &= check("boundaries decode", (JsonText::decode(escaped, decoded)) && (decoded == text));
+    }
+
+    // random text, with runs of ASCII of every length
+    {
+        unsigned long failures = 0;
+        for (int trial = 0; trial < 2000; trial++) {
+            string text;
+            string expected;
+            string escaped;
+            unsigned long count = nextRandom(80);
+            for (unsigned long i = 0; i < count; i++) {
+                // a run of plain text, long enough at times to use the
+                // vector paths
+                string run(nextRandom(3) ? 0 : nextRandom(40), 'a' + (char)nextRandom(26));
+                text += run;
+                escaped += run;
+                for (char c : run) utf16be(c, expected);
+
+                unsigned long cp = randomCharacter();
+                utf8(cp, text);
+                utf16be(cp, expected);
+                if (nextRandom(2)) {
+                    escape(cp, escaped);
+                } else if (cp == '\\') {
+                    escaped += "\\\\";
+                } else {
+                    utf8(cp, escaped);
+                }
+            }
+            string actual = "prefix";
+            string decoded;
+            bool ok = (JsonText::isValidUtf8(text)) && (JsonText::isValidUtf8(escaped)) &&
+                (JsonText::utf8ToUtf16be(text, actual)) && (actual == "prefix" + expected) &&
+                (JsonText::decode(escaped, decoded)) && (decoded == text);
+            if ((!ok) && (failures++ < 5)) cout << "  trial " << trial << " failed" << endl;
+        }
+        passed &= check("random text", failures == 0);
+    }
+
+    // short escapes
+    {
+        string decoded;
+        passed &= check("short escapes", (JsonText::decode("\\\"\\\\\\/\\b\\f\\n\\r\\tx", decoded)) &&
+            (decoded == "\"\\/\b\f\n\r\tx"));
+        passed &= check("upper case hex", (JsonText::decode("\\u00E9\\uD83D\\uDE00", decoded)) &&
+            (decoded == "\xc3\xa9\xf0\x9f\x98\x80"));
+        passed &= check("no escapes", (!JsonText::hasEscapes("plain text")) && (JsonText::hasEscapes("a\\n")));
+    }
+
+    // invalid UTF-8, placed before, within and after runs of ASCII
+    {
+        static const char* invalid[] = {
+            "\x80",                 // continuation without a lead byte
+            "\xc0\xaf",             // overlong encoding of '/'
+            "\xc1\xbf",             // overlong two byte encoding
+            "\xe0\x80\xaf",         // overlong three byte encoding
+            "\xf0\x80\x80\xaf",     // overlong four byte encoding
+            "\xed\xa0\x80",         // high surrogate
+            "\xed\xbf\xbf",         // low surrogate
+            "\xf4\x90\x80\x80",     // above U+10FFFF
+            "\xf5\x80\x80\x80",     // invalid lead byte
+            "\xff",                 // invalid byte
+            "\xc3",                 // truncated two byte character
+            "\xe2\x82",             // truncated three byte character
+            "\xf0\x9f\x98",         // truncated four byte character
+            "\xc3\x28",             // lead byte followed by ASCII
+        };
+        unsigned long failures = 0;
+        for (const char* bad : invalid) {
+            for (unsigned long offset = 0; offset < 40; offset += 3) {
+                string text = string(offset, 'x') + bad + string(offset % 20, 'y');
+                string transcoded;
+                string decoded;
+                JsonArena arena;
+                bool ok;
+                bool rejected = (!JsonText::isValidUtf8(text)) && (!JsonText::utf8ToUtf16be(text, transcoded)) &&
+                    (transcoded.find("\xff\xfd") != string::npos) && (!JsonText::decode(text, decoded)) &&
+                    (decoded.empty()) && (JsonText::decode(text, arena, false, ok).empty()) && (!ok);
+                if ((!rejected) && (failures++ < 5)) cout << "  invalid sequence not rejected at " << offset << endl;
+            }
+        }
+        passed &= check("invalid utf-8", failures == 0);
+    }
+
+    // invalid escape sequences
+    {
+        static const char* invalid[] = { "\\", "\\x", "\\u12", "\\u12g4", "\\uD83D", "\\uD83Dx", "\\uD83D\\u0041",
+            "\\uDE00", "\\uD83D\\n" };
+        bool rejected = true;
+        for (const char* bad : invalid) {
+            string decoded;
+            rejected &= !JsonText::decode(string("text") + bad, decoded);
+        }
+        passed &= check("invalid escapes", rejected);
+    }
+
+    // decoding into an arena refers to text without escapes, and copies
+    // it only when asked to
+    {
+        JsonArena arena;
+        bool ok;
+        string_view plain = "plain \xc3\xa9";
+        string_view view = JsonText::decode(plain, arena, false, ok);
+        string_view copy = JsonText::decode(plain, arena, true, ok);
+        string_view decoded = JsonText::decode("a\\tb", arena, false, ok);
+        passed &= check("arena decode", (ok) && (view.data() == plain.data()) && (copy == plain) &&
+            (copy.data() != plain.data()) && (decoded == "a\tb"));
+    }
+
+    // the factory decodes strings and keys, and rejects invalid text,
+    // only when decoding is enabled
+    {
+        JsonFactory jf;
+        string text = "{\"k\\u00e9y\":[\"a\\nb\",\"\\ud83d\\ude00\"]}";
+        JsonAbstractValue* raw = jf.build(text);
+        jf.setDecode(true);
+        JsonAbstractValue* decoded = jf.build(text);
+        passed &= check("factory decode", (raw) && (::text(raw) == text) && (decoded) &&
+            (::text(decoded) == "{\"k\xc3\xa9y\":[\"a\nb\",\"\xf0\x9f\x98\x80\"]}"));
+        delete raw;
+        delete decoded;
+        string bad = "[\"ok\",\"\xc0\xaf\"]";
+        passed &= check("factory rejects invalid", jf.build(bad) == NULL);
+        jf.setDecode(false);
+        raw = jf.build(bad);
+        passed &= check("factory keeps text when not decoding", raw != NULL);
+        delete raw;
+    }
+    return (passed) ? 0 : 1;
+}
@@ -0,0 +1,867 @@
+//*******************************************************************
+//    ConfigModel.cpp
+//
+//    This file contains the implementation of the typed model of the
+//    builder config file.  The model is filled by an event handler
+//    that follows the layout of the config, so each value is converted
+//    once as it is read and the builder never looks a field up by name.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2021,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "ConfigModel.h"
+#include "JsonPointer.h"
+#include "JsonEventHandler.h"
+#include "JsonFactory.h"
+#include "JsonObject.h"
+#include "JsonArray.h"
+#include "JsonValue.h"
+
+// the kinds of value that a field may hold (combined as a bit mask).
+// The kinds of value primitive follow the order of JsonValueType.
+enum ConfigKind {
+    KIND_NULL    = 1 << JSON_NULL,
+    KIND_BOOLEAN = 1 << JSON_BOOLEAN,
+    KIND_INTEGER = 1 << JSON_INTEGER,
+    KIND_DOUBLE  = 1 << JSON_DOUBLE,
+    KIND_STRING  = 1 << JSON_STRING,
+    KIND_OBJECT  = 0x20,
+    KIND_ARRAY   = 0x40,
+    KIND_NUMBER  = KIND_INTEGER | KIND_DOUBLE,
+    KIND_ANY     = 0x7f
+};
+
+// the parts of the config that are read into the model
+enum ConfigNode {
+    NODE_NONE,           // a value that is not read
+    NODE_ROOT,
+    NODE_CAPABILITIES,
+    NODE_CHANNELS,
+    NODE_CHANNEL,
+    NODE_CONFIGURATION,
+    NODE_FRU_RECORDS,
+    NODE_FRU_RECORD,
+    NODE_FRU_FIELDS,
+    NODE_FRU_FIELD,
+    NODE_FRU_BYTES,
+    NODE_ENTITIES,
+    NODE_ENTITY,
+    NODE_BINDINGS,
+    NODE_BINDING,
+    NODE_TRANSDUCER,
+    NODE_CURVE,
+    NODE_POINT,
+    NODE_PARAMETERS,
+    NODE_PARAMETER,
+    NODE_STATE_SETS,
+    NODE_STATE_SET,
+    NODE_STATE_RECORDS,
+    NODE_STATE_RECORD,
+    NODE_LANGUAGE_TAGS,
+    NODE_STATE_NAMES
+};
+
+// a field of the config that is read into a ConfigValue member
+template <class T> struct ValueField {
+    const char*      key;        // the field name
+    ConfigValue T::* value;      // the member that holds the field
+    unsigned int     kinds;      // the kinds of value allowed
+    bool             required;   // true if the field must be present
+    double           minimum;    // the smallest number allowed
+    double           maximum;    // the largest number allowed
+};
+
+// the range of a field that allows any number
+#define NO_RANGE -HUGE_VAL, HUGE_VAL
+
+static const ValueField<ConfigCapabilities> CAPABILITY_FIELDS[] = {
+    { "device",        &ConfigCapabilities::device,  KIND_ANY,    false, NO_RANGE }
+};
+
+static const ValueField<ConfigChannel> CHANNEL_FIELDS[] = {
+    { "name",          &ConfigChannel::name,          KIND_STRING, true,  NO_RANGE },
+    { "type",          &ConfigChannel::type,          KIND_ANY,    false, NO_RANGE },
+    { "accuracy",      &ConfigChannel::accuracy,      KIND_NUMBER, false, NO_RANGE },
+    { "precision",     &ConfigChannel::precision,     KIND_ANY,    false, NO_RANGE },
+    { "minValue",      &ConfigChannel::minValue,      KIND_ANY,    false, NO_RANGE },
+    { "maxValue",      &ConfigChannel::maxValue,      KIND_ANY,    false, NO_RANGE },
+    { "minValueAtPin", &ConfigChannel::minValueAtPin, KIND_ANY,    false, NO_RANGE },
+    { "maxValueAtPin", &ConfigChannel::maxValueAtPin, KIND_ANY,    false, NO_RANGE }
+};
+
+static const ValueField<ConfigFruRecord> FRU_RECORD_FIELDS[] = {
+    { "vendorIANA",    &ConfigFruRecord::vendorIANA,  KIND_INTEGER, true, NO_RANGE }
+};
+
+// the value of a fru field is read separately as it may be an array
+static const ValueField<ConfigFruField> FRU_FIELD_FIELDS[] = {
+    { "type",          &ConfigFruField::type,         KIND_INTEGER, true, 0, 255 },
+    { "format",        &ConfigFruField::format,       KIND_STRING,  true, NO_RANGE }
+};
+
+static const ValueField<ConfigEntity> ENTITY_FIELDS[] = {
+    { "name",             &ConfigEntity::name,             KIND_STRING,  true,  NO_RANGE },
+    { "entityVendorIANA", &ConfigEntity::entityVendorIANA, KIND_INTEGER, false, NO_RANGE },
+    { "vendorEntityID",   &ConfigEntity::vendorEntityID,   KIND_INTEGER, false, NO_RANGE }
+};
+
+static const ValueField<ConfigBinding> BINDING_FIELDS[] = {
+    { "name",                    &ConfigBinding::name,                    KIND_STRING,              true,  NO_RANGE },
+    { "bindingType",             &ConfigBinding::bindingType,             KIND_STRING | KIND_NULL,  false, NO_RANGE },
+    { "boundChannel",            &ConfigBinding::boundChannel,            KIND_STRING | KIND_NULL,  false, NO_RANGE },
+    { "isVirtual",               &ConfigBinding::isVirtual,               KIND_BOOLEAN,             false, NO_RANGE },
+    { "includeInPdr",            &ConfigBinding::includeInPdr,            KIND_BOOLEAN,             false, NO_RANGE },
+    { "sensorID",                &ConfigBinding::sensorID,                KIND_INTEGER,             false, NO_RANGE },
+    { "effecterID",              &ConfigBinding::effecterID,              KIND_INTEGER,             false, NO_RANGE },
+    { "stateSet",                &ConfigBinding::stateSet,                KIND_INTEGER | KIND_NULL, false, NO_RANGE },
+    { "stateSetVendor",          &ConfigBinding::stateSetVendor,          KIND_ANY,                 false, NO_RANGE },
+    { "usedStates",              &ConfigBinding::usedStates,              KIND_ANY,                 false, NO_RANGE },
+    { "stateWhenHigh",           &ConfigBinding::stateWhenHigh,           KIND_ANY,                 false, NO_RANGE },
+    { "stateWhenLow",            &ConfigBinding::stateWhenLow,            KIND_ANY,                 false, NO_RANGE },
+    { "defaultState",            &ConfigBinding::defaultState,            KIND_ANY,                 false, NO_RANGE },
+    { "defaultValue",            &ConfigBinding::defaultValue,            KIND_ANY,                 false, NO_RANGE },
+    { "normalMin",               &ConfigBinding::normalMin,               KIND_ANY,                 false, NO_RANGE },
+    { "normalMax",               &ConfigBinding::normalMax,               KIND_ANY,                 false, NO_RANGE },
+    { "upperThresholdWarning",   &ConfigBinding::upperThresholdWarning,   KIND_ANY,                 false, NO_RANGE },
+    { "upperThresholdCritical",  &ConfigBinding::upperThresholdCritical,  KIND_ANY,                 false, NO_RANGE },
+    { "upperThresholdFatal",     &ConfigBinding::upperThresholdFatal,     KIND_ANY,                 false, NO_RANGE },
+    { "lowerThresholdWarning",   &ConfigBinding::lowerThresholdWarning,   KIND_ANY,                 false, NO_RANGE },
+    { "lowerThresholdCritical",  &ConfigBinding::lowerThresholdCritical,  KIND_ANY,                 false, NO_RANGE },
+    { "lowerThresholdFatal",     &ConfigBinding::lowerThresholdFatal,     KIND_ANY,                 false, NO_RANGE },
+    { "physicalBaseUnit",        &ConfigBinding::physicalBaseUnit,        KIND_ANY,                 false, NO_RANGE },
+    { "physicalUnitModifier",    &ConfigBinding::physicalUnitModifier,    KIND_ANY,                 false, NO_RANGE },
+    { "physicalRateUnit",        &ConfigBinding::physicalRateUnit,        KIND_ANY,                 false, NO_RANGE },
+    { "physicalAuxUnit",         &ConfigBinding::physicalAuxUnit,         KIND_ANY,                 false, NO_RANGE },
+    { "physicalAuxUnitModifier", &ConfigBinding::physicalAuxUnitModifier, KIND_ANY,                 false, NO_RANGE },
+    { "physicalAuxRateUnit",     &ConfigBinding::physicalAuxRateUnit,     KIND_ANY,                 false, NO_RANGE },
+    { "rel",                     &ConfigBinding::rel,                     KIND_ANY,                 false, NO_RANGE },
+    { "inputGearingRatio",       &ConfigBinding::inputGearingRatio,       KIND_ANY,                 false, NO_RANGE },
+    { "outputGearingRatio",      &ConfigBinding::outputGearingRatio,      KIND_ANY,                 false, NO_RANGE }
+};
+
+static const ValueField<ConfigTransducer> TRANSDUCER_FIELDS[] = {
+    { "nominalValue",  &ConfigTransducer::nominalValue, KIND_ANY, false, NO_RANGE },
+    { "ratedMax",      &ConfigTransducer::ratedMax,     KIND_ANY, false, NO_RANGE }
+};
+
+static const ValueField<ConfigParameter> PARAMETER_FIELDS[] = {
+    { "name",          &ConfigParameter::name,  KIND_STRING, true,  NO_RANGE },
+    { "type",          &ConfigParameter::type,  KIND_STRING, false, NO_RANGE },
+    { "value",         &ConfigParameter::value, KIND_ANY,    false, NO_RANGE }
+};
+
+static const ValueField<ConfigStateSet> STATE_SET_FIELDS[] = {
+    { "stateSetID",    &ConfigStateSet::stateSetID, KIND_INTEGER, true, 0, 65535 },
+    { "vendorIANA",    &ConfigStateSet::vendorIANA, KIND_INTEGER, true, NO_RANGE }
+};
+
+static const ValueField<ConfigStateValueRecord> STATE_RECORD_FIELDS[] = {
+    { "minStateValue", &ConfigStateValueRecord::minStateValue, KIND_INTEGER, true, 0, 255 },
+    { "maxStateValue", &ConfigStateValueRecord::maxStateValue, KIND_INTEGER, true, 0, 255 }
+};
+
+//*******************************************************************
+// ConfigLoader
+//
+// an event handler that fills a ConfigModel from the events of the
+// JsonFactory parser.  Each container that is open is held on a stack
+// along with the part of the model that it fills, and each key selects
+// where the value that follows it is read to.  Fields that the builder
+// does not use are skipped without being converted.
+class ConfigLoader :
+    public JsonEventHandler
+{
+private:
+    // a container that is being read
+    struct Frame {
+        ConfigNode    node;     // the part of the config
+        void*         target;   // the part of the model being filled
+        bool          array;    // true for an array, false for an object
+        uint64_t      seen;     // the nodes of the containers found within an object
+        string        key;      // the key of the current field of an object
+        unsigned long count;    // the number of elements of an array read so far
+    };
+    // where the next value is read to
+    struct Slot {
+        ConfigNode    node;     // the node of a container value (NODE_NONE if not read)
+        void*         target;   // the part of the model that a container fills
+        ConfigValue*  value;    // the field that a value fills (or NULL)
+        unsigned int  kinds;    // the kinds of value allowed
+        double        minimum;  // the smallest number allowed
+        double        maximum;  // the largest number allowed
+    };
+    ConfigModel*  model;
+    vector<Frame> stack;
+    Slot          slot;
+    unsigned long skipped;      // the depth within a container that is not read
+    ConfigValue   element;      // the current element of an array of values
+    ConfigValue   pointIn;      // the fields of the current curve point
+    ConfigValue   pointOut;
+
+    void expect(ConfigNode node, void* target, unsigned int kinds, ConfigValue* value = NULL,
+        double minimum = -HUGE_VAL, double maximum = HUGE_VAL);
+    template <class T, unsigned long N>
+    void expect(const ValueField<T> (&fields)[N], T* target, string_view key);
+    template <class T, unsigned long N>
+    static const char* missing(const ValueField<T> (&fields)[N], T* target);
+    template <class T>
+    static T* add(void* list);
+    const char* missing(const Frame& frame);
+    void next();
+    bool open(unsigned int kind);
+    bool fail(unsigned long depth, const string& message);
+public:
+    ConfigLoader(ConfigModel* model);
+
+    // event handler interface
+    virtual bool startObject();
+    virtual bool key(string_view key);
+    virtual bool endObject();
+    virtual bool startArray();
+    virtual bool endArray();
+    virtual bool scalar(string_view text, bool quoted);
+};
+
+//*******************************************************************
+// ConfigLoader()
+//
+// constructor - the loader expects the config to be an object.
+//
+// parameters:
+//    model - the model to fill
+ConfigLoader::ConfigLoader(ConfigModel* model) : model(model), skipped(0) {
+    expect(NODE_ROOT, model, KIND_OBJECT);
+}
+
+//*******************************************************************
+// expect()
+//
+// set where the next value is read to.  When the value is a container
+// that is read, it is recorded as found within the current object.
+//
+// parameters:
+//    node - the node of a container value, or NODE_NONE if a container
+//       is skipped
+//    target - the part of the model that a container fills
+//    kinds - the kinds of value allowed
+//    value - the field that a value primitive fills (or NULL)
+//    minimum, maximum - the range of numbers allowed
+// returns:
+//    void
+void ConfigLoader::expect(ConfigNode node, void* target, unsigned int kinds, ConfigValue* value,
+    double minimum, double maximum)
+{
+    slot.node = node;
+    slot.target = target;
+    slot.value = value;
+    slot.kinds = kinds;
+    slot.minimum = minimum;
+    slot.maximum = maximum;
+    if ((node != NODE_NONE) && (!stack.empty())) stack.back().seen |= ((uint64_t)1) << node;
+}
+
+//*******************************************************************
+// expect()
+//
+// set where the value of a field is read to from a table of the
+// fields of a part of the model.  Fields that are not in the table
+// are skipped.
+//
+// parameters:
+//    fields - the table of fields
+//    target - the part of the model that holds the fields
+//    key - the name of the field
+// returns:
+//    void
+template <class T, unsigned long N>
+void ConfigLoader::expect(const ValueField<T> (&fields)[N], T* target, string_view key) {
+    for (unsigned long i = 0; i < N; i++) {
+        if (key == fields[i].key) {
+            expect(NODE_NONE, NULL, fields[i].kinds, &(target->*fields[i].value), fields[i].minimum, fields[i].maximum);
+            return;
+        }
+    }
+    expect(NODE_NONE, NULL, KIND_ANY);
+}
+
+//*******************************************************************
+// missing()
+//
+// find a required field from a table of fields that was not given.
+//
+// parameters:
+//    fields - the table of fields
+//    target - the part of the model that holds the fields
+// returns:
+//    the name of the field, or NULL if every required field was given
+template <class T, unsigned long N>
+const char* ConfigLoader::missing(const ValueField<T> (&fields)[N], T* target) {
+    for (unsigned long i = 0; i < N; i++) {
+        if ((fields[i].required) && (!(target->*fields[i].value).present)) return fields[i].key;
+    }
+    return NULL;
+}
+
+//*******************************************************************
+// add()
+//
+// add a new element to a list of the model.
+//
+// parameters:
+//    list - the list (a vector of T)
+// returns:
+//    the new element
+template <class T>
+T* ConfigLoader::add(void* list) {
+    vector<T>* elements = (vector<T>*)list;
+    elements->emplace_back();
+    return &elements->back();
+}
+
+//*******************************************************************
+// missing()
+//
+// find a required field of an object that was not given.
+//
+// parameters:
+//    frame - the object
+// returns:
+//    the name of the field, or NULL if every required field was given
+const char* ConfigLoader::missing(const Frame& frame) {
+    const char* field = NULL;
+    switch (frame.node) {
+    case NODE_ROOT:
+        if (!(frame.seen & (((uint64_t)1) << NODE_CAPABILITIES))) return "capabilities";
+        if (!(frame.seen & (((uint64_t)1) << NODE_CONFIGURATION))) return "configuration";
+        if (!(frame.seen & (((uint64_t)1) << NODE_STATE_SETS))) return "oemStateSets";
+        break;
+    case NODE_CAPABILITIES:
+        if (!(frame.seen & (((uint64_t)1) << NODE_CHANNELS))) return "channels";
+        break;
+    case NODE_CHANNEL:
+        return missing(CHANNEL_FIELDS, (ConfigChannel*)frame.target);
+    case NODE_CONFIGURATION:
+        if (!(frame.seen & (((uint64_t)1) << NODE_FRU_RECORDS))) return "fruRecords";
+        if (!(frame.seen & (((uint64_t)1) << NODE_ENTITIES))) return "logicalEntities";
+        break;
+    case NODE_FRU_RECORD:
+        field = missing(FRU_RECORD_FIELDS, (ConfigFruRecord*)frame.target);
+        if ((!field) && (!(frame.seen & (((uint64_t)1) << NODE_FRU_FIELDS)))) field = "fields";
+        break;
+    case NODE_FRU_FIELD:
+        field = missing(FRU_FIELD_FIELDS, (ConfigFruField*)frame.target);
+        if ((!field) && (!((ConfigFruField*)frame.target)->value.present)) field = "value";
+        break;
+    case NODE_ENTITY:
+        field = missing(ENTITY_FIELDS, (ConfigEntity*)frame.target);
+        if ((!field) && (!(frame.seen & (((uint64_t)1) << NODE_BINDINGS)))) field = "ioBindings";
+        if ((!field) && (!(frame.seen & (((uint64_t)1) << NODE_PARAMETERS)))) field = "parameters";
+        break;
+    case NODE_BINDING:
+        return missing(BINDING_FIELDS, (ConfigBinding*)frame.target);
+    case NODE_POINT:
+        if (!pointIn.present) return "in";
+        if (!pointOut.present) return "out";
+        break;
+    case NODE_PARAMETER:
+        return missing(PARAMETER_FIELDS, (ConfigParameter*)frame.target);
+    case NODE_STATE_SET:
+        field = missing(STATE_SET_FIELDS, (ConfigStateSet*)frame.target);
+        if ((!field) && (!(frame.seen & (((uint64_t)1) << NODE_STATE_RECORDS)))) field = "oemStateValueRecords";
+        break;
+    case NODE_STATE_RECORD:
+        field = missing(STATE_RECORD_FIELDS, (ConfigStateValueRecord*)frame.target);
+        if ((!field) && (!(frame.seen & (((uint64_t)1) << NODE_LANGUAGE_TAGS)))) field = "languageTags";
+        if ((!field) && (!(frame.seen & (((uint64_t)1) << NODE_STATE_NAMES)))) field = "stateName";
+        break;
+    default:
+        break;
+    }
+    return field;
+}
+
+//*******************************************************************
+// next()
+//
+// set where the next element of an array is read to, adding the
+// element to the list that the array fills.  Values within an object
+// are set up by key().
+//
+// parameters:
+//    none
+// returns:
+//    void
+void ConfigLoader::next() {
+    if ((stack.empty()) || (!stack.back().array)) return;
+    Frame& frame = stack.back();
+    frame.count++;
+    switch (frame.node) {
+    case NODE_CHANNELS:
+        expect(NODE_CHANNEL, add<ConfigChannel>(frame.target), KIND_OBJECT);
+        break;
+    case NODE_FRU_RECORDS:
+        expect(NODE_FRU_RECORD, add<ConfigFruRecord>(frame.target), KIND_OBJECT);
+        break;
+    case NODE_FRU_FIELDS:
+        expect(NODE_FRU_FIELD, add<ConfigFruField>(frame.target), KIND_OBJECT);
+        break;
+    case NODE_FRU_BYTES:
+        expect(NODE_NONE, NULL, KIND_INTEGER, &element, 0, 255);
+        break;
+    case NODE_ENTITIES:
+        expect(NODE_ENTITY, add<ConfigEntity>(frame.target), KIND_OBJECT);
+        break;
+    case NODE_BINDINGS:
+        expect(NODE_BINDING, add<ConfigBinding>(frame.target), KIND_OBJECT);
+        break;
+    case NODE_CURVE:
+        expect(NODE_POINT, frame.target, KIND_OBJECT);
+        break;
+    case NODE_PARAMETERS:
+        expect(NODE_PARAMETER, add<ConfigParameter>(frame.target), KIND_OBJECT);
+        break;
+    case NODE_STATE_SETS:
+        expect(NODE_STATE_SET, add<ConfigStateSet>(frame.target), KIND_OBJECT);
+        break;
+    case NODE_STATE_RECORDS:
+        expect(NODE_STATE_RECORD, add<ConfigStateValueRecord>(frame.target), KIND_OBJECT);
+        break;
+    case NODE_LANGUAGE_TAGS:
+    case NODE_STATE_NAMES:
+        expect(NODE_NONE, NULL, KIND_STRING, &element);
+        break;
+    default:
+        expect(NODE_NONE, NULL, KIND_ANY);
+        break;
+    }
+}
+
+//*******************************************************************
+// open()
+//
+// begin reading an object or array.  A container given for a field
+// that holds a value primitive makes the field present with empty
+// text, and its contents are skipped.
+//
+// parameters:
+//    kind - KIND_OBJECT or KIND_ARRAY
+// returns:
+//    true if the container is allowed, otherwise false
+bool ConfigLoader::open(unsigned int kind) {
+    if (skipped) {
+        skipped++;
+        return true;
+    }
+    next();
+    if (!(slot.kinds & kind)) return fail(stack.size(), "value does not have an allowed type");
+    if (slot.value) {
+        *slot.value = ConfigValue();
+        slot.value->present = true;
+    }
+    if (slot.node == NODE_NONE) {
+        skipped = 1;
+        return true;
+    }
+    if (slot.node == NODE_POINT) {
+        pointIn = ConfigValue();
+        pointOut = ConfigValue();
+    }
+    Frame frame = { slot.node, slot.target, kind == KIND_ARRAY, 0, string(), 0 };
+    stack.push_back(frame);
+    return true;
+}
+
+//*******************************************************************
+// fail()
+//
+// report a value that does not fit the layout of the config.
+//
+// parameters:
+//    depth - the number of open containers that enclose the value
+//    message - the reason the value was rejected
+// returns:
+//    false
+bool ConfigLoader::fail(unsigned long depth, const string& message) {
+    string path;
+    for (unsigned long i = 0; i < depth; i++) {
+        if (stack[i].array) {
+            JsonPointer::appendToken(path, to_string(stack[i].count - 1));
+        } else {
+            JsonPointer::appendToken(path, stack[i].key);
+        }
+    }
+    cerr << "Config layout error at \"" << path << "\": " << message << endl;
+    return false;
+}
+
+//*******************************************************************
+// startObject()
+//
+// begin reading a json object.
+bool ConfigLoader::startObject() {
+    return open(KIND_OBJECT);
+}
+
+//*******************************************************************
+// key()
+//
+// set where the value of the next field of the current object is
+// read to.
+bool ConfigLoader::key(string_view key) {
+    if (skipped) return true;
+    Frame& frame = stack.back();
+    frame.key = string(key);
+    switch (frame.node) {
+    case NODE_ROOT:
+        if (key == "capabilities") {
+            expect(NODE_CAPABILITIES, &model->capabilities, KIND_OBJECT);
+        } else if (key == "configuration") {
+            expect(NODE_CONFIGURATION, model, KIND_OBJECT);
+        } else if (key == "oemStateSets") {
+            expect(NODE_STATE_SETS, &model->oemStateSets, KIND_ARRAY);
+        } else {
+            expect(NODE_NONE, NULL, KIND_ANY);
+        }
+        break;
+    case NODE_CAPABILITIES:
+        if (key == "channels") {
+            expect(NODE_CHANNELS, &model->capabilities.channels, KIND_ARRAY);
+        } else {
+            expect(CAPABILITY_FIELDS, &model->capabilities, key);
+        }
+        break;
+    case NODE_CHANNEL:
+        expect(CHANNEL_FIELDS, (ConfigChannel*)frame.target, key);
+        break;
+    case NODE_CONFIGURATION:
+        if (key == "fruRecords") {
+            expect(NODE_FRU_RECORDS, &model->fruRecords, KIND_ARRAY);
+        } else if (key == "logicalEntities") {
+            expect(NODE_ENTITIES, &model->logicalEntities, KIND_ARRAY);
+        } else {
+            expect(NODE_NONE, NULL, KIND_ANY);
+        }
+        break;
+    case NODE_FRU_RECORD: {
+        ConfigFruRecord* record = (ConfigFruRecord*)frame.target;
+        if (key == "fields") {
+            expect(NODE_FRU_FIELDS, &record->fields, KIND_ARRAY);
+        } else {
+            expect(FRU_RECORD_FIELDS, record, key);
+        }
+        break;
+    }
+    case NODE_FRU_FIELD: {
+        ConfigFruField* field = (ConfigFruField*)frame.target;
+        if (key == "value") {
+            expect(NODE_FRU_BYTES, &field->bytes, KIND_STRING | KIND_INTEGER | KIND_ARRAY, &field->value);
+        } else {
+            expect(FRU_FIELD_FIELDS, field, key);
+        }
+        break;
+    }
+    case NODE_ENTITY: {
+        ConfigEntity* entity = (ConfigEntity*)frame.target;
+        if (key == "ioBindings") {
+            expect(NODE_BINDINGS, &entity->ioBindings, KIND_ARRAY);
+        } else if (key == "parameters") {
+            expect(NODE_PARAMETERS, &entity->parameters, KIND_ARRAY);
+        } else {
+            expect(ENTITY_FIELDS, entity, key);
+        }
+        break;
+    }
+    case NODE_BINDING: {
+        ConfigBinding* binding = (ConfigBinding*)frame.target;
+        if (key == "inputCurve") {
+            expect(NODE_CURVE, &binding->inputCurve, KIND_ARRAY | KIND_NULL);
+        } else if (key == "outputCurve") {
+            expect(NODE_CURVE, &binding->outputCurve, KIND_ARRAY | KIND_NULL);
+        } else if (key == "sensor") {
+            expect(NODE_TRANSDUCER, &binding->sensor, KIND_OBJECT | KIND_STRING | KIND_NULL);
+        } else if (key == "effecter") {
+            expect(NODE_TRANSDUCER, &binding->effecter, KIND_OBJECT | KIND_STRING | KIND_NULL);
+        } else {
+            expect(BINDING_FIELDS, binding, key);
+        }
+        break;
+    }
+    case NODE_TRANSDUCER: {
+        ConfigTransducer* transducer = (ConfigTransducer*)frame.target;
+        if (key == "responseCurve") {
+            expect(NODE_CURVE, &transducer->responseCurve, KIND_ARRAY | KIND_NULL);
+        } else {
+            expect(TRANSDUCER_FIELDS, transducer, key);
+        }
+        break;
+    }
+    case NODE_POINT:
+        if (key == "in") {
+            expect(NODE_NONE, NULL, KIND_NUMBER, &pointIn);
+        } else if (key == "out") {
+            expect(NODE_NONE, NULL, KIND_NUMBER, &pointOut);
+        } else {
+            expect(NODE_NONE, NULL, KIND_ANY);
+        }
+        break;
+    case NODE_PARAMETER:
+        expect(PARAMETER_FIELDS, (ConfigParameter*)frame.target, key);
+        break;
+    case NODE_STATE_SET: {
+        ConfigStateSet* set = (ConfigStateSet*)frame.target;
+        if (key == "oemStateValueRecords") {
+            expect(NODE_STATE_RECORDS, &set->oemStateValueRecords, KIND_ARRAY);
+        } else {
+            expect(STATE_SET_FIELDS, set, key);
+        }
+        break;
+    }
+    case NODE_STATE_RECORD: {
+        ConfigStateValueRecord* record = (ConfigStateValueRecord*)frame.target;
+        if (key == "languageTags") {
+            expect(NODE_LANGUAGE_TAGS, &record->languageTags, KIND_ARRAY);
+        } else if (key == "stateName") {
+            expect(NODE_STATE_NAMES, &record->stateName, KIND_ARRAY);
+        } else {
+            expect(STATE_RECORD_FIELDS, record, key);
+        }
+        break;
+    }
+    default:
+        expect(NODE_NONE, NULL, KIND_ANY);
+        break;
+    }
+    return true;
+}
+
+//*******************************************************************
+// endObject()
+//
+// complete the current object, checking that its required fields
+// were given.
+bool ConfigLoader::endObject() {
+    if (skipped) {
+        skipped--;
+        return true;
+    }
+    Frame& frame = stack.back();
+    const char* field = missing(frame);
+    if (field) return fail(stack.size() - 1, string("missing required field \"") + field + "\"");
+    if (frame.node == NODE_POINT) {
+        ConfigCurve* curve = (ConfigCurve*)frame.target;
+        curve->in.push_back(pointIn.real);
+        curve->out.push_back(pointOut.real);
+    } else if (frame.node == NODE_STATE_RECORD) {
+        ConfigStateValueRecord* record = (ConfigStateValueRecord*)frame.target;
+        if (record->stateName.size() != record->languageTags.size()) {
+            return fail(stack.size() - 1, "stateName does not have an entry for each language tag");
+        }
+    }
+    stack.pop_back();
+    return true;
+}
+
+//*******************************************************************
+// startArray()
+//
+// begin reading a json array.
+bool ConfigLoader::startArray() {
+    return open(KIND_ARRAY);
+}
+
+//*******************************************************************
+// endArray()
+//
+// complete the current array, checking its number of elements.
+bool ConfigLoader::endArray() {
+    if (skipped) {
+        skipped--;
+        return true;
+    }
+    Frame& frame = stack.back();
+    if (((frame.node == NODE_ENTITIES) && (frame.count < 1)) ||
+        (((frame.node == NODE_FRU_FIELDS) || (frame.node == NODE_FRU_BYTES)) && (frame.count > 255))) {
+        return fail(stack.size() - 1, "array does not have an allowed number of elements");
+    }
+    stack.pop_back();
+    return true;
+}
+
+//*******************************************************************
+// scalar()
+//
+// read a value primitive.  The value is converted by JsonValue so
+// that the field holds the same text and interpretations as the json
+// structure would, and its text is copied into the model.
+bool ConfigLoader::scalar(string_view text, bool quoted) {
+    if (skipped) return true;
+    next();
+    JsonValue value(text, true, quoted);
+    unsigned int kind = 1 << value.getType();
+    if (!(slot.kinds & kind)) return fail(stack.size(), "value does not have an allowed type");
+    if ((kind & KIND_NUMBER) && ((value.getDouble("") < slot.minimum) || (value.getDouble("") > slot.maximum))) {
+        return fail(stack.size(), "value is out of range");
+    }
+    if (!slot.value) return true;
+
+    ConfigValue& field = *slot.value;
+    field.present = true;
+    field.text = model->arena.copy(value.getValueView(""));
+    field.integer = value.getInteger("");
+    field.real = value.getDouble("");
+    field.boolean = value.getBoolean("");
+
+    // elements of an array of values are added to its list
+    if (!stack.empty()) {
+        Frame& frame = stack.back();
+        if (frame.node == NODE_FRU_BYTES) {
+            ((vector<long>*)frame.target)->push_back(field.integer);
+        } else if ((frame.node == NODE_LANGUAGE_TAGS) || (frame.node == NODE_STATE_NAMES)) {
+            ((vector<string_view>*)frame.target)->push_back(field.text);
+        }
+    }
+    return true;
+}
+
+//*******************************************************************
+// replay()
+//
+// report a json structure to an event handler as if its text were
+// being parsed.  The structure is walked with an explicit stack so
+// that deeply nested structures do not exhaust the call stack.
+//
+// parameters:
+//    root - the structure to report
+//    handler - the handler that receives the events
+// returns:
+//    true if the handler accepted every event, otherwise false
+static bool replay(JsonAbstractValue* root, JsonEventHandler& handler) {
+    // a container being reported, and the next of its elements
+    struct Position {
+        JsonObject*   object;
+        JsonArray*    array;
+        unsigned long index;
+    };
+    vector<Position> stack;
+    JsonAbstractValue* value = root;
+    while (true) {
+        if (value) {
+            JsonObject* obj = dynamic_cast<JsonObject*>(value);
+            JsonArray* ary = (obj) ? NULL : dynamic_cast<JsonArray*>(value);
+            JsonValue* val = ((obj) || (ary)) ? NULL : dynamic_cast<JsonValue*>(value);
+            if (obj) {
+                if (!handler.startObject()) return false;
+                stack.push_back({ obj, NULL, 0 });
+            } else if (ary) {
+                if (!handler.startArray()) return false;
+                stack.push_back({ NULL, ary, 0 });
+            } else if ((!val) || (!handler.scalar(val->getText(), val->getType() == JSON_STRING))) {
+                return false;
+            }
+            value = NULL;
+        }
+        if (stack.empty()) return true;
+
+        // report the next element of the innermost container, or its end
+        Position& top = stack.back();
+        if ((top.object) && (top.index < top.object->size())) {
+            if (!handler.key(top.object->getElementKeyView(top.index))) return false;
+            value = top.object->getElement(top.index++);
+            continue;
+        }
+        if ((top.array) && (top.index < top.array->size())) {
+            value = top.array->getElement(top.index++);
+            continue;
+        }
+        if (!((top.object) ? handler.endObject() : handler.endArray())) return false;
+        stack.pop_back();
+    }
+}
+
+//*******************************************************************
+// ConfigModel()
+//
+// constructor - create an empty model.
+ConfigModel::ConfigModel() {
+}
+
+//*******************************************************************
+// clear()
+//
+// empty the model and release the text of its fields.
+//
+// parameters:
+//    none
+// returns:
+//    void
+void ConfigModel::clear() {
+    capabilities = ConfigCapabilities();
+    fruRecords.clear();
+    logicalEntities.clear();
+    oemStateSets.clear();
+    arena.reset();
+}
+
+//*******************************************************************
+// parse()
+//
+// fill the model from the text of a config file.  No json structure
+// is built - the fields are read straight into the model as the text
+// is parsed.
+//
+// parameters:
+//    text - the text of the config
+// returns:
+//    true if the config was read, otherwise false (the model is then
+//    left empty)
+bool ConfigModel::parse(string_view text) {
+    clear();
+    ConfigLoader loader(this);
+    JsonFactory jf;
+    if (!jf.parse(text, loader)) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+//*******************************************************************
+// load()
+//
+// fill the model from a json structure, such as a config that has
+// been patched.  The structure is not needed once it has been loaded.
+//
+// parameters:
+//    config - the config structure
+// returns:
+//    true if the config was read, otherwise false (the model is then
+//    left empty)
+bool ConfigModel::load(JsonAbstractValue* config) {
+    clear();
+    ConfigLoader loader(this);
+    if ((!config) || (!replay(config, loader))) {
+        clear();
+        return false;
+    }
+    return true;
+}
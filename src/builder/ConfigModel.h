@@ -0,0 +1,183 @@
+//*******************************************************************
+//    ConfigModel.h
+//
+//    This file contains declarations for a typed model of the builder
+//    config file.  The config is read straight into these structures
+//    from the events of the JsonFactory parser, so no json structure is
+//    built for it.  Each field is held with the same text and numeric
+//    interpretations that the JsonValue getters return, and each list
+//    is held in a contiguous vector.
+//
+//    More information on the PICMG IoT data model can be found within
+//    the PICMG family of IoT specifications.  For more information,
+//    please visit the PICMG web site (www.picmg.org)
+//
+//    Copyright (C) 2021,  PICMG
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+#include <string_view>
+#include <vector>
+#include "JsonAbstractValue.h"
+#include "JsonArena.h"
+
+using namespace std;
+
+// a single field of the config.  A field that is missing has empty
+// text and zero values, and a field that holds an object or array is
+// present with empty text - as they are returned by JsonObject.
+struct ConfigValue {
+    bool        present = false;  // true if the field is in the config
+    string_view text;             // the text of the value ("NULL" for null)
+    long        integer = 0;      // integer interpretation of the value
+    double      real = 0.0;       // floating-point interpretation of the value
+    bool        boolean = false;  // boolean interpretation of the value
+
+    // true if the field is in the config and is not null
+    bool isSet() const { return (present) && (text != "NULL"); }
+};
+
+// a curve of data points.  The points are held as columns so that
+// they can be given to a spline without being copied.
+struct ConfigCurve {
+    vector<double> in;
+    vector<double> out;
+};
+
+// the sensor or effecter of an io binding
+struct ConfigTransducer {
+    ConfigCurve responseCurve;
+    ConfigValue nominalValue;
+    ConfigValue ratedMax;
+};
+
+struct ConfigBinding {
+    ConfigValue name;
+    ConfigValue bindingType;
+    ConfigValue boundChannel;
+    ConfigValue isVirtual;
+    ConfigValue includeInPdr;
+    ConfigValue sensorID;
+    ConfigValue effecterID;
+    ConfigValue stateSet;
+    ConfigValue stateSetVendor;
+    ConfigValue usedStates;
+    ConfigValue stateWhenHigh;
+    ConfigValue stateWhenLow;
+    ConfigValue defaultState;
+    ConfigValue defaultValue;
+    ConfigValue normalMin;
+    ConfigValue normalMax;
+    ConfigValue upperThresholdWarning;
+    ConfigValue upperThresholdCritical;
+    ConfigValue upperThresholdFatal;
+    ConfigValue lowerThresholdWarning;
+    ConfigValue lowerThresholdCritical;
+    ConfigValue lowerThresholdFatal;
+    ConfigValue physicalBaseUnit;
+    ConfigValue physicalUnitModifier;
+    ConfigValue physicalRateUnit;
+    ConfigValue physicalAuxUnit;
+    ConfigValue physicalAuxUnitModifier;
+    ConfigValue physicalAuxRateUnit;
+    ConfigValue rel;
+    ConfigValue inputGearingRatio;
+    ConfigValue outputGearingRatio;
+    ConfigCurve inputCurve;
+    ConfigCurve outputCurve;
+    ConfigTransducer sensor;
+    ConfigTransducer effecter;
+};
+
+struct ConfigParameter {
+    ConfigValue name;
+    ConfigValue type;
+    ConfigValue value;
+};
+
+struct ConfigEntity {
+    ConfigValue name;
+    ConfigValue entityVendorIANA;
+    ConfigValue vendorEntityID;
+    vector<ConfigBinding>   ioBindings;
+    vector<ConfigParameter> parameters;
+};
+
+struct ConfigChannel {
+    ConfigValue name;
+    ConfigValue type;
+    ConfigValue accuracy;
+    ConfigValue precision;
+    ConfigValue minValue;
+    ConfigValue maxValue;
+    ConfigValue minValueAtPin;
+    ConfigValue maxValueAtPin;
+};
+
+struct ConfigCapabilities {
+    ConfigValue device;
+    vector<ConfigChannel> channels;
+};
+
+struct ConfigFruField {
+    ConfigValue  type;
+    ConfigValue  format;
+    ConfigValue  value;
+    vector<long> bytes;   // the value, if it is given as an array of bytes
+};
+
+struct ConfigFruRecord {
+    ConfigValue vendorIANA;
+    vector<ConfigFruField> fields;
+};
+
+struct ConfigStateValueRecord {
+    ConfigValue minStateValue;
+    ConfigValue maxStateValue;
+    vector<string_view> languageTags;
+    vector<string_view> stateName;    // the name for each language tag
+};
+
+struct ConfigStateSet {
+    ConfigValue stateSetID;
+    ConfigValue vendorIANA;
+    vector<ConfigStateValueRecord> oemStateValueRecords;
+};
+
+class ConfigModel {
+    private:
+        JsonArena arena;   // holds the text of the fields
+
+        // the model cannot be copied
+        ConfigModel(const ConfigModel&);
+        ConfigModel& operator=(const ConfigModel&);
+
+        friend class ConfigLoader;
+    public:
+        ConfigCapabilities             capabilities;
+        vector<ConfigFruRecord>        fruRecords;       // configuration.fruRecords
+        vector<ConfigEntity>           logicalEntities;  // configuration.logicalEntities
+        vector<ConfigStateSet>         oemStateSets;
+
+        ConfigModel();
+
+        // fill the model from the text of a config file, or from a json
+        // structure that has already been built.  The layout of the
+        // config is checked as it is read and the first problem found is
+        // reported, identified by a JSON Pointer to the rejected value.
+        bool parse(string_view text);
+        bool load(JsonAbstractValue* config);
+        void clear();
+};
@@ -30,10 +30,14 @@
 //    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 #include <algorithm>    // std:max
+#include <filesystem>   // std::filesystem::create_directories
 #include "builder.h"
 #include "JsonFactory.h"
 #include "JsonObject.h"
 #include "JsonArray.h"
+#include "JsonPatch.h"
+#include "JsonSnapshot.h"
+#include "JsonText.h"
 #include "CSpline.hpp"
 #include "pldm.h"
 
@@ -43,45 +47,56 @@ using namespace std;
 #define BASE_RESOLUTION    (1.0/65536.0)
 #define OFFSET_VALUE 0.0
 
+//*******************************************************************
+// buildJsonFile()
+//
+// build the json structure for a Json File that has been mapped into
+// memory.  The structure is built in-place within the arena, referring
+// directly to the mapped file contents.  The whole file is parsed, so
+// a syntax error anywhere within it fails the build - the structure is
+// patched and then read in full into the config model, so nothing
+// would be saved by parsing parts of it on first use.  If the file
+// holds a snapshot saved by JsonSnapshot, the structure is restored
+// from it without parsing.
+//
+// parameters:
+//    jsonfile - the mapped file.  It must outlive the returned structure.
+//    arena - the arena that will hold the json structure
+// returns:
+//    a pointer to json structure that was built, otherwise NULL
+static JsonAbstractValue* buildJsonFile(JsonMappedFile &jsonfile, JsonArena &arena) {
+    JsonFactory jf;
+
+    // restore the json objects from a snapshot
+    if (JsonSnapshot::isSnapshot(jsonfile.view())) {
+        JsonSnapshot snapshot;
+        return snapshot.load(jsonfile.view(), arena);
+    }
+
+    // construct the json objects from the file structure
+    return jf.buildView(jsonfile.view(), arena);
+}
+
 //*******************************************************************
 // loadJsonFile()
 //
 // Given the filename of a Json File, load the dictionary from the 
-// file.
+// file.  The file is mapped into memory and the json structure is
+// built from it by buildJsonFile().
 //
 // parameters:
 //    filename - the name of the json file to load
+//    jsonfile - the mapped file object that will hold the file
+//       contents.  It must outlive the returned structure.
+//    arena - the arena that will hold the json structure
 // returns:
 //    a pointer to json structure that was loaded, otherwise NULL
-static JsonAbstractValue* loadJsonFile(string filename) {
-    JsonFactory jf;
-
-    ifstream jsonfile(filename, std::ifstream::binary);
-    if (!jsonfile.is_open()) {
+static JsonAbstractValue* loadJsonFile(string filename, JsonMappedFile &jsonfile, JsonArena &arena) {
+    if (!jsonfile.open(filename)) {
         cerr << "error opening file" << endl;
         return NULL;
     }
-
-    // get the length of the file 
-    jsonfile.seekg(0, jsonfile.end);
-    streamoff length = jsonfile.tellg();
-    jsonfile.seekg(0, jsonfile.beg);
-
-    // create a buffer that is large enough to hold the file
-    char* buffer = new char[(unsigned int)length + 1];
-
-    // read the file into the buffer
-    jsonfile.read(buffer, length);
-
-    // add the terminating null character
-    buffer[length] = 0;
-
-    // construct the json objects from the file structure
-    JsonAbstractValue* json = jf.build(buffer);
-
-    delete[] buffer;
-    
-    return json;
+    return buildJsonFile(jsonfile, arena);
 }
 
 //*******************************************************************
@@ -90,7 +105,6 @@ static JsonAbstractValue* loadJsonFile(string filename) {
 // Constructor - create an object instance and initialize all the 
 // variables.
 Builder::Builder() : 
-    pdrjson(0), 
     pdrByteCount(0), 
     bytesOnLine(0), 
     pdrRecordCount(0), 
@@ -113,7 +127,6 @@ Builder::~Builder()
 {
     if (cOutputFile.is_open()) cOutputFile.close();
     if (hOutputFile.is_open()) cOutputFile.close();
-    if (pdrjson) delete pdrjson;
 }
 
 //*******************************************************************
@@ -265,11 +278,11 @@ void Builder::emitStructReal64(double real, bool isFru)
 // This function also counts the total bytes that have been emitted to 
 // the pdr data and takes care of line breaks and commas between bytes.
 //
-void Builder::emitStructStrAscii(string str, bool isFru)
+void Builder::emitStructStrAscii(string_view str, bool isFru)
 {
     // emit each character in the string
     for (int i=0;i<str.size();i++) {
-        emitStructUint8(str.c_str()[i], isFru);
+        emitStructUint8(str[i], isFru);
     }
     // emit the null terminator for PDRs, but not FRU
     if (!isFru) emitStructUint8(0x00, isFru);
@@ -278,23 +291,24 @@ void Builder::emitStructStrAscii(string str, bool isFru)
 //*******************************************************************
 // emitStructStrUtf16be()
 //
-// emit a c++ string as a UTF-16BE null-terminated string to the pdr 
-// section of config.c. This function also counts the total bytes that 
+// emit the text of a json string as a UTF-16BE null-terminated string 
+// to the pdr section of config.c.  Escape sequences within the text are
+// decoded first.  This function also counts the total bytes that 
 // have been emitted to the pdr data and takes care of line breaks 
 // and commas between bytes.
-void Builder::emitStructStrUtf16be(string str, bool isFru)
+void Builder::emitStructStrUtf16be(string_view str, bool isFru)
 {
-    // convert ascii input string to utf16 big endian format
-    for (int chnm = 0; chnm < str.size(); chnm++) {
-        unsigned char ch = str.c_str()[chnm];
-        if (ch < 0x80) { 
-            emitStructUint8(0, isFru);
-            emitStructUint8(ch, isFru);
-        } 
-        else {
-            emitStructUint8(0xC0 + (ch>>6), isFru);
-            emitStructUint8(0x80 + (ch & 0x3F), isFru);
-        }
+    // convert the UTF-8 input string to utf16 big endian format
+    string decoded;
+    string utf16;
+    if (JsonText::decode(str, decoded)) {
+        str = decoded;
+    } else {
+        cerr << "Warning: invalid escape or UTF-8 sequence in string \"" << str << "\"" << endl;
+    }
+    JsonText::utf8ToUtf16be(str, utf16);
+    for (unsigned long i = 0; i < utf16.size(); i++) {
+        emitStructUint8((unsigned char)utf16[i], isFru);
     }
     // null terminator
     if (!isFru) {
@@ -413,19 +427,18 @@ void Builder::emitFruRecordSetPdr(int identifier)
 void Builder::emitFruRecords()
 {    
     // get the fru record list from the config file
-    JsonObject* cfgObj = (JsonObject*)(((JsonObject*)pdrjson)->find("configuration"));
-    JsonArray* fruRecords = (JsonArray*)(cfgObj->find("fruRecords"));
+    vector<ConfigFruRecord> &fruRecords = config.fruRecords;
 
     // return if there are no records to emit;
-    if (fruRecords->size()==0) return;
+    if (fruRecords.size()==0) return;
 
     // loop for each record in the set (all records will be associated 
     // with the same fru record set
     cOutputFile<<"FRU_BYTE_TYPE __fru_data[] FRU_DATA_ATTRIBUTES = {"<<endl; 
     bytesOnLine = 0;
-    for (int i = 0; i<fruRecords->size(); i++) {
+    for (unsigned long i = 0; i<fruRecords.size(); i++) {
         // get the record structure
-        JsonObject * record = (JsonObject*)fruRecords->getElement(i);
+        ConfigFruRecord * record = &fruRecords[i];
 
         // increment the number of records in the set
         fruRecordCount++;
@@ -442,7 +455,7 @@ void Builder::emitFruRecords()
         emitStructUint16(1, true);   
         
         // emit the fru record type
-        if (record->getInteger("vendorIANA")==412) {
+        if (record->vendorIANA.integer==412) {
             // if the vendor IANA is 412 (DMTF), this is a general FRU record
             emitStructUint8(0x01, true);  
         } else {
@@ -451,40 +464,39 @@ void Builder::emitFruRecords()
         }
 
         // emit the number of fru fields
-        JsonArray *fields = (JsonArray*)record->find("fields");
-        emitStructUint8(fields->size(),true);
+        vector<ConfigFruField> &fields = record->fields;
+        emitStructUint8(fields.size(),true);
 
         // encoding = utf8
         emitStructUint8(0x02, true);
 
         // emit each field according to its type
-        for (int j=0; j<fields->size(); j++) {
-            JsonObject* field = (JsonObject*)fields->getElement(j);
-            int type = field->getInteger("type");
+        for (unsigned long j=0; j<fields.size(); j++) {
+            ConfigFruField* field = &fields[j];
+            int type = field->type.integer;
             emitStructUint8(type,true);
-            if ((field->getValue("format")=="bytes")||(field->getValue("format")=="timestamp104")) {
+            if ((field->format.text=="bytes")||(field->format.text=="timestamp104")) {
                 // this format is an array of bytes
-                JsonArray *bytes = (JsonArray*)field->find("value");
+                vector<long> &bytes = field->bytes;
                 // emit the length of the record
-                emitStructUint8(bytes->size(),true);  
+                emitStructUint8(bytes.size(),true);  
 
                 // emit the bytes
-                for (int byteIndex = 0; byteIndex<bytes->size(); byteIndex++) {
-                    JsonObject * byte = (JsonObject*)bytes->getElement(byteIndex);
-                    emitStructUint8(byte->getInteger(""),true);
+                for (unsigned long byteIndex = 0; byteIndex<bytes.size(); byteIndex++) {
+                    emitStructUint8(bytes[byteIndex],true);
                 }                       
-            } else if ((record->getInteger("vendorIANA")==412)&&(field->getInteger("type")==15)) {
+            } else if ((record->vendorIANA.integer==412)&&(field->type.integer==15)) {
                 // general record, IANA
                 emitStructUint8(4,true);  
-                emitStructUint32(field->getInteger("value"),true);
-            } else if ((record->getInteger("vendorIANA")!=412)&&(field->getInteger("type")==1)) {
+                emitStructUint32(field->value.integer,true);
+            } else if ((record->vendorIANA.integer!=412)&&(field->type.integer==1)) {
                 // oem record, IANA
                 emitStructUint8(4,true);  
-                emitStructUint32(field->getInteger("value"),true);
+                emitStructUint32(field->value.integer,true);
             } else {
                 // all remaining record types treated as strings
-                emitStructUint8(field->getValue("value").size(),true);
-                emitStructStrAscii(field->getValue("value"),true);
+                emitStructUint8(field->value.text.size(),true);
+                emitStructStrAscii(field->value.text,true);
             }
         }
         // calculate the record size and update the largest record size if needed
@@ -513,8 +525,7 @@ void Builder::emitEntityAssociationPdr()
     pdrRecordCount++;
     
     // get the list of entities from the config file
-    JsonObject* cfgObj = (JsonObject*)(((JsonObject*)pdrjson)->find("configuration"));
-    JsonArray* entities = (JsonArray*)(cfgObj->find("logicalEntities"));
+    vector<ConfigEntity> &entities = config.logicalEntities;
 
     // emit the PDR data that never changes regardless of the device
     // architecture
@@ -522,7 +533,7 @@ void Builder::emitEntityAssociationPdr()
     emitStructUint8(0x01);             // Pdr header version
     emitStructUint8(PDR_TYPE_ENTITY_ASSOCIATION);
     emitStructUint16(0x0001);          // Record Change Number
-    emitPdrSize(10+6*entities->size());  // data length
+    emitPdrSize(10+6*entities.size());  // data length
     emitStructUint16(0x0001);          // container ID
     emitStructUint8(0x01);             // associationType - logicalContainment
     emitStructUint16(80);              // container type - IO Module
@@ -547,11 +558,9 @@ void Builder::emitOemEntityIdPdr()
     pdrRecordCount++;
     
     // get the list of entities from the config file
-    JsonObject* cfgObj = (JsonObject*)(((JsonObject*)pdrjson)->find("configuration"));
-    JsonArray* entities = (JsonArray*)(cfgObj->find("logicalEntities"));
-    JsonObject * entity = (JsonObject*)(entities->getElement(0));
+    ConfigEntity * entity = &config.logicalEntities[0];
     string entityname = "unknown";
-    switch (entity->getInteger("vendorEntityID")) {
+    switch (entity->vendorEntityID.integer) {
         case 1: // simple
             entityname = "Simple";
             break;
@@ -573,7 +582,7 @@ void Builder::emitOemEntityIdPdr()
     emitStructUint16(0x0001);          // terminus handle
     emitStructUint16(0x6000);          // oem entity id handle
     emitStructUint32(12634);           // PICMG vendor IANA
-    emitStructUint16(entity->getInteger("vendorEntityID"));
+    emitStructUint16(entity->vendorEntityID.integer);
     emitStructUint8(0x01);             // contained string count    
     emitStructStrAscii("en");          // language = english
     emitStructStrUtf16be(entityname);  // entity name
@@ -587,20 +596,20 @@ void Builder::emitOemEntityIdPdr()
 void Builder::emitOemStateSetPdrs()
 {
     // get the list of state sets from the config file
-    JsonArray* sets = (JsonArray*)(((JsonObject*)pdrjson)->find("oemStateSets"));
+    vector<ConfigStateSet> &sets = config.oemStateSets;
 
     // loop for each oem state set in the configuration, building the map as we go.
     // stateSetHandleMap maps the oemIANA/enity ID to the entity handle for the OEM
     // state set PDR.  
     map<unsigned long, unsigned int> typeCounts; 
-    for (int i=0;i<sets->size();i++) {        
+    for (unsigned long i=0;i<sets.size();i++) {        
         // get the specific entity of interest
-        JsonObject *set = (JsonObject*)(sets->getElement(i));
+        ConfigStateSet *set = &sets[i];
         
         // get the values for the fields for vendor entity ID and 
         // entity vendor IANA
-        unsigned long vendorStateSetId = set->getInteger("stateSetID");
-        unsigned long vendorIana = set->getInteger("vendorIANA");
+        unsigned long vendorStateSetId = set->stateSetID.integer;
+        unsigned long vendorIana = set->vendorIANA.integer;
         uint64_t key = (((uint64_t)vendorIana)<<16) + vendorStateSetId;
         unsigned int nextHandle = 0x8003;
         
@@ -625,21 +634,21 @@ void Builder::emitOemStateSetPdrs()
 
         // calculate and output the size
         unsigned int pdrsize = 12;
-        JsonArray *oemStateValueRecords = ((JsonArray*)(set->find("oemStateValueRecords")));
-        for (unsigned int recnum = 0; recnum<oemStateValueRecords->size();recnum++) {
+        vector<ConfigStateValueRecord> &oemStateValueRecords = set->oemStateValueRecords;
+        for (unsigned int recnum = 0; recnum<oemStateValueRecords.size();recnum++) {
             // get the specific record
-            JsonObject *record = (JsonObject *)(oemStateValueRecords->getElement(recnum));
+            ConfigStateValueRecord *record = &oemStateValueRecords[recnum];
 
             // get the language tag and state name arrays
-            JsonArray* languageTags = (JsonArray *)record->find("languageTags");
-            JsonArray* stateName    = (JsonArray *)record->find("stateName");
+            vector<string_view> &languageTags = record->languageTags;
+            vector<string_view> &stateName    = record->stateName;
 
             // add 3 btyes for each state value record plus size of the strings
             // including terminators.
             pdrsize += 3;
-            for (unsigned int strnum = 0; strnum<languageTags->size(); strnum++) {
-                pdrsize += languageTags->getElement(strnum)->getValue("").size() + 1;
-                pdrsize += stateName->getElement(strnum)->getValue("").size()*2 + 2;
+            for (unsigned int strnum = 0; strnum<languageTags.size(); strnum++) {
+                pdrsize += languageTags[strnum].size() + 1;
+                pdrsize += stateName[strnum].size()*2 + 2;
             }
         }
 
@@ -661,25 +670,25 @@ void Builder::emitOemStateSetPdrs()
         emitStructUint32(vendorIana);          // vendorIana for this state set
         emitStructUint16(vendorStateSetId);    // Oem State set ID
         emitStructUint8(0x01);                 // unspecified value hint (treat as error)
-        emitStructUint8(oemStateValueRecords->size());  // the number of state value records
+        emitStructUint8(oemStateValueRecords.size());  // the number of state value records
         
         // emit the information for each state record
-        for (unsigned int recnum = 0; recnum<oemStateValueRecords->size();recnum++) {
+        for (unsigned int recnum = 0; recnum<oemStateValueRecords.size();recnum++) {
             // get the specific record
-            JsonObject *record = (JsonObject *)(oemStateValueRecords->getElement(recnum));
+            ConfigStateValueRecord *record = &oemStateValueRecords[recnum];
 
             // get the language tag and state name arrays
-            JsonArray* languageTags = (JsonArray *)record->find("languageTags");
-            JsonArray* stateName    = (JsonArray *)record->find("stateName");
+            vector<string_view> &languageTags = record->languageTags;
+            vector<string_view> &stateName    = record->stateName;
 
-            emitStructUint8(record->getInteger("minStateValue")); // min state value for this state
-            emitStructUint8(record->getInteger("maxStateValue")); // max state value for this state
-            emitStructUint8(languageTags->size());                // String count
+            emitStructUint8(record->minStateValue.integer); // min state value for this state
+            emitStructUint8(record->maxStateValue.integer); // max state value for this state
+            emitStructUint8(languageTags.size());           // String count
             
             // emit information for each string
-            for (unsigned int strnum = 0; strnum<languageTags->size(); strnum++) {
-                emitStructStrAscii(languageTags->getElement(strnum)->getValue(""));
-                emitStructStrUtf16be(stateName->getElement(strnum)->getValue(""));
+            for (unsigned int strnum = 0; strnum<languageTags.size(); strnum++) {
+                emitStructStrAscii(languageTags[strnum]);
+                emitStructStrUtf16be(stateName[strnum]);
             }
 
         }
@@ -692,10 +701,10 @@ void Builder::emitOemStateSetPdrs()
 //
 // emit a single state sensor PDR to config.c.  
 //
-bool Builder::emitStateSensorPdr(JsonObject *binding, JsonObject *entity)
+bool Builder::emitStateSensorPdr(ConfigBinding *binding, ConfigEntity *entity)
 {
     emitStructNewline();
-    cOutputFile<<"   // State Sensor "<<(binding->getValue("name"));
+    cOutputFile<<"   // State Sensor "<<(binding->name.text);
     bytesOnLine = 0;
     pdrRecordCount++;
 
@@ -708,7 +717,7 @@ bool Builder::emitStateSensorPdr(JsonObject *binding, JsonObject *entity)
 
     // emit the sensor information
     emitStructUint16(0x0001);              // Terminus handle
-    emitStructUint16(binding->getInteger("sensorID")); // sensor ID for this sensor
+    emitStructUint16(binding->sensorID.integer); // sensor ID for this sensor
     emitStructUint16(0x6000);              // Entity Type
     emitStructUint16(0x0001);              // Entity Instance
     emitStructUint16(0x0001);              // Container ID
@@ -716,17 +725,17 @@ bool Builder::emitStateSensorPdr(JsonObject *binding, JsonObject *entity)
     emitStructUint8(0x00);                 // Auxilary Names Pdr
     emitStructUint8(0x01);                 // Sensor Count
 
-    unsigned long vendorIANA = binding->getInteger("stateSetVendor");
+    unsigned long vendorIANA = binding->stateSetVendor.integer;
     if (vendorIANA==412) {
         // DMTF - A standard state set
-        emitStructUint16(binding->getInteger("stateSet"));  // State Set ID
+        emitStructUint16(binding->stateSet.integer);  // State Set ID
     } else {
         // loop up the state set handle and give it as the ID
-        uint64_t key = (((uint64_t)vendorIANA)<<16) + binding->getInteger("stateSet");
+        uint64_t key = (((uint64_t)vendorIANA)<<16) + binding->stateSet.integer;
         emitStructUint16(oemStateSetMap[key]);  // State Set ID
     }
     emitStructUint8(0x01); // Possible state size
-    emitStructUint8(binding->getInteger("usedStates"));
+    emitStructUint8(binding->usedStates.integer);
     return true;
 }
 
@@ -783,16 +792,16 @@ static double scaleResolutionByRateUnit(double res_in, unsigned int rateUnit, do
 // parameters:
 //    binding - the IOBinding object to evaluate
 // returns: the value of the field support bitfield
-unsigned char Builder::getFieldSupport(JsonObject * binding)
+unsigned char Builder::getFieldSupport(ConfigBinding * binding)
 {
     unsigned char fieldSupport = 0;
 
-    if ((binding->find("lowerThresholdFatal")!=NULL)&&(binding->find("lowerThresholdFatal")->getValue("")!="NULL")) fieldSupport |= 0x40;
-    if ((binding->find("upperThresholdFatal")!=NULL)&&(binding->find("upperThresholdFatal")->getValue("")!="NULL")) fieldSupport |= 0x20;
-    if ((binding->find("lowerThresholdCritical")!=NULL)&&(binding->find("lowerThresholdCritical")->getValue("")!="NULL")) fieldSupport |= 0x10;
-    if ((binding->find("upperThresholdCritical")!=NULL)&&(binding->find("upperThresholdCritical")->getValue("")!="NULL")) fieldSupport |= 0x08;
-    if ((binding->find("normalMin")!=NULL)&&(binding->find("normalMin")->getValue("")!="NULL")) fieldSupport |= 0x04;
-    if ((binding->find("normalMax")!=NULL)&&(binding->find("normalMax")->getValue("")!="NULL")) fieldSupport |= 0x02;
+    if (binding->lowerThresholdFatal.isSet()) fieldSupport |= 0x40;
+    if (binding->upperThresholdFatal.isSet()) fieldSupport |= 0x20;
+    if (binding->lowerThresholdCritical.isSet()) fieldSupport |= 0x10;
+    if (binding->upperThresholdCritical.isSet()) fieldSupport |= 0x08;
+    if (binding->normalMin.isSet()) fieldSupport |= 0x04;
+    if (binding->normalMax.isSet()) fieldSupport |= 0x02;
 
     return fieldSupport;
 }
@@ -803,14 +812,13 @@ unsigned char Builder::getFieldSupport(JsonObject * binding)
 // emit the sensor threshold to the pdr structure.
 //
 // parameters:
-//    binding - the IOBinding object to evaluate
-//    thresholdName - the name of the threshold to output
+//    threshold - the threshold field of the IOBinding object to output
 // returns: nothing
-void Builder::emitThresholdToPdr(JsonObject * binding, string thresholdName)
+void Builder::emitThresholdToPdr(ConfigValue * threshold)
 {
 
-    if (binding->find(thresholdName)!=NULL) {
-        emitStructSint32(binding->find(thresholdName)->getInteger(""));
+    if (threshold->present) {
+        emitStructSint32(threshold->integer);
     } else {
         emitStructSint32(0);
     }
@@ -821,20 +829,20 @@ void Builder::emitThresholdToPdr(JsonObject * binding, string thresholdName)
 //
 // emit a single numeric sensor PDR to config.c.  
 //
-bool Builder::emitNumericSensorPdr(JsonObject *binding, JsonObject *entity)
+bool Builder::emitNumericSensorPdr(ConfigBinding *binding, ConfigEntity *entity)
 {
     emitStructNewline();
-    cOutputFile<<"   // Numeric Sensor "<<(binding->getValue("name"));
+    cOutputFile<<"   // Numeric Sensor "<<(binding->name.text);
     bytesOnLine = 0;
     pdrRecordCount++;
 
     // get any required parameter values
-    JsonArray * parameters = (JsonArray*)(entity->find("parameters"));
+    vector<ConfigParameter> &parameters = entity->parameters;
     double sampleRate = 0;
-    for (int i=0;i<parameters->size();i++) {
-        JsonObject * param = (JsonObject*)(parameters->getElement(i));
-        if (param->getValue("name").compare("SampleRate")==0) {
-            sampleRate = param->getDouble("value");
+    for (unsigned long i=0;i<parameters.size();i++) {
+        ConfigParameter * param = &parameters[i];
+        if (param->name.text.compare("SampleRate")==0) {
+            sampleRate = param->value.real;
             break;
         }
     }
@@ -848,20 +856,20 @@ bool Builder::emitNumericSensorPdr(JsonObject *binding, JsonObject *entity)
 
     // emit the sensor information
     emitStructUint16(0x0001);              // Terminus handle
-    emitStructUint16(binding->getInteger("sensorID")); // Senspr ID for this sensor
+    emitStructUint16(binding->sensorID.integer); // Senspr ID for this sensor
     emitStructUint16(0x6000);              // Entity type
     emitStructUint16(0x0001);              // Entity Instance
     emitStructUint16(0x0001);              // Container ID
     emitStructUint8(0x00);                 // Sensor Init
     emitStructUint8(0x00);                 // Sensor Auxilary Names PDR
-    emitStructUint8(binding->getInteger("physicalBaseUnit"));         // base unit
-    emitStructSint8(binding->getInteger("physicalUnitModifier"));      // unitModifier
-    emitStructUint8(binding->getInteger("physicalRateUnit"));         // rateUnit
+    emitStructUint8(binding->physicalBaseUnit.integer);         // base unit
+    emitStructSint8(binding->physicalUnitModifier.integer);      // unitModifier
+    emitStructUint8(binding->physicalRateUnit.integer);         // rateUnit
     emitStructUint8(0);                                               // base unit OEM Handle
-    emitStructUint8(binding->getInteger("physicalAuxUnit"));          // aux unit
-    emitStructSint8(binding->getInteger("physicalAuxUnitModifier"));  // aux unit modifier
-    emitStructUint8(binding->getInteger("physicalAuxRateUnit"));      // aux rate unit
-    if(binding->getValue("rel").compare("DivideBy")==0) {
+    emitStructUint8(binding->physicalAuxUnit.integer);          // aux unit
+    emitStructSint8(binding->physicalAuxUnitModifier.integer);  // aux unit modifier
+    emitStructUint8(binding->physicalAuxRateUnit.integer);      // aux rate unit
+    if(binding->rel.text.compare("DivideBy")==0) {
         emitStructUint8(0);      // rel - divide by
     } else {
         emitStructUint8(1);      // rel - multiply by
@@ -875,7 +883,7 @@ bool Builder::emitNumericSensorPdr(JsonObject *binding, JsonObject *entity)
     // period
     double resolution = BASE_RESOLUTION;
     if (positionResolution) {
-        switch(binding->getInteger("sensorID")) {
+        switch(binding->sensorID.integer) {
             case 4:  // verr
             case 5:  // perr
             case 6:  // velocity
@@ -885,39 +893,38 @@ bool Builder::emitNumericSensorPdr(JsonObject *binding, JsonObject *entity)
                 resolution = positionResolution;
         }
     }
-    if (binding->getInteger("physicalBaseUnit") == 20) {
+    if (binding->physicalBaseUnit.integer == 20) {
         // base units are hertz
         resolution *= sampleRate;
     }
-    resolution = scaleResolutionByRateUnit(resolution, binding->getInteger("physicalRateUnit"), sampleRate);
-    resolution = scaleResolutionByRateUnit(resolution, binding->getInteger("physicalAuxRateUnit"), sampleRate);
+    resolution = scaleResolutionByRateUnit(resolution, binding->physicalRateUnit.integer, sampleRate);
+    resolution = scaleResolutionByRateUnit(resolution, binding->physicalAuxRateUnit.integer, sampleRate);
     emitStructReal32(resolution);    // resolution
     emitStructReal32(OFFSET_VALUE);        // offset
 
     // if the effecter is not virtual - construct in/out curves to calculate the
     // accuracy and tolerance
-    if (!binding->getBoolean("isVirtual")) 
+    if (!binding->isVirtual.boolean) 
     {
         // find the channel in the channel list
-        JsonObject *cap = (JsonObject*)(((JsonObject*)pdrjson)->find("capabilities"));
-        JsonArray *channels = (JsonArray*)(cap->find("channels"));
-        JsonObject* channel = NULL;
-        for (int i = 0;i<channels->size();i++) {
-            channel = (JsonObject *)channels->getElement(i);
-            if (channel->getValue("name")==binding->getValue("boundChannel")==0) break;
+        vector<ConfigChannel> &channels = config.capabilities.channels;
+        ConfigChannel* channel = NULL;
+        for (unsigned long i = 0;i<channels.size();i++) {
+            channel = &channels[i];
+            if ((channel->name.text==binding->boundChannel.text)==0) break;
         }
         if (!channel) {
-            cerr<<"Channel not found for IO Binding "<<binding->getValue("name")<<endl;
+            cerr<<"Channel not found for IO Binding "<<binding->name.text<<endl;
             return false;
         }
 
         // accuracy - this part of the error scales linearly with the reading
-        emitStructUint16(channel->getDouble("accuracy")*100);  
+        emitStructUint16(channel->accuracy.real*100);  
 
         // get the output curve for the output stage
-        JsonArray *inputCurve = ((JsonArray*)binding->find("inputCurve"));
-        JsonObject *sensor = ((JsonObject*)binding->find("sensor"));
-        JsonArray *responseCurve = ((JsonArray*)sensor->find("responseCurve"));
+        ConfigCurve *inputCurve = &binding->inputCurve;
+        ConfigTransducer *sensor = &binding->sensor;
+        ConfigCurve *responseCurve = &sensor->responseCurve;
 
         // create the interpolation curves
         CUCSpline inputSpline(true);
@@ -926,7 +933,7 @@ bool Builder::emitNumericSensorPdr(JsonObject *binding, JsonObject *entity)
         configureSplineFromPoints(responseCurve, &responseSpline,true);
 
         // get the gearing ratio
-        double gearing = binding->getDouble("inputGearingRatio");
+        double gearing = binding->inputGearingRatio.real;
         if (gearing == 0) gearing = 1.0;
 
         // calculate and emit the tolerance based on channel specifics
@@ -948,12 +955,9 @@ bool Builder::emitNumericSensorPdr(JsonObject *binding, JsonObject *entity)
             emitStructReal32(0.0);  // Update Interval
         }
         
-        // get the max and min raw values from the selected channel
-        string channelName = binding->getValue("boundChannel");
-
         // matching channel has been found output channel-specific values
-        double max = responseSpline.interpolate(inputSpline.interpolate(channel->getDouble("maxValueAtPin")))/gearing;
-        double min = responseSpline.interpolate(inputSpline.interpolate(channel->getDouble("minValueAtPin")))/gearing;
+        double max = responseSpline.interpolate(inputSpline.interpolate(channel->maxValueAtPin.real))/gearing;
+        double min = responseSpline.interpolate(inputSpline.interpolate(channel->minValueAtPin.real))/gearing;
         if (min>max) {
             double temp = min;
             min = max;
@@ -967,14 +971,14 @@ bool Builder::emitNumericSensorPdr(JsonObject *binding, JsonObject *entity)
         unsigned char fieldSupport = getFieldSupport(binding);
         emitStructUint8(fieldSupport);       // range field support
         emitStructSint32(0);                 // Nominal Value (not used)
-        emitThresholdToPdr(binding, "normalMax"); 
-        emitThresholdToPdr(binding, "normalMin"); 
-        emitThresholdToPdr(binding, "upperThresholdWarning"); 
-        emitThresholdToPdr(binding, "lowerThresholdWarning"); 
-        emitThresholdToPdr(binding, "upperThresholdCritical"); 
-        emitThresholdToPdr(binding, "lowerThresholdCritical"); 
-        emitThresholdToPdr(binding, "upperThresholdFatal"); 
-        emitThresholdToPdr(binding, "lowerThresholdFatal"); 
+        emitThresholdToPdr(&binding->normalMax); 
+        emitThresholdToPdr(&binding->normalMin); 
+        emitThresholdToPdr(&binding->upperThresholdWarning); 
+        emitThresholdToPdr(&binding->lowerThresholdWarning); 
+        emitThresholdToPdr(&binding->upperThresholdCritical); 
+        emitThresholdToPdr(&binding->lowerThresholdCritical); 
+        emitThresholdToPdr(&binding->upperThresholdFatal); 
+        emitThresholdToPdr(&binding->lowerThresholdFatal); 
     } else {
         // Virtual numeric sensor
         // accuracy - this part of the error scales linearly with the reading
@@ -1000,14 +1004,14 @@ bool Builder::emitNumericSensorPdr(JsonObject *binding, JsonObject *entity)
         unsigned char fieldSupport = getFieldSupport(binding);
         emitStructUint8(fieldSupport);         // range field support
         emitStructSint32(0);                 // Nominal Value (not used)
-        emitThresholdToPdr(binding, "normalMax"); 
-        emitThresholdToPdr(binding, "normalMin"); 
-        emitThresholdToPdr(binding, "upperThresholdWarning"); 
-        emitThresholdToPdr(binding, "lowerThresholdWarning"); 
-        emitThresholdToPdr(binding, "upperThresholdCritical"); 
-        emitThresholdToPdr(binding, "lowerThresholdCritical"); 
-        emitThresholdToPdr(binding, "upperThresholdFatal"); 
-        emitThresholdToPdr(binding, "lowerThresholdFatal"); 
+        emitThresholdToPdr(&binding->normalMax); 
+        emitThresholdToPdr(&binding->normalMin); 
+        emitThresholdToPdr(&binding->upperThresholdWarning); 
+        emitThresholdToPdr(&binding->lowerThresholdWarning); 
+        emitThresholdToPdr(&binding->upperThresholdCritical); 
+        emitThresholdToPdr(&binding->lowerThresholdCritical); 
+        emitThresholdToPdr(&binding->upperThresholdFatal); 
+        emitThresholdToPdr(&binding->lowerThresholdFatal); 
     }
     return true;
 }
@@ -1017,10 +1021,10 @@ bool Builder::emitNumericSensorPdr(JsonObject *binding, JsonObject *entity)
 //
 // emit a single state effecter PDR to config.c.  
 //
-bool Builder::emitStateEffecterPdr(JsonObject *binding, JsonObject *entity)
+bool Builder::emitStateEffecterPdr(ConfigBinding *binding, ConfigEntity *entity)
 {
     emitStructNewline();
-    cOutputFile<<"   // State Effecter "<<(binding->getValue("name"));
+    cOutputFile<<"   // State Effecter "<<(binding->name.text);
     bytesOnLine = 0;
     pdrRecordCount++;
 
@@ -1033,7 +1037,7 @@ bool Builder::emitStateEffecterPdr(JsonObject *binding, JsonObject *entity)
 
     // emit the sensor information
     emitStructUint16(0x0001);              // Terminus handle
-    emitStructUint16(binding->getInteger("effecterID")); // effecter ID
+    emitStructUint16(binding->effecterID.integer); // effecter ID
     emitStructUint16(0x6000);              // Entity type
     emitStructUint16(0x0001);              // Entity Instance
     emitStructUint16(0x0001);              // Container ID
@@ -1042,62 +1046,43 @@ bool Builder::emitStateEffecterPdr(JsonObject *binding, JsonObject *entity)
     emitStructUint8(0x00);                 // Effecter Description PDR
     emitStructUint8(0x01);                 // Effecter Count
 
-    unsigned long vendorIANA = binding->getInteger("stateSetVendor");
+    unsigned long vendorIANA = binding->stateSetVendor.integer;
     if (vendorIANA==412) {
         // DMTF - A standard state set
-        emitStructUint16(binding->getInteger("stateSet"));  // State Set
+        emitStructUint16(binding->stateSet.integer);  // State Set
     } else {
         // loop up the state set handle and give it as the ID
-        uint64_t key = (((uint64_t)vendorIANA)<<16) + binding->getInteger("stateSet");
+        uint64_t key = (((uint64_t)vendorIANA)<<16) + binding->stateSet.integer;
         emitStructUint16(oemStateSetMap[key]);  // State Set
     }
     emitStructUint8(0x01); // Possible state size
-    emitStructUint8(binding->getInteger("usedStates"));
+    emitStructUint8(binding->usedStates.integer);
     return true;
 }
 
 //*******************************************************************
 // configureSplineFromPoints()
 //
-// Configure a spline object from an array of configuration of DataPoint
-// objects.
+// Configure a spline object from a curve of configuration DataPoint
+// objects.  The input and output values of the points are held as
+// columns by the config model, so they are given to the spline
+// without being copied.  The spline sorts the points into increasing
+// order of the independent variable.
 //
 // Parameters:
-//    points - a pointer to a JsonArray object that contains the point objects.
+//    points - a pointer to the curve that contains the points.
 //    spline - a pointer to the spline object to be configured.
 //    reverse - true if the spline independent variable are the output points.
 //        Otherwise, the spline independent variable consists of the input points.  
 //
-void Builder::configureSplineFromPoints(JsonArray* points, CUCSpline *spline, bool reverse) {
-    // allocate memory for the data points
-    CUInterpolator::SUConfigurationTableEntry *spline_points = 
-        new CUInterpolator::SUConfigurationTableEntry[points->size()]; 
-
-    // initialize the arrays - make sure the independent values are in increasing order
-    JsonObject *p1 = (JsonObject*)(points->getElement(0));
-    JsonObject *p2 = (JsonObject*)(points->getElement(1));
-    double reverse_order = false;
+void Builder::configureSplineFromPoints(ConfigCurve* points, CUCSpline *spline, bool reverse) {
+    unsigned long count = points->in.size();
     if (reverse) {
-        if (p2->getDouble("out")<p1->getDouble("out")) reverse_order = true;     
+        spline->configure(count, points->out.data(), points->in.data());
     } else {
-        if (p2->getDouble("in")<p1->getDouble("in")) reverse_order = true;     
-    }
-    for (int i = 0; i<points->size();i++) {
-        int idx = i;
-        if (reverse_order) idx = points->size()-1-i;
-        JsonObject *point = (JsonObject*)(points->getElement(idx));
-        if (reverse) {
-            spline_points[idx].fIndependentValue = point->getDouble("out"); 
-            spline_points[idx].fDependentValue = point->getDouble("in"); 
-        } else {
-            spline_points[idx].fIndependentValue = point->getDouble("in"); 
-            spline_points[idx].fDependentValue = point->getDouble("out"); 
-        }
+        spline->configure(count, points->in.data(), points->out.data());
     }
-    spline->configure(points->size(),spline_points);
     spline->configureNaturalSpline(true);
-
-    delete[] spline_points;
 }
 
 //*******************************************************************
@@ -1109,7 +1094,7 @@ void Builder::configureSplineFromPoints(JsonArray* points, CUCSpline *spline, bo
 // Parameters:
 //    plusTolerance - this value will be updated with the calculated plus tolerance
 //    minusTolerance - this value will be updated with the calculated minus tolerance.
-//    channel - a pointer to the associated channel json object
+//    channel - a pointer to the associated channel
 //    binding - a pointer to the associated binding object
 //    ioSpline - a pointer to a spline that defines the input or output curve of the 
 //        the i/o interface.  The independent variable is on the controller side of 
@@ -1121,8 +1106,8 @@ void Builder::configureSplineFromPoints(JsonArray* points, CUCSpline *spline, bo
 void Builder::calcPlusMinusTolerance(
     double *plusTolerance, 
     double *minusTolerance, 
-    JsonObject*channel, 
-    JsonObject*binding,
+    ConfigChannel*channel, 
+    ConfigBinding*binding,
     CUCSpline *ioSpline,
     CUCSpline *seSpline)
 {
@@ -1131,18 +1116,18 @@ void Builder::calcPlusMinusTolerance(
     minusTolerance = 0;
 
     // calculate tolerance for analog in, analog out, or pwm
-    if ((channel->getValue("type").compare("analog_in")==0)|| 
-       (channel->getValue("type").compare("analog_out")==0)||
-       (channel->getValue("type").compare("pwm_out")==0)) 
+    if ((channel->type.text.compare("analog_in")==0)|| 
+       (channel->type.text.compare("analog_out")==0)||
+       (channel->type.text.compare("pwm_out")==0)) 
     {
        // get the gearing ratio
-        double gearing = binding->getDouble("outputGearingRatio");
+        double gearing = binding->outputGearingRatio.real;
 
         // calculate the plus/minus tolerance at a few points to determine the
         // the worst case differences
-        int precision = channel->getDouble("precision");
-        double minValueAtPin = channel->getDouble("minValueAtPin");
-        double maxValueAtPin = channel->getDouble("maxValueAtPin");
+        int precision = channel->precision.real;
+        double minValueAtPin = channel->minValueAtPin.real;
+        double maxValueAtPin = channel->maxValueAtPin.real;
         double maxRaw,minRaw;        
         maxRaw = 1<<abs(precision);
         minRaw = 0;
@@ -1173,15 +1158,15 @@ void Builder::calcPlusMinusTolerance(
         return;
     }
     // calculate tolerance for rate_out
-    if ((channel->getValue("type").compare("rate_out")==0)) 
+    if ((channel->type.text.compare("rate_out")==0)) 
     {
        // get the gearing ratio
-        double gearing = binding->getDouble("outputGearingRatio");
+        double gearing = binding->outputGearingRatio.real;
 
         // calculate the plus/minus tolerance at a few points to determine the
         // the worst case differences
-        int precision = channel->getDouble("precision");
-        double maxValueAtPin = channel->getDouble("maxValueAtPin");
+        int precision = channel->precision.real;
+        double maxValueAtPin = channel->maxValueAtPin.real;
         double maxRaw,minRaw;        
         maxRaw = 1<<abs(precision);
         minRaw = 0;
@@ -1218,20 +1203,20 @@ void Builder::calcPlusMinusTolerance(
 //
 // emit a single numeric effecter PDR to config.c.  
 //
-bool Builder::emitNumericEffecterPdr(JsonObject *binding, JsonObject *entity)
+bool Builder::emitNumericEffecterPdr(ConfigBinding *binding, ConfigEntity *entity)
 {
     emitStructNewline();
-    cOutputFile<<"   // Numeric Effecter "<<(binding->getValue("name"));
+    cOutputFile<<"   // Numeric Effecter "<<(binding->name.text);
     bytesOnLine = 0;
     pdrRecordCount++;
 
     // get any required parameter values
-    JsonArray * parameters = (JsonArray*)(entity->find("parameters"));
+    vector<ConfigParameter> &parameters = entity->parameters;
     double sampleRate = 0;
-    for (int i=0;i<parameters->size();i++) {
-        JsonObject * param = (JsonObject*)(parameters->getElement(i));
-        if (param->getValue("name").compare("SampleRate")==0) {
-            sampleRate = param->getDouble("value");
+    for (unsigned long i=0;i<parameters.size();i++) {
+        ConfigParameter * param = &parameters[i];
+        if (param->name.text.compare("SampleRate")==0) {
+            sampleRate = param->value.real;
             break;
         }
     }
@@ -1245,27 +1230,27 @@ bool Builder::emitNumericEffecterPdr(JsonObject *binding, JsonObject *entity)
 
     // emit the sensor information
     emitStructUint16(0x0001);              // Terminus handle
-    emitStructUint16(binding->getInteger("effecterID")); // effecter ID
+    emitStructUint16(binding->effecterID.integer); // effecter ID
     emitStructUint16(0x6000);              // Entity type
     emitStructUint16(0x0001);              // Entity Instance
     emitStructUint16(0x0001);              // Container ID
     emitStructUint16(0x0000);              // Effecter Semantic ID
     emitStructUint8(0x00);                 // Effecter Init
     emitStructUint8(0x00);                 // Effecter AuxilaryNames PDR
-    emitStructUint8(binding->getInteger("physicalBaseUnit"));         // base unit
-    emitStructSint8(binding->getInteger("physicalUnitModifier"));      // unitModifier
-    emitStructUint8(binding->getInteger("physicalRateUnit"));         // rateUnit
+    emitStructUint8(binding->physicalBaseUnit.integer);         // base unit
+    emitStructSint8(binding->physicalUnitModifier.integer);      // unitModifier
+    emitStructUint8(binding->physicalRateUnit.integer);         // rateUnit
     emitStructUint8(0x00);                                            // base oem unit handle
-    emitStructUint8(binding->getInteger("physicalAuxUnit"));          // aux unit
-    emitStructSint8(binding->getInteger("physicalAuxUnitModifier"));  // aux unit modifier
-    emitStructUint8(binding->getInteger("physicalAuxRateUnit"));      // aux rate unit
+    emitStructUint8(binding->physicalAuxUnit.integer);          // aux unit
+    emitStructSint8(binding->physicalAuxUnitModifier.integer);  // aux unit modifier
+    emitStructUint8(binding->physicalAuxRateUnit.integer);      // aux rate unit
     emitStructUint8(0x00);                 // aux oemUnitHandle
     emitStructUint8(1);                    // isLinear
     emitStructUint8(5);                    // Effecter data size (sint 32)
 
     double resolution = BASE_RESOLUTION;
     if (positionResolution) {
-        switch(binding->getInteger("effecterID")) {
+        switch(binding->effecterID.integer) {
             case 4:  // pfinal effecter
                 resolution = positionResolution;
                 break;
@@ -1274,39 +1259,38 @@ bool Builder::emitNumericEffecterPdr(JsonObject *binding, JsonObject *entity)
                 resolution *= positionResolution;
         }
     }
-    if (binding->getInteger("physicalBaseUnit") == 20) {
+    if (binding->physicalBaseUnit.integer == 20) {
         // base units are hertz
         resolution *= sampleRate;
     }
-    resolution = scaleResolutionByRateUnit(resolution, binding->getInteger("physicalRateUnit"), sampleRate);
-    resolution = scaleResolutionByRateUnit(resolution, binding->getInteger("physicalAuxRateUnit"), sampleRate);
+    resolution = scaleResolutionByRateUnit(resolution, binding->physicalRateUnit.integer, sampleRate);
+    resolution = scaleResolutionByRateUnit(resolution, binding->physicalAuxRateUnit.integer, sampleRate);
     emitStructReal32(resolution);    // resolution
     emitStructReal32(OFFSET_VALUE);        // offset
 
     // if the effecter is not virtual - construct in/out curves to calculate the
     // accuracy and tolerance
-    if (!binding->getBoolean("isVirtual")) 
+    if (!binding->isVirtual.boolean) 
     {
         // find the channel in the channel list
-        JsonObject *cap = (JsonObject*)(((JsonObject*)pdrjson)->find("capabilities"));
-        JsonArray *channels = (JsonArray*)(cap->find("channels"));
-        JsonObject* channel = NULL;
-        for (int i = 0;i<channels->size();i++) {
-            channel = (JsonObject *)channels->getElement(i);
-            if (channel->getValue("name")==binding->getValue("boundChannel")==0) break;
+        vector<ConfigChannel> &channels = config.capabilities.channels;
+        ConfigChannel* channel = NULL;
+        for (unsigned long i = 0;i<channels.size();i++) {
+            channel = &channels[i];
+            if ((channel->name.text==binding->boundChannel.text)==0) break;
         }
         if (!channel) {
-            cerr<<"Channel not found for IO Binding "<<binding->getValue("name")<<endl;
+            cerr<<"Channel not found for IO Binding "<<binding->name.text<<endl;
             return false;
         }
 
         // accuracy - this part of the error scales linearly with the reading
-        emitStructUint16(channel->getDouble("accuracy")*100);  
+        emitStructUint16(channel->accuracy.real*100);  
 
         // get the output curve for the output stage
-        JsonArray *outputCurve = ((JsonArray*)binding->find("outputCurve"));
-        JsonObject *effecter = ((JsonObject*)binding->find("effecter"));
-        JsonArray *responseCurve = ((JsonArray*)effecter->find("responseCurve"));
+        ConfigCurve *outputCurve = &binding->outputCurve;
+        ConfigTransducer *effecter = &binding->effecter;
+        ConfigCurve *responseCurve = &effecter->responseCurve;
 
         // create the interpolation curves
         CUCSpline outputSpline(true);
@@ -1329,15 +1313,12 @@ bool Builder::emitNumericEffecterPdr(JsonObject *binding, JsonObject *entity)
             emitStructReal32(0.0);  // Transition Interval
         }
         
-        // get the max and min raw values from the selected channel
-        string channelName = binding->getValue("boundChannel");
-
         // get the gearing ratio
-        double gearing = binding->getDouble("outputGearingRatio");
+        double gearing = binding->outputGearingRatio.real;
 
         // matching channel has been found output channel-specific values
-        double max = gearing*responseSpline.interpolate(outputSpline.interpolate(channel->getDouble("maxValueAtPin")));
-        double min = gearing*responseSpline.interpolate(outputSpline.interpolate(channel->getDouble("minValueAtPin")));
+        double max = gearing*responseSpline.interpolate(outputSpline.interpolate(channel->maxValueAtPin.real));
+        double min = gearing*responseSpline.interpolate(outputSpline.interpolate(channel->minValueAtPin.real));
         if (min>max) {
             double temp = min;
             min = max;
@@ -1349,13 +1330,13 @@ bool Builder::emitNumericEffecterPdr(JsonObject *binding, JsonObject *entity)
         
         // determine which range values are supported
         unsigned char fieldSupport = 0;
-        if (effecter->getValue("ratedMax").compare("NULL")!=0) fieldSupport |= 0x08;
-        if (effecter->getValue("nominalValue").compare("NULL")!=0) fieldSupport |= 0x01;
+        if (effecter->ratedMax.text.compare("NULL")!=0) fieldSupport |= 0x08;
+        if (effecter->nominalValue.text.compare("NULL")!=0) fieldSupport |= 0x01;
         emitStructUint8(fieldSupport);         // range field support
-        emitStructReal32(effecter->getDouble("nominalValue")); // Nominal Value
+        emitStructReal32(effecter->nominalValue.real); // Nominal Value
         emitStructReal32(0.0);                 // Normal Max
         emitStructReal32(0.0);                 // Normal Min
-        emitStructReal32(effecter->getDouble("ratedMax"));     // Rated Max
+        emitStructReal32(effecter->ratedMax.real);     // Rated Max
         emitStructReal32(0.0);                 // Rated Min
     } else {
         // VIRTUAL EFFECTER
@@ -1393,70 +1374,73 @@ bool Builder::emitNumericEffecterPdr(JsonObject *binding, JsonObject *entity)
 // or the output effecter resolution (stepper mode)
 //
 // parameters:
-//   entity - a pointer to the json object for the entity to check
-//   bindings - a pointer to the I/O bindings for the entity
+//   entity - a pointer to the entity to check
 // returns:
 //   the position resolution to use, or 0 if the default resolution
 //   calcuation should be used.
-double Builder::getPositionResolution(JsonObject* entity, JsonArray* bindings) {
+double Builder::getPositionResolution(ConfigEntity* entity) {
     // determine if the entity is a profiled motion controller
-    if ((entity->find("entityVendorIANA")!=NULL) && 
-        (entity->find("entityVendorIANA")->getInteger("")==12634) &&
-        (entity->find("vendorEntityID")!=NULL) && 
-        (entity->find("vendorEntityID")->getInteger("")==3)) {
+    if ((entity->entityVendorIANA.present) && 
+        (entity->entityVendorIANA.integer==12634) &&
+        (entity->vendorEntityID.present) && 
+        (entity->vendorEntityID.integer==3)) {
         // attempt to find the binding for the feedback numeric sensor
         // (sensor ID 7).  If it is not virtual, use it to determine
         // the position resolution for the entity.
-        for (int i = 0;i<bindings->size(); i++) {
-            JsonObject* binding = (JsonObject*)(bindings->getElement(i));
-            if (binding->getValue("bindingType") == "numericSensor") {
-                // here if the binding is a numeric sensor - check to see
-                // if it is a real (non-virtual) position sensor
-                if ((!binding->getBoolean("isVirtual")) && (binding->getInteger("sensorID")==7)) {
-                    // use the resolution of the position sensor for the base resolution
-                    JsonArray *inputCurve = ((JsonArray*)binding->find("inputCurve"));
-                    JsonObject *sensor = ((JsonObject*)binding->find("sensor"));
-                    JsonArray *responseCurve = ((JsonArray*)sensor->find("responseCurve"));
-
-                    // create the interpolation curves
-                    CUCSpline inputSpline(true);
-                    configureSplineFromPoints(inputCurve, &inputSpline,true);
-                    CUCSpline responseSpline(true);
-                    configureSplineFromPoints(responseCurve, &responseSpline,true);
-
-                    // get the gearing ratio
-                    double gearing = binding->getDouble("inputGearingRatio");
-                    if (gearing == 0) gearing = 1.0;
-
-                    // return the base resolution
-                    return gearing*inputSpline.interpolate(responseSpline.interpolate(1.0));
-                }
-            } 
-        }
-
-        // attempt to find the binding for the output effecter
-        // Use it to determine the position resolution for the entity.
-        for (int i = 0;i<bindings->size(); i++) {
-            JsonObject* binding = (JsonObject*)(bindings->getElement(i));
-            if (binding->getValue("name") == "OutputEffecter") {
+        vector<ConfigBinding> &bindings = entity->ioBindings;
+        for (unsigned int i = 0;i<bindings.size(); i++) {
+            ConfigBinding* binding = &bindings[i];
+            if (binding->bindingType.text!="numericSensor") continue;
+            // here if the binding is a numeric sensor - check to see
+            // if it is a real (non-virtual) position sensor
+            if ((!binding->isVirtual.boolean) && (binding->sensorID.integer==7)) {
                 // use the resolution of the position sensor for the base resolution
-                JsonArray *outputCurve = ((JsonArray*)binding->find("outputCurve"));
-                JsonObject *effecter = ((JsonObject*)binding->find("effecter"));
-                JsonArray *responseCurve = ((JsonArray*)effecter->find("responseCurve"));
+                ConfigCurve *inputCurve = &binding->inputCurve;
+                ConfigTransducer *sensor = &binding->sensor;
+                ConfigCurve *responseCurve = &sensor->responseCurve;
 
                 // create the interpolation curves
-                CUCSpline outputSpline(true);
-                configureSplineFromPoints(outputCurve, &outputSpline,false);
+                CUCSpline inputSpline(true);
+                configureSplineFromPoints(inputCurve, &inputSpline,true);
                 CUCSpline responseSpline(true);
-                configureSplineFromPoints(responseCurve, &responseSpline,false);
+                configureSplineFromPoints(responseCurve, &responseSpline,true);
 
                 // get the gearing ratio
-                double gearing = binding->getDouble("inputGearingRatio");
+                double gearing = binding->inputGearingRatio.real;
                 if (gearing == 0) gearing = 1.0;
 
                 // return the base resolution
-                return gearing*outputSpline.interpolate(responseSpline.interpolate(1.0));
-            } 
+                return gearing*inputSpline.interpolate(responseSpline.interpolate(1.0));
+            }
+        }
+
+        // attempt to find the binding for the output effecter
+        // Use it to determine the position resolution for the entity.
+        ConfigBinding* binding = NULL;
+        for (unsigned int i = 0;i<bindings.size(); i++) {
+            if (bindings[i].name.text=="OutputEffecter") {
+                binding = &bindings[i];
+                break;
+            }
+        }
+        if (binding) {
+            // use the resolution of the position sensor for the base resolution
+            ConfigCurve *outputCurve = &binding->outputCurve;
+            ConfigTransducer *effecter = &binding->effecter;
+            ConfigCurve *responseCurve = &effecter->responseCurve;
+
+            // create the interpolation curves
+            CUCSpline outputSpline(true);
+            configureSplineFromPoints(outputCurve, &outputSpline,false);
+            CUCSpline responseSpline(true);
+            configureSplineFromPoints(responseCurve, &responseSpline,false);
+
+            // get the gearing ratio
+            double gearing = binding->inputGearingRatio.real;
+            if (gearing == 0) gearing = 1.0;
+
+            // return the base resolution
+            return gearing*outputSpline.interpolate(responseSpline.interpolate(1.0));
         }
     }
     // use the default resolution calculations.
@@ -1471,36 +1455,35 @@ double Builder::getPositionResolution(JsonObject* entity, JsonArray* bindings) {
 void Builder::emitSensorEffecterPdrs()
 {
     // get the logical Entity from the config file
-    JsonObject* cfg = (JsonObject*)(((JsonObject*)pdrjson)->find("configuration"));
-    JsonArray*  entities = (JsonArray*)(cfg->find("logicalEntities"));
+    vector<ConfigEntity> &entities = config.logicalEntities;
 
     // loop for each entity
-    for (unsigned int i = 0; i<entities->size(); i++) {
-        JsonObject* entity = (JsonObject*)(entities->getElement(i));
+    for (unsigned int i = 0; i<entities.size(); i++) {
+        ConfigEntity* entity = &entities[i];
 
         // get the I/O Bindings
-        JsonArray*  bindings = (JsonArray*)(entity->find("ioBindings"));
+        vector<ConfigBinding> &bindings = entity->ioBindings;
 
         // if this entity is a profiled motion controller, get the position
         // resolution - this will be determined by the position feedback
         // if the controller is closed-loop, otherwise, it will be determined
         // by the output effecter resolution (stepper mode)
-        positionResolution = getPositionResolution(entity, bindings);
+        positionResolution = getPositionResolution(entity);
 
         // loop for each binding
-        for (int j = 0;j<bindings->size(); j++) {
-            JsonObject* binding = (JsonObject*)(bindings->getElement(j));
+        for (unsigned long j = 0;j<bindings.size(); j++) {
+            ConfigBinding* binding = &bindings[j];
 
             // skip this binding if it does not get emitted to the PDR
-            if (!binding->getBoolean("includeInPdr")) continue;
+            if (!binding->includeInPdr.boolean) continue;
             // emit the particular PDR type
-            if (binding->getValue("bindingType").compare("stateSensor")==0) {
+            if (binding->bindingType.text.compare("stateSensor")==0) {
                 emitStateSensorPdr(binding,entity);
-            } else if (binding->getValue("bindingType").compare("numericSensor")==0) {
+            } else if (binding->bindingType.text.compare("numericSensor")==0) {
                 emitNumericSensorPdr(binding,entity);
-            } else if (binding->getValue("bindingType").compare("stateEffecter")==0) {
+            } else if (binding->bindingType.text.compare("stateEffecter")==0) {
                 emitStateEffecterPdr(binding,entity);
-            } else if (binding->getValue("bindingType").compare("numericEffecter")==0) {
+            } else if (binding->bindingType.text.compare("numericEffecter")==0) {
                 emitNumericEffecterPdr(binding,entity);
             } 
         }
@@ -1515,35 +1498,33 @@ void Builder::emitSensorEffecterPdrs()
 void Builder::emitLinearizationTables()
 {
     // get the logical Entity from the config file
-    JsonObject* cfg = (JsonObject*)(((JsonObject*)pdrjson)->find("configuration"));
-    JsonArray*  entities = (JsonArray*)(cfg->find("logicalEntities"));
+    vector<ConfigEntity> &entities = config.logicalEntities;
 
     // loop for each entity
-    for (unsigned int i = 0; i<entities->size(); i++) {
-        JsonObject* entity = (JsonObject*)(entities->getElement(i));
+    for (unsigned int i = 0; i<entities.size(); i++) {
+        ConfigEntity* entity = &entities[i];
 
         // get the I/O Bindings
-        JsonArray*  bindings = (JsonArray*)(entity->find("ioBindings"));
+        vector<ConfigBinding> &bindings = entity->ioBindings;
 
         // loop for each binding
-        for (int j = 0;j<bindings->size(); j++) {
-            JsonObject* binding = (JsonObject*)(bindings->getElement(j));
+        for (unsigned long j = 0;j<bindings.size(); j++) {
+            ConfigBinding* binding = &bindings[j];
             // skip this binding is virtual
-            if (binding->getBoolean("isVirtual")) continue;
+            if (binding->isVirtual.boolean) continue;
             // only worry about linearization for state effecters and sensors
-            if ((binding->getValue("bindingType")=="numericSensor")||
-                (binding->getValue("bindingType")=="numericEffecter")) {
+            if ((binding->bindingType.text=="numericSensor")||
+                (binding->bindingType.text=="numericEffecter")) {
                 
                 // find the channel in the channel list
-                JsonObject *cap = (JsonObject*)(((JsonObject*)pdrjson)->find("capabilities"));
-                JsonArray *channels = (JsonArray*)(cap->find("channels"));
-                JsonObject* channel = NULL;
-                for (int i = 0;i<channels->size();i++) {
-                    channel = (JsonObject *)channels->getElement(i);
-                    if (channel->getValue("name")==binding->getValue("boundChannel")) break;
+                vector<ConfigChannel> &channels = config.capabilities.channels;
+                ConfigChannel* channel = NULL;
+                for (unsigned long i = 0;i<channels.size();i++) {
+                    channel = &channels[i];
+                    if (channel->name.text==binding->boundChannel.text) break;
                 }
                 if (!channel) {
-                    cerr<<"Channel not found for IO Binding "<<binding->getValue("name")<<endl;
+                    cerr<<"Channel not found for IO Binding "<<binding->name.text<<endl;
                     return;
                 }
 
@@ -1551,35 +1532,35 @@ void Builder::emitLinearizationTables()
                 CUCSpline seSpline(true);
                 CUCSpline responseSpline(true);
                 double gearing;
-                if (binding->getValue("bindingType")=="numericEffecter") {
+                if (binding->bindingType.text=="numericEffecter") {
                     // get the output curve for the output stage
-                    JsonArray *outputCurve = ((JsonArray*)binding->find("outputCurve"));
-                    JsonObject *effecter = ((JsonObject*)binding->find("effecter"));
-                    JsonArray *responseCurve = ((JsonArray*)effecter->find("responseCurve"));
+                    ConfigCurve *outputCurve = &binding->outputCurve;
+                    ConfigTransducer *effecter = &binding->effecter;
+                    ConfigCurve *responseCurve = &effecter->responseCurve;
 
                     // create the interpolation curves
                     configureSplineFromPoints(outputCurve, &seSpline, false);
                     configureSplineFromPoints(responseCurve, &responseSpline,false);
 
                     // get the gearing ratio
-                    gearing = binding->getDouble("outputGearingRatio");
+                    gearing = binding->outputGearingRatio.real;
 
                 } else {
                     // get the input curve for the input stage
-                    JsonArray *inputCurve = ((JsonArray*)binding->find("inputCurve"));
-                    JsonObject *sensor = ((JsonObject*)binding->find("sensor"));
-                    JsonArray *responseCurve = ((JsonArray*)sensor->find("responseCurve"));
+                    ConfigCurve *inputCurve = &binding->inputCurve;
+                    ConfigTransducer *sensor = &binding->sensor;
+                    ConfigCurve *responseCurve = &sensor->responseCurve;
 
                     // create the interpolation curves
                     configureSplineFromPoints(inputCurve, &seSpline,true);
                     configureSplineFromPoints(responseCurve, &responseSpline,true);
                 
                     // get the gearing ratio
-                    gearing = binding->getDouble("inputGearingRatio");
+                    gearing = binding->inputGearingRatio.real;
                 }
 
                 // get the precision for the channel (in bits)
-                int precision = channel->getInteger("precision");
+                int precision = channel->precision.integer;
                 double maxRaw,minRaw;        
                 maxRaw = 1<<abs(precision);
                 minRaw = 0;
@@ -1588,26 +1569,26 @@ void Builder::emitLinearizationTables()
                     minRaw = -maxRaw;
                 }
 
-                double channelMin = channel->getDouble("minValue");
-                double channelMax = channel->getDouble("maxValue");
+                double channelMin = channel->minValue.real;
+                double channelMax = channel->maxValue.real;
                 if (channelMin== channelMax) {
                     channelMin = 0;
                     channelMax = 2.5;
                 }                
                 double channelStep = (channelMax-channelMin)/64;
 
-                JsonArray * parameters = (JsonArray*)(entity->find("parameters"));
+                vector<ConfigParameter> &parameters = entity->parameters;
                 double sampleRate = 4000;  // default sample rate
-                for (int i=0;i<parameters->size();i++) {
-                    JsonObject * param = (JsonObject*)(parameters->getElement(i));
-                    if (param->getValue("name").compare("SampleRate")==0) {
-                        sampleRate = param->getDouble("value");
+                for (unsigned long i=0;i<parameters.size();i++) {
+                    ConfigParameter * param = &parameters[i];
+                    if (param->name.text.compare("SampleRate")==0) {
+                        sampleRate = param->value.real;
                         break;
                     }
                 }
                 double resolution = BASE_RESOLUTION;
                 if (positionResolution) {
-                    switch(binding->getInteger("sensorID")) {
+                    switch(binding->sensorID.integer) {
                         case 4:  // verr
                         case 5:  // perr
                         case 6:  // velocity
@@ -1617,15 +1598,15 @@ void Builder::emitLinearizationTables()
                             resolution = positionResolution;
                     }
                 }
-                if (binding->getInteger("physicalBaseUnit") == 20) {
+                if (binding->physicalBaseUnit.integer == 20) {
                     // base units are hertz
                     resolution *= sampleRate;
                 }
-                resolution = scaleResolutionByRateUnit(resolution, binding->getInteger("physicalRateUnit"), sampleRate);
-                resolution = scaleResolutionByRateUnit(resolution, binding->getInteger("physicalAuxRateUnit"), sampleRate);
+                resolution = scaleResolutionByRateUnit(resolution, binding->physicalRateUnit.integer, sampleRate);
+                resolution = scaleResolutionByRateUnit(resolution, binding->physicalAuxRateUnit.integer, sampleRate);
 
                 // loop for each value in the output table;
-                cOutputFile<<"LINTABLE_TYPE __lintable_"<<channel->getValue("name")<<"[] LINTABLE_DATA_ATTRIBUTES = { "<<endl<<"   ";
+                cOutputFile<<"LINTABLE_TYPE __lintable_"<<channel->name.text<<"[] LINTABLE_DATA_ATTRIBUTES = { "<<endl<<"   ";
                 unsigned int wordsOnLine = 0;
                 for (double x=-2*channelStep+channelMin; x<=channelMax+2*channelStep; x+=channelStep) {
                     // calculate the table value
@@ -1682,7 +1663,7 @@ void Builder::emitHIntro()
 //
 // convert the input string to an all upper-case representation
 // and return the result;
-static string toUpper(string str) {
+static string toUpper(string_view str) {
     string result = "";
     for (unsigned int i = 0; i<str.size(); i++) {
         if (str[i]<=' ') continue; // ignore whitespace
@@ -1697,15 +1678,15 @@ static string toUpper(string str) {
 // calculate the default value for an effecter based on the resolution
 // and offset parameters of the binding.
 //
-double Builder::calcDefaultValue(JsonObject *binding, JsonObject *entity)
+double Builder::calcDefaultValue(ConfigBinding *binding, ConfigEntity *entity)
 {
     // get any required parameter values
-    JsonArray * parameters = (JsonArray*)(entity->find("parameters"));
+    vector<ConfigParameter> &parameters = entity->parameters;
     double sampleRate = 0;
-    for (int i=0;i<parameters->size();i++) {
-        JsonObject * param = (JsonObject*)(parameters->getElement(i));
-        if (param->getValue("name").compare("SampleRate")==0) {
-            sampleRate = param->getDouble("value");
+    for (unsigned long i=0;i<parameters.size();i++) {
+        ConfigParameter * param = &parameters[i];
+        if (param->name.text.compare("SampleRate")==0) {
+            sampleRate = param->value.real;
             break;
         }
     }
@@ -1713,7 +1694,7 @@ double Builder::calcDefaultValue(JsonObject *binding, JsonObject *entity)
     double resolution = BASE_RESOLUTION;
 
     if (positionResolution) {
-        switch(binding->getInteger("effecterID")) {
+        switch(binding->effecterID.integer) {
             case 4:  // pfinal effecter
                 resolution = positionResolution;
                 break;
@@ -1722,16 +1703,16 @@ double Builder::calcDefaultValue(JsonObject *binding, JsonObject *entity)
                 resolution *= positionResolution;
         }
     }
-    if (binding->getInteger("physicalBaseUnit") == 20) {
+    if (binding->physicalBaseUnit.integer == 20) {
         // base units are hertz
         resolution *= sampleRate;
     }
-    resolution = scaleResolutionByRateUnit(resolution, binding->getInteger("physicalRateUnit"), sampleRate);
-    resolution = scaleResolutionByRateUnit(resolution, binding->getInteger("physicalAuxRateUnit"), sampleRate);
+    resolution = scaleResolutionByRateUnit(resolution, binding->physicalRateUnit.integer, sampleRate);
+    resolution = scaleResolutionByRateUnit(resolution, binding->physicalAuxRateUnit.integer, sampleRate);
 
     double defaultVal = 0;
-    if (binding->find("defaultValue")) {
-        defaultVal = binding->getDouble("defaultValue");
+    if (binding->defaultValue.present) {
+        defaultVal = binding->defaultValue.real;
         defaultVal = ((defaultVal - OFFSET_VALUE)/resolution);
     }
     return defaultVal;
@@ -1747,13 +1728,12 @@ double Builder::calcDefaultValue(JsonObject *binding, JsonObject *entity)
 //
 void Builder::emitMacros()
 {
-    JsonObject *cfg     = (JsonObject*)(((JsonObject*)pdrjson)->find("configuration"));
-    JsonObject *cap     = (JsonObject*)(((JsonObject*)pdrjson)->find("capabilities"));
-    JsonArray *entities = (JsonArray*)cfg->find("logicalEntities");
+    ConfigCapabilities *cap = &config.capabilities;
+    vector<ConfigEntity> &entities = config.logicalEntities;
 
     hOutputFile<<"//===================="<<endl;
     hOutputFile<<"// Module-Related Macros"<<endl;
-    if (!cap->getValue("device").empty()) hOutputFile<<"#define "<<toUpper(cap->getValue("device"))<<endl;
+    if (!cap->device.text.empty()) hOutputFile<<"#define "<<toUpper(cap->device.text)<<endl;
     hOutputFile<<endl;
 
     hOutputFile<<"//===================="<<endl;
@@ -1776,116 +1756,116 @@ void Builder::emitMacros()
 
     hOutputFile<<"//===================="<<endl;
     hOutputFile<<"// Channel-Related Macros"<<endl;
-    for (int i=0;i<entities->size();i++) {
-        JsonObject *entity = (JsonObject*)entities->getElement(i);
-        JsonArray *bindings = (JsonArray*)entity->find("ioBindings");
-        for (int j=0;j<bindings->size();j++) {
-            JsonObject *binding = (JsonObject*)bindings->getElement(j);
-            if ((binding->find("boundChannel")!=NULL)&&(binding->getValue("boundChannel")!="NULL")) 
-                hOutputFile<<"#define CHANNEL_"<<toUpper(binding->getValue("boundChannel"))<<endl;
+    for (unsigned long i=0;i<entities.size();i++) {
+        ConfigEntity *entity = &entities[i];
+        vector<ConfigBinding> &bindings = entity->ioBindings;
+        for (unsigned long j=0;j<bindings.size();j++) {
+            ConfigBinding *binding = &bindings[j];
+            if (binding->boundChannel.isSet()) 
+                hOutputFile<<"#define CHANNEL_"<<toUpper(binding->boundChannel.text)<<endl;
         }
     }
     hOutputFile<<endl;
 
     hOutputFile<<"//===================="<<endl;
     hOutputFile<<"// Logical Entity-Related Macros"<<endl;
-    for (int i=0;i<entities->size();i++) {
-        JsonObject *entity = (JsonObject*)entities->getElement(i);
-        string entityRef = string("ENTITY_")+toUpper(entity->getValue("name"));
+    for (unsigned long i=0;i<entities.size();i++) {
+        ConfigEntity *entity = &entities[i];
+        string entityRef = string("ENTITY_")+toUpper(entity->name.text);
         hOutputFile<<"#define "<<entityRef<<endl;
 
-        JsonArray *bindings = (JsonArray*)entity->find("ioBindings");
-        positionResolution = getPositionResolution(entity, bindings);
-        for (int j=0;j<bindings->size();j++) {
-            JsonObject *binding = (JsonObject*)bindings->getElement(j);
-            string bindingName = entityRef + "_" + toUpper(binding->getValue("name")); 
+        vector<ConfigBinding> &bindings = entity->ioBindings;
+        positionResolution = getPositionResolution(entity);
+        for (unsigned long j=0;j<bindings.size();j++) {
+            ConfigBinding *binding = &bindings[j];
+            string bindingName = entityRef + "_" + toUpper(binding->name.text); 
             hOutputFile<<"#define "<<bindingName<<endl;
-            if ((binding->find("bindingType")!=NULL)&&(binding->getValue("bindingType")!="NULL")) {
-                string bindingType = binding->getValue("bindingType");
+            if (binding->bindingType.isSet()) {
+                string_view bindingType = binding->bindingType.text;
                 hOutputFile<<"#define "<<bindingName+"_BINDINGTYPE_"+toUpper(bindingType)<<endl;
-                if (((bindingType == "numericSensor")||(bindingType == "numericEffecter"))&&(binding->getValue("boundChannel")!="NULL")) {
+                if (((bindingType == "numericSensor")||(bindingType == "numericEffecter"))&&(binding->boundChannel.text!="NULL")) {
                     // find the channel in the channel list
-                    JsonArray *channels = (JsonArray*)(cap->find("channels"));
-                    JsonObject* channel = NULL;
-                    for (int cnum = 0;cnum<channels->size();cnum++) {
-                        channel = (JsonObject *)channels->getElement(cnum);
-                        if (channel->getValue("name")==binding->getValue("boundChannel")) break;
+                    vector<ConfigChannel> &channels = config.capabilities.channels;
+                    ConfigChannel* channel = NULL;
+                    for (unsigned long cnum = 0;cnum<channels.size();cnum++) {
+                        channel = &channels[cnum];
+                        if (channel->name.text==binding->boundChannel.text) break;
                     }
                     if (!channel) {
-                        cerr<<"Channel not found for IO Binding "<<binding->getValue("name")<<endl;
+                        cerr<<"Channel not found for IO Binding "<<binding->name.text<<endl;
                         return;
                     }
-                    hOutputFile<<"extern LINTABLE_TYPE __lintable_"<<channel->getValue("name")<<"[] LINTABLE_DATA_ATTRIBUTES;"<<endl;
-                    hOutputFile<<"#define "<<bindingName+"_BOUNDCHANNEL_PRECISION "<<toUpper(channel->getValue("precision"))<<endl;
+                    hOutputFile<<"extern LINTABLE_TYPE __lintable_"<<channel->name.text<<"[] LINTABLE_DATA_ATTRIBUTES;"<<endl;
+                    hOutputFile<<"#define "<<bindingName+"_BOUNDCHANNEL_PRECISION "<<toUpper(channel->precision.text)<<endl;
                 }
             }
-            if ((binding->find("sensorID")!=NULL)&&(binding->getValue("sensorID")!="NULL")) 
-                hOutputFile<<"#define "<<bindingName+"_SENSORID "<<toUpper(binding->getValue("sensorID"))<<endl;
-            if ((binding->find("effecterID")!=NULL)&&(binding->getValue("effecterID")!="NULL")) 
-                hOutputFile<<"#define "<<bindingName+"_EFFECTERID "<<toUpper(binding->getValue("effecterID"))<<endl;
-            if ((binding->find("boundChannel")!=NULL)&&(binding->getValue("boundChannel")!="NULL")) 
-                hOutputFile<<"#define "<<bindingName+"_BOUNDCHANNEL "<<binding->getValue("boundChannel")<<endl;
-            if ((binding->find("usedStates")!=NULL)&&(binding->getValue("usedStates")!="NULL")) 
-                hOutputFile<<"#define "<<bindingName+"_USEDSTATES "<<toUpper(binding->getValue("usedStates"))<<endl;
-            if ((binding->find("stateWhenHigh")!=NULL)&&(binding->getValue("stateWhenHigh")!="NULL")) 
-                hOutputFile<<"#define "<<bindingName+"_STATEWHENHIGH "<<toUpper(binding->getValue("stateWhenHigh"))<<endl;
-            if ((binding->find("stateWhenLow")!=NULL)&&(binding->getValue("stateWhenLow")!="NULL")) 
-                hOutputFile<<"#define "<<bindingName+"_STATEWHENLOW "<<toUpper(binding->getValue("stateWhenLow"))<<endl;
-            if ((binding->find("defaultState")!=NULL)&&(binding->getValue("defaultState")!="NULL")) 
-                hOutputFile<<"#define "<<bindingName+"_DEFAULTSTATE "<<toUpper(binding->getValue("defaultState"))<<endl;
-            if (binding->getValue("bindingType") == "numericSensor") {
+            if (binding->sensorID.isSet()) 
+                hOutputFile<<"#define "<<bindingName+"_SENSORID "<<toUpper(binding->sensorID.text)<<endl;
+            if (binding->effecterID.isSet()) 
+                hOutputFile<<"#define "<<bindingName+"_EFFECTERID "<<toUpper(binding->effecterID.text)<<endl;
+            if (binding->boundChannel.isSet()) 
+                hOutputFile<<"#define "<<bindingName+"_BOUNDCHANNEL "<<binding->boundChannel.text<<endl;
+            if (binding->usedStates.isSet()) 
+                hOutputFile<<"#define "<<bindingName+"_USEDSTATES "<<toUpper(binding->usedStates.text)<<endl;
+            if (binding->stateWhenHigh.isSet()) 
+                hOutputFile<<"#define "<<bindingName+"_STATEWHENHIGH "<<toUpper(binding->stateWhenHigh.text)<<endl;
+            if (binding->stateWhenLow.isSet()) 
+                hOutputFile<<"#define "<<bindingName+"_STATEWHENLOW "<<toUpper(binding->stateWhenLow.text)<<endl;
+            if (binding->defaultState.isSet()) 
+                hOutputFile<<"#define "<<bindingName+"_DEFAULTSTATE "<<toUpper(binding->defaultState.text)<<endl;
+            if (binding->bindingType.text == "numericSensor") {
                 unsigned char enabledThresholds = 0;                
-                if ((binding->find("normalMin")!=NULL)&&(binding->getValue("normalMin")!="NULL")) {
-                    hOutputFile<<"#define "<<bindingName+"_NORMALMIN "<<toUpper(binding->getValue("normalMin"))<<endl;
+                if (binding->normalMin.isSet()) {
+                    hOutputFile<<"#define "<<bindingName+"_NORMALMIN "<<toUpper(binding->normalMin.text)<<endl;
                     enabledThresholds |= 0x4;
                 } else hOutputFile<<"#define "<<bindingName+"_NORMALMIN "<<0<<endl;
-                if ((binding->find("normalMax")!=NULL)&&(binding->getValue("normalMax")!="NULL")) {
-                    hOutputFile<<"#define "<<bindingName+"_NORMALMAX "<<toUpper(binding->getValue("normalMax"))<<endl;
+                if (binding->normalMax.isSet()) {
+                    hOutputFile<<"#define "<<bindingName+"_NORMALMAX "<<toUpper(binding->normalMax.text)<<endl;
                     enabledThresholds |= 0x2;
                 } else hOutputFile<<"#define "<<bindingName+"_NORMALMAX "<<0<<endl;
-                if ((binding->find("upperThresholdWarning")!=NULL)&&(binding->getValue("upperThresholdWarning")!="NULL")) {
-                    hOutputFile<<"#define "<<bindingName+"_UPPERTHRESHOLDWARNING "<<toUpper(binding->getValue("upperThresholdWarning"))<<endl;
+                if (binding->upperThresholdWarning.isSet()) {
+                    hOutputFile<<"#define "<<bindingName+"_UPPERTHRESHOLDWARNING "<<toUpper(binding->upperThresholdWarning.text)<<endl;
                 } else hOutputFile<<"#define "<<bindingName+"_UPPERTHRESHOLDWARNING "<<0<<endl;
-                if ((binding->find("upperThresholdCritical")!=NULL)&&(binding->getValue("upperThresholdCritical")!="NULL")) {
-                    hOutputFile<<"#define "<<bindingName+"_UPPERTHRESHOLDCRITICAL "<<toUpper(binding->getValue("upperThresholdCritical"))<<endl;
+                if (binding->upperThresholdCritical.isSet()) {
+                    hOutputFile<<"#define "<<bindingName+"_UPPERTHRESHOLDCRITICAL "<<toUpper(binding->upperThresholdCritical.text)<<endl;
                     enabledThresholds |= 0x8;            
                 } else hOutputFile<<"#define "<<bindingName+"_UPPERTHRESHOLDCRITICAL "<<0<<endl;
-                if ((binding->find("upperThresholdFatal")!=NULL)&&(binding->getValue("upperThresholdFatal")!="NULL")) { 
-                    hOutputFile<<"#define "<<bindingName+"_UPPERTHRESHOLDFATAL "<<toUpper(binding->getValue("upperThresholdFatal"))<<endl;
+                if (binding->upperThresholdFatal.isSet()) { 
+                    hOutputFile<<"#define "<<bindingName+"_UPPERTHRESHOLDFATAL "<<toUpper(binding->upperThresholdFatal.text)<<endl;
                     enabledThresholds |= 0x20;
                 } else hOutputFile<<"#define "<<bindingName+"_UPPERTHRESHOLDFATAL "<<0<<endl;
-                if ((binding->find("lowerThresholdWarning")!=NULL)&&(binding->getValue("lowerThresholdWarning")!="NULL")) {
-                    hOutputFile<<"#define "<<bindingName+"_LOWERTHRESHOLDWARNING "<<toUpper(binding->getValue("lowerThresholdWarning"))<<endl;
+                if (binding->lowerThresholdWarning.isSet()) {
+                    hOutputFile<<"#define "<<bindingName+"_LOWERTHRESHOLDWARNING "<<toUpper(binding->lowerThresholdWarning.text)<<endl;
                 } else hOutputFile<<"#define "<<bindingName+"_LOWERTHRESHOLDWARNING "<<0<<endl;
-                if ((binding->find("lowerThresholdCritical")!=NULL)&&(binding->getValue("lowerThresholdCritical")!="NULL")) { 
-                    hOutputFile<<"#define "<<bindingName+"_LOWERTHRESHOLDCRITICAL "<<toUpper(binding->getValue("lowerThresholdCritical"))<<endl;
+                if (binding->lowerThresholdCritical.isSet()) { 
+                    hOutputFile<<"#define "<<bindingName+"_LOWERTHRESHOLDCRITICAL "<<toUpper(binding->lowerThresholdCritical.text)<<endl;
                     enabledThresholds |= 0x20;
                 } else hOutputFile<<"#define "<<bindingName+"_LOWERTHRESHOLDCRITICAL "<<0<<endl;
-                if ((binding->find("lowerThresholdFatal")!=NULL)&&(binding->getValue("lowerThresholdFatal")!="NULL")) {
-                    hOutputFile<<"#define "<<bindingName+"_LOWERTHRESHOLDFATAL "<<toUpper(binding->getValue("lowerThresholdFatal"))<<endl;
+                if (binding->lowerThresholdFatal.isSet()) {
+                    hOutputFile<<"#define "<<bindingName+"_LOWERTHRESHOLDFATAL "<<toUpper(binding->lowerThresholdFatal.text)<<endl;
                     enabledThresholds |= 0x40;
                 } else hOutputFile<<"#define "<<bindingName+"_LOWERTHRESHOLDFATAL "<<0<<endl;
-                if (binding->getValue("bindingType") == "numericSensor")
+                if (binding->bindingType.text == "numericSensor")
                     hOutputFile<<"#define "<<bindingName+"_ENABLEDTHRESHOLDS "<<(unsigned int)enabledThresholds<<endl;
             }
-            if (binding->getValue("bindingType") == "numericEffecter") {
-                if (binding->find("defaultValue")) {
+            if (binding->bindingType.text == "numericEffecter") {
+                if (binding->defaultValue.present) {
                     // convert the default value using the resolution/offset for the effecter
                     hOutputFile<<"#define "<<bindingName+"_DEFAULTVALUE "<<(unsigned long)calcDefaultValue(binding,entity)<<endl;
                 }
             }
         }
 
-        JsonArray *parameters = (JsonArray*)entity->find("parameters");
-        for (int j=0;j<parameters->size();j++) {
-            JsonObject *parameter = (JsonObject*)parameters->getElement(j);
-            string paramName = entityRef + "_PARAM_" + toUpper(parameter->getValue("name")); 
-            if (parameter->getValue("type").compare("enum")==0) {
+        vector<ConfigParameter> &parameters = entity->parameters;
+        for (unsigned long j=0;j<parameters.size();j++) {
+            ConfigParameter * parameter = &parameters[j];
+            string paramName = entityRef + "_PARAM_" + toUpper(parameter->name.text); 
+            if (parameter->type.text.compare("enum")==0) {
                 // this is an enumerated typue - just define the macro name
-                hOutputFile<<"#define "<<paramName+"_"+toUpper(parameter->getValue("value"))<<endl;
+                hOutputFile<<"#define "<<paramName+"_"+toUpper(parameter->value.text)<<endl;
             } else {
                 // update the name and the value
-                hOutputFile<<"#define "<<paramName<<" "<<toUpper(parameter->getValue("value"))<<endl;
+                hOutputFile<<"#define "<<paramName<<" "<<toUpper(parameter->value.text)<<endl;
             }
         }
     }
@@ -1903,16 +1883,158 @@ void Builder::emitMacros()
 // This program returns true if successful, otherwise false.
 //
 bool Builder::build(string inputFilename, string outputPath) {
-    oemStateSetMap.clear();
+    return build(inputFilename, "", outputPath);
+}
+
+//*******************************************************************
+// build()
+//
+// create the build files from the config file given as the first 
+// parameter after applying the JSON Patch (RFC 6902) file given as
+// the second parameter, and place the resulting files in the folder
+// specified by the third parameter.  The patch is applied to the
+// loaded structure in place, so the config file is not rewritten or
+// parsed again.  If the patch filename is empty, no patch is applied.
+//
+// This program returns true if successful, otherwise false.
+//
+bool Builder::build(string inputFilename, string patchFilename, string outputPath) {
+    //========================
+    // Open the config Json File (releasing any previously loaded file
+    // before its memory is reused)
+    jsonArena.reset();
+    if (!jsonFile.open(inputFilename)) {
+        cerr << "error opening file" << endl;
+        cerr << "Invalid input Json file " <<inputFilename<< endl;
+        return false;
+    }
+
+    //========================
+    // Read a config that is not patched straight into the config model,
+    // without building a json structure for it
+    if ((patchFilename.empty()) && (!JsonSnapshot::isSnapshot(jsonFile.view()))) {
+        if (!config.parse(jsonFile.view())) {
+            cerr << "Invalid input Json file " <<inputFilename<< endl;
+            return false;
+        }
+        return generate(outputPath);
+    }
 
     //========================
-    // Read the config Json File
-    pdrjson = loadJsonFile(inputFilename);
+    // Build the json structure for the config
+    JsonAbstractValue *pdrjson = buildJsonFile(jsonFile, jsonArena);
     if ((!pdrjson)||(typeid(*pdrjson) != typeid(JsonObject))) {
         cerr << "Invalid input Json file " <<inputFilename<< endl;
         return false;
     }
 
+    //========================
+    // Apply the patch to the config
+    if (!patchFilename.empty()) {
+        JsonAbstractValue *patch = loadJsonFile(patchFilename, patchFile, jsonArena);
+        if ((!patch)||(!JsonPatch::apply(pdrjson, patch))) {
+            cerr << "Unable to apply patch file " <<patchFilename<< endl;
+            return false;
+        }
+        if (typeid(*pdrjson) != typeid(JsonObject)) {
+            cerr << "Patched Json is not an object" << endl;
+            return false;
+        }
+    }
+
+    //========================
+    // Read the config into the config model
+    if (!config.load(pdrjson)) {
+        cerr << "Invalid input Json file " <<inputFilename<< endl;
+        return false;
+    }
+    return generate(outputPath);
+}
+
+//*******************************************************************
+// saveSnapshot()
+//
+// save the config file given as the first parameter as a json snapshot
+// in the file given as the second parameter.  The snapshot can then be
+// given to build() in place of the config file, which restores the
+// structure without parsing it.  The config is checked by reading it
+// into the config model before the snapshot is written.
+//
+// This program returns true if successful, otherwise false.
+//
+bool Builder::saveSnapshot(string inputFilename, string snapshotFilename) {
+    jsonArena.reset();
+    JsonAbstractValue *pdrjson = loadJsonFile(inputFilename, jsonFile, jsonArena);
+    if ((!pdrjson)||(typeid(*pdrjson) != typeid(JsonObject))||(!config.load(pdrjson))) {
+        cerr << "Invalid input Json file " <<inputFilename<< endl;
+        return false;
+    }
+    JsonSnapshot snapshot;
+    if (!snapshot.save(pdrjson, snapshotFilename)) {
+        cerr << "Unable to write snapshot file " <<snapshotFilename<< endl;
+        return false;
+    }
+    return true;
+}
+
+//*******************************************************************
+// buildStream()
+//
+// create the build files for each config document within a stream of
+// newline-delimited (NDJSON) json documents, each on its own line.  A
+// line that is not a valid document fails only that document.  The 
+// files for each document are placed in a numbered folder (1, 2, ...)
+// created within the folder specified by the second parameter.  The
+// documents are read one at a time and share the json arena, so only
+// one document is held in memory at once.
+//
+// This program returns true if every document was built, otherwise false.
+//
+bool Builder::buildStream(istream &in, string outputPath) {
+    JsonFactory jf;
+    bool result = true;
+    unsigned long count = 0;
+    jf.setDelimited(true);
+    jf.open(in);
+    while (!jf.atEnd()) {
+        count++;
+        jsonArena.reset();
+        JsonAbstractValue *pdrjson = jf.next(jsonArena);
+        if ((!pdrjson)||(typeid(*pdrjson) != typeid(JsonObject))||(!config.load(pdrjson))) {
+            cerr << "Invalid json document " << count << endl;
+            result = false;
+            continue;
+        }
+        string documentPath = outputPath + to_string(count) + "/";
+        error_code ec;
+        filesystem::create_directories(documentPath, ec);
+        if (!generate(documentPath)) result = false;
+    }
+    jf.close();
+    return result;
+}
+
+//*******************************************************************
+// generate()
+//
+// create the build files from the config model that has been
+// loaded and place the resulting files in the folder specified by the
+// parameter.  Any state left by a previous build is reset first.
+//
+// This program returns true if successful, otherwise false.
+//
+bool Builder::generate(string outputPath) {
+    oemStateSetMap.clear();
+    bytesOnLine = 0;
+    pdrByteCount = 0;
+    pdrRecordCount = 0;
+    largestPdrRecordSize = 0;
+    totalPdrSize = 0;
+    fruRecordCount = 0;
+    largestFruRecordSize = 0;
+    totalFruSize = 0;
+    maxAllowedFruSize = 0;
+
     //========================
     // open the output files
     string cfilepath = outputPath;
@@ -1927,6 +2049,7 @@ bool Builder::build(string inputFilename, string outputPath) {
     hOutputFile.open(hfilepath);
     if (!hOutputFile.is_open()) {
         cerr << "error opening output file " << hfilepath << endl;
+        cOutputFile.close();
         return false;
     }
 
@@ -1935,8 +2058,6 @@ bool Builder::build(string inputFilename, string outputPath) {
     emitCIntro();
     startPdr();
     emitTerminusLocatorPdr();
-    JsonObject* cfgObj = (JsonObject*)(((JsonObject*)pdrjson)->find("configuration"));
-    JsonArray* fruRecords = (JsonArray*)(cfgObj->find("fruRecords"));
     // for these devices, all records are part of the a single FRU Record Set
     emitFruRecordSetPdr(1);
 
@@ -35,6 +35,8 @@
 #include <map>
 #include "CSpline.hpp"
 #include "JsonFactory.h"
+#include "JsonMappedFile.h"
+#include "ConfigModel.h"
 
 using namespace std;
 
@@ -42,7 +44,10 @@ class Builder {
     private:
         ofstream cOutputFile;
         ofstream hOutputFile;
-        JsonAbstractValue *pdrjson;
+        JsonMappedFile jsonFile;
+        JsonMappedFile patchFile;
+        JsonArena jsonArena;
+        ConfigModel config;
         double       positionResolution;
         unsigned int bytesOnLine;
         unsigned int pdrByteCount;
@@ -64,8 +69,8 @@ class Builder {
         void emitStructSint32(signed long, bool isFru = false);
         void emitStructReal32(float, bool isFru = false);
         void emitStructReal64(double, bool isFru = false);
-        void emitStructStrAscii(string, bool isFru = false);
-        void emitStructStrUtf16be(string, bool isFru = false);
+        void emitStructStrAscii(string_view, bool isFru = false);
+        void emitStructStrUtf16be(string_view, bool isFru = false);
         
         void emitCIntro();
         void startPdr();
@@ -77,26 +82,30 @@ class Builder {
         void emitOemEntityIdPdr();
         void emitOemStateSetPdrs();
         void emitSensorEffecterPdrs();
-        bool emitStateSensorPdr(JsonObject *binding, JsonObject *entity);
-        bool emitNumericSensorPdr(JsonObject *binding, JsonObject *entity);
-        bool emitStateEffecterPdr(JsonObject *binding, JsonObject *entity);
-        bool emitNumericEffecterPdr(JsonObject *binding, JsonObject *entity);
-        double calcDefaultValue(JsonObject *binding, JsonObject *entity);
+        bool emitStateSensorPdr(ConfigBinding *binding, ConfigEntity *entity);
+        bool emitNumericSensorPdr(ConfigBinding *binding, ConfigEntity *entity);
+        bool emitStateEffecterPdr(ConfigBinding *binding, ConfigEntity *entity);
+        bool emitNumericEffecterPdr(ConfigBinding *binding, ConfigEntity *entity);
+        double calcDefaultValue(ConfigBinding *binding, ConfigEntity *entity);
         void emitLinearizationTables();
         void emitFruRecords();
-        void emitThresholdToPdr(JsonObject * binding, string thresholdName);
-        unsigned char getFieldSupport(JsonObject * binding);
+        void emitThresholdToPdr(ConfigValue *threshold);
+        unsigned char getFieldSupport(ConfigBinding * binding);
 
         void emitHIntro();
         void emitMacros();
 
-        void configureSplineFromPoints(JsonArray* points, CUCSpline *spline, bool reverse);
-        void calcPlusMinusTolerance(double*, double* , JsonObject*, JsonObject*, CUCSpline*, CUCSpline*);
-        double getPositionResolution(JsonObject* entity, JsonArray* bindings);
+        void configureSplineFromPoints(ConfigCurve* points, CUCSpline *spline, bool reverse);
+        void calcPlusMinusTolerance(double*, double* , ConfigChannel*, ConfigBinding*, CUCSpline*, CUCSpline*);
+        double getPositionResolution(ConfigEntity* entity);
+        bool generate(string outputPath);
     public:
         Builder();
         ~Builder();
         bool build(string inputFilename, string outputPath);
+        bool build(string inputFilename, string patchFilename, string outputPath);
+        bool buildStream(istream &in, string outputPath);
+        bool saveSnapshot(string inputFilename, string snapshotFilename);
 
 
 };
\ No newline at end of file
@@ -44,15 +44,40 @@ using namespace std;
 //
 // main program entry point.  This program takes two arguments:
 // the full path to the json file to convert, and the path to write 
-// to the output files to.  
+// to the output files to.  With the --ndjson option, the input holds
+// a sequence of newline-delimited json configurations (or is read from
+// standard input if it is "-"), and the output files for each are 
+// written to a numbered folder within the output path.  With the
+// --patch option, the json patch file is applied to the config before
+// the output files are built.  With the --save-snapshot option, the
+// config is saved as a json snapshot that can be given in place of the
+// config file to build it without parsing.
 //
 // This program returns non-zero if an error is encountered.
 //
 int main(int argc, char *argv[]) {
     Builder builder;
+    if ((argc == 4) && (string(argv[1]) == "--ndjson")) {
+        if (string(argv[2]) == "-") return builder.buildStream(cin, argv[3])?0:1;
+        ifstream in(argv[2], ios::binary);
+        if (!in.is_open()) {
+            cerr << "error opening file " << argv[2] << endl;
+            return 1;
+        }
+        return builder.buildStream(in, argv[3])?0:1;
+    }
+    if ((argc == 5) && (string(argv[1]) == "--patch")) {
+        return builder.build(argv[3],argv[2],argv[4])?0:1;
+    }
+    if ((argc == 4) && (string(argv[1]) == "--save-snapshot")) {
+        return builder.saveSnapshot(argv[2],argv[3])?0:1;
+    }
     if (argc != 3) {
         cerr << "Wrong number of arguments.  Syntax: " << endl;
         cerr << "   builder infile.json outfile.c" << endl;
+        cerr << "   builder --ndjson infile.ndjson outpath" << endl;
+        cerr << "   builder --patch patch.json infile.json outpath" << endl;
+        cerr << "   builder --save-snapshot infile.json outfile.snapshot" << endl;
         return -1;
     }
 